@@ -0,0 +1,159 @@
+// Micro-benchmark da varredura de cabeçalhos: compara o laço byte a byte
+// anterior com os núcleos escalar, SSE4.2 e AVX2 em requisições reais de navegadores.
+//
+// Compilar com -DNERO_HTTP_BENCHMARKS=ON e executar: ./bench_header_scan [iterações]
+#include <nero_http.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- Requisições capturadas de navegadores e ferramentas comuns ---
+static const char *samples[] = {
+    // Chrome, navegação de página
+    "GET /sub/index.html?lang=pt-BR HTTP/1.1\r\n"
+    "Host: localhost:9000\r\n"
+    "Connection: keep-alive\r\n"
+    "sec-ch-ua: \"Chromium\";v=\"128\", \"Not;A=Brand\";v=\"24\", \"Google Chrome\";v=\"128\"\r\n"
+    "sec-ch-ua-mobile: ?0\r\n"
+    "sec-ch-ua-platform: \"Linux\"\r\n"
+    "Upgrade-Insecure-Requests: 1\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/128.0.0.0 Safari/537.36\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,image/apng,*/*;q=0.8,application/signed-exchange;v=b3;q=0.7\r\n"
+    "Sec-Fetch-Site: none\r\n"
+    "Sec-Fetch-Mode: navigate\r\n"
+    "Sec-Fetch-User: ?1\r\n"
+    "Sec-Fetch-Dest: document\r\n"
+    "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+    "Accept-Language: pt-BR,pt;q=0.9,en-US;q=0.8,en;q=0.7\r\n"
+    "\r\n",
+
+    // Firefox, subrecurso com cookies de sessão e análise
+    "GET /assets/app.3f9a1c.css HTTP/1.1\r\n"
+    "Host: localhost:9000\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:130.0) Gecko/20100101 Firefox/130.0\r\n"
+    "Accept: text/css,*/*;q=0.1\r\n"
+    "Accept-Language: pt-BR,pt;q=0.8,en-US;q=0.5,en;q=0.3\r\n"
+    "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+    "Referer: https://localhost:9000/sub/index.html\r\n"
+    "Connection: keep-alive\r\n"
+    "Cookie: session=8c1f2e7b9a0d4c3e8f6a5b4c3d2e1f0a; _ga=GA1.1.1234567890.1700000000; "
+    "_ga_ABCDEF1234=GS1.1.1700000000.1.1.1700000100.0.0.0; theme=dark; consent=analytics%3Dtrue%26ads%3Dfalse\r\n"
+    "Sec-Fetch-Dest: style\r\n"
+    "Sec-Fetch-Mode: no-cors\r\n"
+    "Sec-Fetch-Site: same-origin\r\n"
+    "If-Modified-Since: Tue, 01 Oct 2024 12:00:00 GMT\r\n"
+    "If-None-Match: \"5f2712111f3c1cf91f18df3de79a58e2\"\r\n"
+    "Priority: u=2\r\n"
+    "\r\n",
+
+    // curl
+    "GET /sub/big.bin HTTP/1.1\r\n"
+    "Host: localhost:9000\r\n"
+    "User-Agent: curl/8.5.0\r\n"
+    "Accept: */*\r\n"
+    "Range: bytes=100-199\r\n"
+    "\r\n",
+};
+
+#define SAMPLE_COUNT (sizeof(samples) / sizeof(samples[0]))
+
+// --- Laço anterior: máquina de estados byte a byte seguida de strchr/strstr por campo ---
+static size_t legacy_scan(const char *buffer, size_t length)
+{
+    bool slash_r = false;
+    int count = 0;
+    size_t i = 0;
+
+    for (; i < length && count < 2; i++)
+    {
+        if (buffer[i] == '\r')
+            slash_r = true;
+        else if (buffer[i] == '\n' && slash_r)
+        {
+            slash_r = false;
+            count++;
+        }
+        else
+        {
+            slash_r = false;
+            count = 0;
+        }
+    }
+
+    size_t fields = 0;
+    const char *line = strstr(buffer, "\r\n");
+    while (line)
+    {
+        line += 2;
+        const char *colon = strchr(line, ':');
+        const char *next = strstr(line, "\r\n");
+        if (!colon || !next || colon > next)
+            break;
+        fields++;
+        line = next;
+    }
+    return i + fields;
+}
+
+// --- Núcleo ativo: terminador e divisão de campos pelo parser do servidor ---
+static size_t kernel_scan(char *buffer, size_t length)
+{
+    const char *end = HTTP_Scan_HeaderEnd(buffer, buffer + length);
+    HTTP_Header header;
+    if (!end || !HTTP_Header_Parse(&header, buffer, (size_t)(end - buffer)))
+        return 0;
+    return (size_t)(end - buffer) + header.count;
+}
+
+int main(int argc, char **argv)
+{
+    long iterations = argc > 1 ? atol(argv[1]) : 200000;
+    size_t lengths[SAMPLE_COUNT];
+    char *copies[SAMPLE_COUNT];
+    size_t total_bytes = 0;
+
+    for (size_t i = 0; i < SAMPLE_COUNT; i++)
+    {
+        lengths[i] = strlen(samples[i]);
+        copies[i] = malloc(lengths[i] + 1);
+        if (!copies[i])
+            return 1;
+        total_bytes += lengths[i];
+    }
+
+    volatile size_t sink = 0;
+    uint64_t started = HTTP_Now();
+    for (long n = 0; n < iterations; n++)
+    {
+        for (size_t i = 0; i < SAMPLE_COUNT; i++)
+            sink += legacy_scan(samples[i], lengths[i]);
+    }
+    uint64_t elapsed = HTTP_Now() - started;
+    printf("%-8s %8.1f ns/requisição %8.2f GB/s\n", "legado",
+           (double)elapsed / (double)(iterations * (long)SAMPLE_COUNT),
+           (double)total_bytes * (double)iterations / (double)elapsed);
+
+    for (int level = HTTP_SCAN_SCALAR; level < HTTP_SCAN_COUNT; level++)
+    {
+        if (!HTTP_Scan_Use((HTTP_Scan_Level)level))
+            continue;
+
+        // O parser escreve terminadores no buffer: cada volta parte de uma cópia limpa
+        started = HTTP_Now();
+        for (long n = 0; n < iterations; n++)
+        {
+            for (size_t i = 0; i < SAMPLE_COUNT; i++)
+            {
+                memcpy(copies[i], samples[i], lengths[i] + 1);
+                sink += kernel_scan(copies[i], lengths[i]);
+            }
+        }
+        elapsed = HTTP_Now() - started;
+        printf("%-8s %8.1f ns/requisição %8.2f GB/s\n", HTTP_Scan_Name(),
+               (double)elapsed / (double)(iterations * (long)SAMPLE_COUNT),
+               (double)total_bytes * (double)iterations / (double)elapsed);
+    }
+
+    for (size_t i = 0; i < SAMPLE_COUNT; i++)
+        free(copies[i]);
+    return sink == 0;
+}
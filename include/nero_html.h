@@ -4,11 +4,14 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+struct HTTP_Arena;
+
 // Representa um atributo HTML, como class="container"
 typedef struct
 {
     char *name;    // nome do atributo (ex: "class")
     char *content; // valor do atributo (ex: "container")
+    struct HTTP_Arena *arena; // arena de origem (NULL = heap)
 } HTML_attribute;
 
 // Representa uma tag HTML genérica
@@ -19,6 +22,7 @@ typedef struct HTML_tag
     struct HTML_tag **children;  // lista de tags filhas (NULL-terminated)
     char *text_content;          // conteúdo de texto interno, se houver (opcional)
     bool void_element;
+    struct HTTP_Arena *arena; // arena de origem (NULL = heap)
 } HTML_tag;
 
 // Representa um documento HTML completo
@@ -26,6 +30,7 @@ typedef struct
 {
     const char *doctype; // ex: "html"
     HTML_tag *html;      // raiz do documento: <html>...</html>
+    struct HTTP_Arena *arena; // arena de origem (NULL = heap)
 } HTML_document;
 
 typedef enum
@@ -63,6 +68,9 @@ size_t HTML_Attribute_LookupSize(const HTML_attribute *attribute);
 // Cria uma nova tag
 HTML_tag *HTML_Create_Tag(const char *name, const char *text_content, bool void_tag);
 
+// Cria uma nova tag na arena (NULL = heap); a árvore inteira é liberada no reinício da arena
+HTML_tag *HTML_Create_Tag_Arena(struct HTTP_Arena *arena, const char *name, const char *text_content, bool void_tag);
+
 // Adiciona um filho a um elemento pai, com flags de controle
 // by_index: posição onde inserir se aplicável
 // by_tag: nome da tag após a qual inserir, se aplicável (pode ser NULL)
@@ -77,6 +85,9 @@ void HTML_Destroy_Tag(HTML_tag **tag);
 // Cria um novo atributo
 HTML_attribute *HTML_Create_Attribute(const char *name, const char *value);
 
+// Cria um novo atributo na arena (NULL = heap)
+HTML_attribute *HTML_Create_Attribute_Arena(struct HTTP_Arena *arena, const char *name, const char *value);
+
 // Adiciona um filho ao vector por realocação
 // by_index: posição onde inserir se aplicável
 // by_attribute: nome do atributo após a qual inserir, se aplicável (pode ser NULL)
@@ -91,6 +102,9 @@ void HTML_Destroy_Attribute(HTML_attribute ***attribute_vector);
 // Cria e inicializa um documento HTML básico
 HTML_document *HTML_Create_Document(void);
 
+// Cria o documento na arena (NULL = heap); os destroys viram no-op
+HTML_document *HTML_Create_Document_Arena(struct HTTP_Arena *arena);
+
 // Destrói o documento e libera toda a memória alocada
 void HTML_Destroy_Document(HTML_document **document);
 
@@ -2,13 +2,74 @@
 #define NERO_HTTP_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdatomic.h>
 #include <pthread.h>
+#include <sys/stat.h>
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 
 #define PORT 9000
 #define USE_SSL 1
 
+// --- Limites de leitura/escrita ---
+#define HTTP_HEADER_MAX_SIZE 65536 // Tamanho máximo aceito para o cabeçalho da requisição
+#define HTTP_HEADER_MAX_FIELDS 64  // Campos aceitos por requisição
+#define HTTP_READ_CHUNK 16384      // Espaço mínimo livre oferecido a cada leitura antecipada
+#define HTTP_OUTPUT_CHUNK 4096     // Capacidade inicial da saída acumulada da conexão
+#define HTTP_OUTPUT_DIRECT 16384   // Escritas maiores seguem do buffer do módulo, sem cópia
+#define HTTP_OUTPUT_FLUSH 65536    // Saída acumulada que força um envio
+#define HTTP_OUTPUT_QUEUE_MAX 262144 // Bytes copiados na fila de saída antes de o módulo esperar pelo socket
+#define HTTP_ARENA_BLOCK 8192      // Bloco inicial da arena de cada requisição
+#define HTTP_ARENA_RETAIN 65536    // Maior bloco que a arena mantém entre requisições
+#define HTTP_RESPONSE_HEAD_MAX 2048 // Bloco de cabeçalho montado por HTTP_Response
+#define HTTP_FILE_CHUNK 65536       // Bloco lido do arquivo quando o corpo passa pela cópia
+#define HTTP_SENDFILE_CHUNK (1u << 20) // Maior trecho pedido a cada sendfile(), para renovar o prazo de escrita
+#define HTTP_ROUTE_MAX_PARAMS 8     // Parâmetros capturados por rota
+
+// --- HTTP/2 ---
+#define HTTP_H2_MAX_STREAMS 100    // SETTINGS_MAX_CONCURRENT_STREAMS anunciado ao cliente
+#define HTTP_H2_FRAME_SIZE 16384   // Maior quadro aceito (SETTINGS_MAX_FRAME_SIZE padrão)
+#define HTTP_HPACK_TABLE_SIZE 4096 // Tabela dinâmica do decodificador (SETTINGS_HEADER_TABLE_SIZE padrão)
+
+// --- Retomada de sessões TLS ---
+#define HTTP_TLS_CACHE_BYTES (16u << 20) // Memória padrão do cache de sessões (--tls-cache=bytes, 0 = sem cache)
+#define HTTP_TLS_CACHE_SHARDS 16         // Partições do cache, cada uma com trava própria
+#define HTTP_TLS_TICKET_ROTATE_S 3600    // Período de cada chave de ticket (--ticket-rotate=s)
+#define HTTP_TLS_TICKET_KEYS 3           // Chaves aceitas na decifragem: a atual e as anteriores
+#define HTTP_TLS_EARLY_DATA_MAX 16384    // Dados 0-RTT aceitos por conexão (--early-data)
+
+// --- Cache de arquivos em memória ---
+#define HTTP_FILE_CACHE_BYTES (64u << 20)   // Orçamento padrão (--file-cache=bytes, 0 = sem cache)
+#define HTTP_FILE_CACHE_MAX_FILE (1u << 20) // Maior arquivo mantido em memória
+#define HTTP_FILE_CACHE_VALID_MS 1000       // Conferência com stat() quando o inotify não está disponível
+#define HTTP_FD_CACHE_MAX 1024              // Descritores mantidos abertos (--fd-cache=n, 0 = sem cache)
+
+// --- Compressão gzip das respostas (zlib) ---
+#define HTTP_COMPRESS_LEVEL 6          // Nível padrão do deflate (--compress=nível, 0 = desativado)
+#define HTTP_COMPRESS_MIN 256          // Menor corpo comprimido (--compress-min=bytes)
+#define HTTP_COMPRESS_MAX (4u << 20)   // Maior corpo comprimido, dinâmico ou arquivo
+
+// --- Prazos padrão por etapa da conexão (ms, 0 = sem limite) ---
+#define HTTP_DEFAULT_HANDSHAKE_TIMEOUT_MS 10000  // SSL_accept completo
+#define HTTP_DEFAULT_FIRST_BYTE_TIMEOUT_MS 10000 // Primeiro byte após aceitar a conexão
+#define HTTP_DEFAULT_HEADER_TIMEOUT_MS 20000     // Cabeçalho completo após o primeiro byte
+#define HTTP_DEFAULT_IDLE_TIMEOUT_MS 60000       // Keep-alive ocioso entre requisições
+#define HTTP_DEFAULT_WRITE_TIMEOUT_MS 30000      // Sem progresso de escrita durante a resposta
+
+// --- Roda de timers hierárquica ---
+#define HTTP_TIMER_TICK_MS 10 // Resolução de um tick
+#define HTTP_TIMER_BITS 6     // 64 posições por nível
+#define HTTP_TIMER_SLOTS (1 << HTTP_TIMER_BITS)
+#define HTTP_TIMER_LEVELS 4 // Alcance de 64^4 ticks (~46 h); prazos maiores são limitados
+
+// --- Aceitação de conexões ---
+#define HTTP_DEFAULT_BACKLOG 1024   // Fila de conexões pendentes do listen()
+#define HTTP_DEFAULT_ACCEPT_BATCH 64 // Máximo de accept4() por evento do socket de escuta
+#define HTTP_CONNECTION_SLAB 64      // Conexões alocadas de uma vez pelo pool do gerenciador
+
 // --- Cross-platform socket abstraction ---
 #ifdef _WIN32
 #include <winsock2.h>
@@ -43,19 +104,245 @@ typedef int socket_fd;
     }
 
 // --- HTTP Connection Structures ---
+
+/// Modo de atendimento das conexões
+typedef enum
+{
+    HTTP_MODE_THREAD,  // Uma thread por conexão (bloqueante)
+    HTTP_MODE_REACTOR, // Laços epoll não bloqueantes em um conjunto fixo de threads (Linux)
+    HTTP_MODE_URING    // Laços io_uring; recai no reactor se indisponível (Linux, opcional)
+} HTTP_Server_Mode;
+
+/// Retomada de sessões TLS configurada na linha de comando
+typedef struct
+{
+    bool enabled;              // Conexões em TLS (--no-tls desliga, p.ex. atrás de um balanceador que termina o TLS)
+    size_t cache_bytes;        // Orçamento do cache de sessões (0 = desativado)
+    int ticket_rotate;         // Segundos de cada chave de ticket
+    const char *ticket_secret; // Arquivo com o segredo compartilhado (NULL = aleatório por processo)
+    bool early_data;           // Aceita 0-RTT (TLS 1.3)
+    bool ktls;                 // Pede ao kernel a cifragem dos registros (kTLS), quando suportado
+} HTTP_TLS_Options;
+
+/// Caminho do corpo de arquivos (HTTP_Send_File)
+typedef enum
+{
+    HTTP_FILE_COPY,     // Blocos lidos com pread e enviados por HTTP_Write
+    HTTP_FILE_SENDFILE, // sendfile() do page cache para o socket, sem TLS (Linux)
+    HTTP_FILE_KTLS,     // SSL_sendfile com a cifragem feita pelo kernel
+    HTTP_FILE_PATH_COUNT
+} HTTP_File_Path;
+
+/// Estado de uma conexão dirigida pelo reactor
+typedef enum
+{
+    HTTP_STATE_HANDSHAKE,   // Aguardando conclusão do SSL_accept
+    HTTP_STATE_READ_HEADER, // Acumulando o cabeçalho da requisição
+    HTTP_STATE_DISPATCH,    // Executando a cadeia de módulos
+    HTTP_STATE_WRITE,       // Esvaziando a fila de saída conforme o socket aceita
+    HTTP_STATE_CLOSED       // Encerrada, aguardando remoção
+} HTTP_Connection_State;
+
+/// Etapa da conexão cujo prazo está armado
+typedef enum
+{
+    HTTP_TIMEOUT_HANDSHAKE,  // Handshake TLS
+    HTTP_TIMEOUT_FIRST_BYTE, // Primeiro byte da primeira requisição
+    HTTP_TIMEOUT_HEADER,     // Restante do cabeçalho
+    HTTP_TIMEOUT_IDLE,       // Keep-alive aguardando a próxima requisição
+    HTTP_TIMEOUT_WRITE,      // Progresso de E/S enquanto os módulos respondem
+    HTTP_TIMEOUT_COUNT
+} HTTP_Timeout;
+
+/// Entrada intrusiva da roda de timers
+typedef struct HTTP_Timer
+{
+    struct HTTP_Timer *next;
+    struct HTTP_Timer **pprev; // Ponteiro que aponta para esta entrada (NULL = desarmado)
+    uint64_t expires;          // Tick de expiração
+    void *owner;
+} HTTP_Timer;
+
+/// Roda de timers: nível 0 em ticks, cada nível seguinte 64x mais grosso
+typedef struct
+{
+    uint64_t start; // Instante do tick 0 (ns, relógio monotônico)
+    uint64_t tick;  // Próximo tick a processar
+    HTTP_Timer *slots[HTTP_TIMER_LEVELS][HTTP_TIMER_SLOTS];
+} HTTP_Timer_Wheel;
+
+// --- Arena por requisição: alocação por deslocamento, descartada de uma vez ---
+typedef struct HTTP_Arena_Block
+{
+    struct HTTP_Arena_Block *next;
+    size_t size;
+    size_t used;
+    max_align_t data[];
+} HTTP_Arena_Block;
+
+typedef struct HTTP_Arena
+{
+    HTTP_Arena_Block *blocks; // Bloco atual primeiro
+} HTTP_Arena;
+
+void *HTTP_Arena_Alloc(HTTP_Arena *arena, size_t size);
+void *HTTP_Arena_Calloc(HTTP_Arena *arena, size_t size);
+char *HTTP_Arena_Strdup(HTTP_Arena *arena, const char *string);
+char *HTTP_Arena_Strndup(HTTP_Arena *arena, const char *string, size_t length);
+void HTTP_Arena_Reset(HTTP_Arena *arena);
+void HTTP_Arena_Destroy(HTTP_Arena *arena);
+
+// --- HTTP Header Structures ---
+/// Cabeçalhos conhecidos, reconhecidos por hash perfeito; os demais ficam como HTTP_HEADER_UNKNOWN
+typedef enum
+{
+    HTTP_HEADER_UNKNOWN = -1,
+    HTTP_HEADER_HOST,
+    HTTP_HEADER_CONNECTION,
+    HTTP_HEADER_KEEP_ALIVE,
+    HTTP_HEADER_CONTENT_LENGTH,
+    HTTP_HEADER_CONTENT_TYPE,
+    HTTP_HEADER_CONTENT_ENCODING,
+    HTTP_HEADER_CONTENT_RANGE,
+    HTTP_HEADER_TRANSFER_ENCODING,
+    HTTP_HEADER_RANGE,
+    HTTP_HEADER_IF_RANGE,
+    HTTP_HEADER_IF_NONE_MATCH,
+    HTTP_HEADER_IF_MODIFIED_SINCE,
+    HTTP_HEADER_ACCEPT,
+    HTTP_HEADER_ACCEPT_ENCODING,
+    HTTP_HEADER_ACCEPT_LANGUAGE,
+    HTTP_HEADER_ACCEPT_RANGES,
+    HTTP_HEADER_USER_AGENT,
+    HTTP_HEADER_COOKIE,
+    HTTP_HEADER_REFERER,
+    HTTP_HEADER_UPGRADE,
+    HTTP_HEADER_EXPECT,
+    HTTP_HEADER_AUTHORIZATION,
+    HTTP_HEADER_CACHE_CONTROL,
+    HTTP_HEADER_DATE,
+    HTTP_HEADER_SERVER,
+    HTTP_HEADER_ETAG,
+    HTTP_HEADER_LAST_MODIFIED,
+    HTTP_HEADER_VARY,
+    HTTP_HEADER_LOCATION,
+    HTTP_HEADER_KNOWN
+} HTTP_Header_Id;
+
+typedef struct HTTP_Header_Value
+{
+    char *name;
+    char *value;
+    HTTP_Header_Id id;
+    struct HTTP_Header_Value *next;
+} HTTP_Header_Value;
+
+/// Campo de uma requisição recebida: fatias do buffer da conexão (terminadas em nulo no lugar)
+typedef struct
+{
+    uint32_t name;
+    uint32_t name_length;
+    uint32_t value;
+    uint32_t value_length;
+} HTTP_Header_Field;
+
+typedef struct
+{
+    char *prologue;
+    HTTP_Header_Value *values; // Campos de cabeçalhos montados pelo servidor
+    HTTP_Header_Value *last;
+    HTTP_Header_Value *known_values[HTTP_HEADER_KNOWN]; // Primeiro valor de cada conhecido
+    size_t count;
+    HTTP_Arena *arena; // Origem da memória dos montados (NULL = malloc)
+    char *base;        // Requisição recebida: início do buffer (NULL nos montados)
+    HTTP_Header_Field fields[HTTP_HEADER_MAX_FIELDS];
+    uint8_t known_fields[HTTP_HEADER_KNOWN]; // Índice + 1 em fields (0 = ausente)
+} HTTP_Header;
+
+struct HTTP_Connection_Manager;
+struct HTTP_Router;
+struct HTTP_Map;
+struct HTTP_Module_Set;
+struct HTTP_H2_Session;
+typedef struct HTTP_Compress HTTP_Compress;
+
+typedef struct
+{
+    const char *name;
+    const char *value;
+} HTTP_Route_Param;
+
+/// Trecho da fila de saída: bytes copiados ou um intervalo de arquivo
+typedef struct HTTP_Output_Block
+{
+    struct HTTP_Output_Block *next;
+    int fd;          // Arquivo do intervalo (-1 = bytes em data)
+    uint64_t offset; // Próximo byte a enviar (em data ou no arquivo)
+    uint64_t length; // Bytes restantes
+    bool clear;      // Texto claro que o TLS do io_uring cifra ao chegar ao início da fila
+    char data[];
+} HTTP_Output_Block;
+
 typedef struct HTTP_Connection
 {
     socket_fd client;
     SSL *ssl;
     bool ended;
+    bool threaded; // Possui thread própria a ser aguardada no destroy
     pthread_t thread;
     bool *run;
     void **modules;
+    struct HTTP_Router *router; // Rotas compiladas dos módulos (NULL = cadeia linear)
+    HTTP_Connection_State state;
+    uint64_t accepted_at; // Instante do accept (ns, relógio monotônico)
+    HTTP_Timeout timeout; // Etapa do prazo atual
+    uint64_t deadline;    // Prazo da etapa atual (ns, 0 = sem limite)
+    HTTP_Timer timer;     // Entrada na roda do laço (modo reactor)
+    char *buffer;          // Bytes recebidos ainda não consumidos (leitura antecipada)
+    size_t buffer_used;    // Bytes válidos em buffer
+    size_t buffer_size;    // Capacidade alocada de buffer
+    size_t buffer_scanned; // Bytes já examinados em busca do fim do cabeçalho
+    size_t request_size;   // Cabeçalho da requisição atual no início do buffer
+    size_t request_body;   // Content-Length da requisição atual
+    size_t discard;        // Bytes de corpo ainda a descartar antes da próxima requisição
+    HTTP_Header request;   // Requisição atual, válida até HTTP_Header_Consume
+    HTTP_Arena arena;      // Memória da requisição atual, reiniciada em HTTP_Header_Consume
+    struct HTTP_Map *map;  // Alvo da requisição atual, analisado uma vez no dispatch
+    HTTP_Route_Param params[HTTP_ROUTE_MAX_PARAMS]; // Capturados pela rota da requisição atual
+    size_t param_count;
+    char *output;          // Saída acumulada ainda não enviada (cabeçalho e blocos pequenos)
+    size_t output_used;    // Bytes válidos em output
+    size_t output_size;    // Capacidade alocada de output
+    bool deferred;         // Envio que bloquearia vai para a fila (reactor sem workers)
+    bool closing;          // Encerra ao esvaziar a fila (resposta sem keep-alive)
+    HTTP_Output_Block *queue;      // Saída aguardando o socket, na ordem da resposta
+    HTTP_Output_Block *queue_tail;
+    size_t queued;         // Bytes copiados na fila (intervalos de arquivo não contam)
+    bool receiving;        // recv multishot armado no anel (io_uring)
+    unsigned sending;      // sends da fila em andamento no anel, encadeados (io_uring)
+    struct HTTP_H2_Session *http2; // Sessão HTTP/2 negociada por ALPN (NULL = HTTP/1.1)
+    HTTP_Compress *compress; // Filtro gzip da resposta atual (NULL = sem filtro)
+    bool early_done;       // Leitura dos dados 0-RTT encerrada (SSL_read_early_data)
+    bool early_write;      // Resposta enviada antes do fim do handshake (SSL_write_early_data)
+    struct HTTP_Connection_Manager *manager; // Gerenciador dono da conexão e do objeto
+    struct HTTP_Connection *completed;       // Encadeamento na fila de concluídas
     struct HTTP_Connection *next;
     struct HTTP_Connection *prev;
 } HTTP_Connection;
 
-typedef struct
+// --- Pool de workers (fila MPMC sem bloqueio, apenas Linux) ---
+typedef struct HTTP_Worker_Pool HTTP_Worker_Pool;
+
+// --- Anéis io_uring de um laço (opcional, apenas Linux) ---
+typedef struct HTTP_Uring HTTP_Uring;
+
+typedef struct HTTP_Connection_Slab
+{
+    struct HTTP_Connection_Slab *next;
+    HTTP_Connection items[HTTP_CONNECTION_SLAB];
+} HTTP_Connection_Slab;
+
+typedef struct HTTP_Connection_Manager
 {
     HTTP_Connection *base;
     HTTP_Connection *head;
@@ -65,58 +352,297 @@ typedef struct
     SSL_CTX *ssl_ctx;
     bool run;
     void **modules;
+    struct HTTP_Router *router;
+    struct HTTP_Module_Set *modules_set; // Instância dos módulos do laço (ou a compartilhada pelas threads por conexão)
     pthread_t thread;
+    int events; // Descritor epoll do laço (modo reactor), -1 se não usado
+    HTTP_Worker_Pool *pool; // Workers que executam os módulos; NULL executa no próprio laço
+    HTTP_Uring *uring;      // Anéis do laço no modo io_uring; NULL nos demais modos
+    _Atomic(HTTP_Connection *) completed; // Pilha MPSC de conexões concluídas por outras threads
+    int notify;                           // eventfd que acorda o gerenciador (-1 = sem eventfd)
+    HTTP_Connection *free_list;           // Objetos de conexão livres para reuso
+    HTTP_Connection_Slab *slabs;          // Blocos alocados pelo pool
+    int accept_batch;       // Conexões aceitas por evento antes de atender outros fds
+    int cpu;                // Núcleo ao qual o laço é fixado (-1 = sem afinidade)
+    size_t accepted;        // Total de conexões aceitas por este laço (balanceamento)
+    int timeouts[HTTP_TIMEOUT_COUNT]; // Prazos por etapa em ms (0 = sem limite)
+    HTTP_Timer_Wheel timers;          // Prazos das conexões do laço (modo reactor)
 } HTTP_Connection_Manager;
 
 // --- Connection Management ---
+socket_fd HTTP_Listen(int port, int backlog, bool reuseport);
 HTTP_Connection *HTTP_Connection_Get(HTTP_Connection_Manager *context);
 void HTTP_Connection_Destroy(HTTP_Connection **conn);
+void HTTP_Connection_Deadline(HTTP_Connection *conn, HTTP_Timeout timeout);
+bool HTTP_Socket_NonBlocking(socket_fd fd);
+bool HTTP_Manager_Init(HTTP_Connection_Manager *context);
+HTTP_Connection *HTTP_Manager_Acquire_Connection(HTTP_Connection_Manager *context);
 bool HTTP_Manager_Push_Connection(HTTP_Connection_Manager *context, HTTP_Connection *push);
 bool HTTP_Manager_Remove_Connection(HTTP_Connection_Manager *context, HTTP_Connection *toRemove, int position, HTTP_Connection *startOver);
+void HTTP_Manager_Complete(HTTP_Connection_Manager *context, HTTP_Connection *conn);
+HTTP_Connection *HTTP_Manager_Collect(HTTP_Connection_Manager *context);
 void HTTP_Manager_Connections(HTTP_Connection_Manager *context);
 void HTTP_Manager_Destroy(HTTP_Connection_Manager *context);
 
-// --- HTTP Header Structures ---
-typedef struct HTTP_Header_Value
-{
-    char *name;
-    char *value;
-    struct HTTP_Header_Value *next;
-} HTTP_Header_Value;
+// --- Reactor (epoll, apenas Linux) ---
+bool HTTP_Reactor_Start(HTTP_Connection_Manager *context);
+void HTTP_Reactor_Stop(HTTP_Connection_Manager *context);
+void HTTP_Reactor_Serve(HTTP_Connection *conn);
 
-typedef struct
-{
-    char *prologue;
-    HTTP_Header_Value *values;
-    size_t count;
-} HTTP_Header;
+// --- Backend io_uring (NERO_HTTP_IO_URING) ---
+bool HTTP_Uring_Start(HTTP_Connection_Manager *context);
+void HTTP_Uring_Stop(HTTP_Connection_Manager *context);
+int HTTP_Uring_Write(HTTP_Connection *conn, const char *data, size_t length);
+bool HTTP_Uring_Flush(HTTP_Connection *conn);
+int HTTP_Uring_Read(HTTP_Connection *conn, char *buffer, size_t length);
+
+HTTP_Worker_Pool *HTTP_Worker_Pool_Create(int workers, size_t capacity, void **modules);
+bool HTTP_Worker_Pool_Submit(HTTP_Worker_Pool *pool, HTTP_Connection *conn);
+void HTTP_Worker_Pool_Destroy(HTTP_Worker_Pool **pool);
+
+// --- Roda de timers (O(1) para armar e cancelar) ---
+void HTTP_Timer_Init(HTTP_Timer_Wheel *wheel, uint64_t now);
+void HTTP_Timer_Arm(HTTP_Timer_Wheel *wheel, HTTP_Timer *timer, uint64_t deadline);
+void HTTP_Timer_Cancel(HTTP_Timer *timer);
+HTTP_Timer *HTTP_Timer_Expire(HTTP_Timer_Wheel *wheel, uint64_t now);
+
+// --- Estatísticas do servidor ---
+uint64_t HTTP_Now(void);
+void HTTP_Stats_Handshake(HTTP_Connection *conn, bool success);
+void HTTP_Stats_Timeout(HTTP_Timeout timeout);
+void HTTP_Stats_File(HTTP_File_Path path, uint64_t bytes);
+void HTTP_Stats_Print(FILE *fd);
 
 // --- Header Operations ---
 HTTP_Header *HTTP_Header_GetFromClient(HTTP_Connection *conn);
+bool HTTP_Header_Reserve(HTTP_Connection *conn, size_t extra);
+char *HTTP_Header_End(HTTP_Connection *conn);
+HTTP_Header *HTTP_Header_Take(HTTP_Connection *conn, char *end);
+void HTTP_Header_Consume(HTTP_Connection *conn);
+bool HTTP_Header_Parse(HTTP_Header *header, char *buffer, size_t length);
 HTTP_Header *HTTP_Header_CreateServerHeader();
+HTTP_Header *HTTP_Header_CreateServerHeader_Arena(HTTP_Arena *arena);
 const char *HTTP_Header_GetValue(HTTP_Header *header, const char *object);
+const char *HTTP_Header_Get(HTTP_Header *header, HTTP_Header_Id id);
+HTTP_Header_Id HTTP_Header_Known(const char *name, size_t length);
 bool HTTP_Header_Push(HTTP_Header *header, const char *name, const char *value, bool replace);
 bool HTTP_Header_RemoveObject(HTTP_Header *header, const char *name, bool firstFind);
 bool HTTP_Header_SendToClient(HTTP_Connection *conn, HTTP_Header *header, int status_code);
 void HTTP_Header_Destroy(HTTP_Header **header);
 void HTTP_Header_Print(HTTP_Header *header);
 
+// --- Response Builder ---
+typedef struct
+{
+    size_t length;
+    bool overflow; // Algum campo não coube: HTTP_Response_Send recusa o bloco
+    char data[HTTP_RESPONSE_HEAD_MAX];
+} HTTP_Response;
+
+const char *HTTP_Status_Reason(int code);
+const char *HTTP_Date_Now(void);
+bool HTTP_Response_Begin(HTTP_Response *response, int status_code);
+bool HTTP_Response_Header(HTTP_Response *response, const char *name, const char *value);
+bool HTTP_Response_Length(HTTP_Response *response, uint64_t length);
+bool HTTP_Response_Fields(HTTP_Response *response, const char *fields, size_t length);
+bool HTTP_Response_Send(HTTP_Connection *conn, HTTP_Response *response);
+
+// --- Header Scanning ---
+typedef enum
+{
+    HTTP_SCAN_SCALAR = 0,
+    HTTP_SCAN_SSE42,
+    HTTP_SCAN_AVX2,
+    HTTP_SCAN_COUNT
+} HTTP_Scan_Level;
+
+void HTTP_Scan_Init(void);
+bool HTTP_Scan_Supported(HTTP_Scan_Level level);
+bool HTTP_Scan_Use(HTTP_Scan_Level level);
+const char *HTTP_Scan_Name(void);
+const char *HTTP_Scan_HeaderEnd(const char *data, const char *end);
+const char *HTTP_Scan_Any(const char *data, const char *end, char a, char b);
+size_t HTTP_Scan_Token(const char *data, const char *end);
+
 // --- HTTP IO ---
 int HTTP_Write(HTTP_Connection *conn, const char *data, size_t length);
+int HTTP_Write_Unfiltered(HTTP_Connection *conn, const char *data, size_t length);
 int HTTP_Read(HTTP_Connection *conn, char *buffer, size_t length);
+bool HTTP_Flush(HTTP_Connection *conn);
+bool HTTP_Output_Append(HTTP_Connection *conn, const char *data, size_t length);
+int HTTP_Write_Raw(HTTP_Connection *conn, const char *data, size_t length);
+int HTTP_Read_Raw(HTTP_Connection *conn, char *buffer, size_t length);
+bool HTTP_Flush_Raw(HTTP_Connection *conn);
+bool HTTP_Output_Queue(HTTP_Connection *conn, const char *data, size_t length);
+bool HTTP_Output_Front(HTTP_Connection *conn, const char *data, size_t length);
+bool HTTP_Output_Load(HTTP_Connection *conn);
+int HTTP_Output_Drain(HTTP_Connection *conn);
+void HTTP_Output_Advance(HTTP_Connection *conn, size_t length);
+void HTTP_Output_Clear(HTTP_Connection *conn);
+HTTP_File_Path HTTP_Send_File_Path(HTTP_Connection *conn);
+bool HTTP_Send_File(HTTP_Connection *conn, int fd, uint64_t offset, uint64_t length);
+bool HTTP_Dispatch(HTTP_Connection *conn, HTTP_Header *header);
 void *HTTP_HandleConnection(HTTP_Connection *conn);
 
+// --- HPACK (RFC 7541) ---
+/// Entrada da tabela dinâmica: "nome\0valor\0" em um único bloco
+typedef struct
+{
+    char *data;
+    uint32_t name_length;
+    uint32_t value_length;
+} HTTP_Hpack_Entry;
+
+typedef struct
+{
+    HTTP_Hpack_Entry entries[HTTP_HPACK_TABLE_SIZE / 32]; // Anel; cada entrada custa ao menos 32 octetos
+    size_t first;    // Entrada mais recente (índice dinâmico 1)
+    size_t count;
+    size_t size;     // Tamanho da tabela conforme a RFC (nome + valor + 32 por entrada)
+    size_t max_size; // Limite atual, ajustado pelo codificador do cliente
+    char *scratch;   // Literais Huffman decodificados do campo atual
+    size_t scratch_size;
+} HTTP_Hpack_Decoder;
+
+/// Recebe cada campo decodificado; os ponteiros valem apenas durante a chamada
+typedef void (*HTTP_Hpack_Emit)(void *context, const char *name, size_t name_length, const char *value, size_t value_length);
+
+// Espaço que basta para HTTP_Hpack_Encode codificar um campo
+#define HTTP_HPACK_ENCODED_MAX(name_length, value_length) ((name_length) + (value_length) + 12)
+
+void HTTP_Hpack_Init(HTTP_Hpack_Decoder *decoder);
+bool HTTP_Hpack_Decode(HTTP_Hpack_Decoder *decoder, const uint8_t *block, size_t length, HTTP_Hpack_Emit emit, void *context);
+void HTTP_Hpack_Destroy(HTTP_Hpack_Decoder *decoder);
+size_t HTTP_Hpack_Encode(uint8_t *out, const char *name, size_t name_length, const char *value, size_t value_length);
+
+// --- HTTP/2 (RFC 9113) ---
+typedef struct HTTP_H2_Session HTTP_H2_Session;
+
+int HTTP_H2_Select_ALPN(SSL *ssl, const unsigned char **out, unsigned char *out_length,
+                        const unsigned char *in, unsigned int in_length, void *enabled);
+bool HTTP_H2_Negotiated(HTTP_Connection *conn);
+void HTTP_H2_Serve(HTTP_Connection *conn);
+int HTTP_H2_Write(HTTP_Connection *conn, const char *data, size_t length);
+bool HTTP_H2_Flush(HTTP_Connection *conn);
+
+// --- TLS: retomada de sessões, 0-RTT e kTLS ---
+bool HTTP_TLS_Setup(SSL_CTX *ctx, const HTTP_TLS_Options *options);
+int HTTP_TLS_Accept(HTTP_Connection *conn, bool pause);
+bool HTTP_TLS_Early_Safe(HTTP_Connection *conn, HTTP_Header *header);
+bool HTTP_TLS_Offloaded(HTTP_Connection *conn);
+void HTTP_TLS_Stats_Print(FILE *fd);
+void HTTP_TLS_Cleanup(void);
+
+// --- Codificações de conteúdo (Accept-Encoding) ---
+#define HTTP_QUALITY_MAX 1000 // q=1 em milésimos
+
+typedef enum
+{
+    HTTP_ENCODING_IDENTITY,
+    HTTP_ENCODING_GZIP,
+    HTTP_ENCODING_BR,
+    HTTP_ENCODING_COUNT
+} HTTP_Encoding;
+
+const char *HTTP_Encoding_Name(HTTP_Encoding encoding);
+void HTTP_Accept_Encoding(HTTP_Header *header, uint16_t quality[HTTP_ENCODING_COUNT]);
+
+// --- Compressão das respostas: filtro gzip entre os módulos e a conexão ---
+void HTTP_Compress_Setup(int level, size_t min);
+bool HTTP_Compress_Accepts(const char *type, uint64_t size);
+bool HTTP_Compress_Data(const char *data, size_t length, char **out, size_t *out_length);
+void HTTP_Compress_Begin(HTTP_Connection *conn, HTTP_Header *header);
+int HTTP_Compress_Write(HTTP_Connection *conn, const char *data, size_t length);
+bool HTTP_Compress_Bypass(HTTP_Connection *conn);
+bool HTTP_Compress_End(HTTP_Connection *conn);
+void HTTP_Compress_Stats_Print(FILE *fd);
+
+// --- Cache de arquivos em memória (CLOCK-Pro, leituras sem trava) ---
+typedef struct HTTP_File_Entry HTTP_File_Entry;
+
+/// Arquivo em memória, imutável enquanto a referência não for solta
+typedef struct
+{
+    HTTP_File_Entry *entry; // Referência a soltar com HTTP_File_Cache_Release
+    const char *data;
+    uint64_t size;
+    const char *type;
+    HTTP_Encoding encoding;
+    bool vary;              // A resposta leva Vary: Accept-Encoding
+    const char *fields;     // Content-Length, Content-Type, Content-Encoding e Vary da resposta 200
+    size_t fields_length;
+} HTTP_File_Hit;
+
+/// Origem de uma entrada: o caminho pedido e o arquivo que o representa
+typedef struct
+{
+    const char *key;        // Caminho pedido (normalizado)
+    const char *source;     // Arquivo lido: o próprio, o documento padrão ou a variante comprimida
+    const char *type;       // Content-Type
+    HTTP_Encoding encoding; // Codificação do conteúdo de source (ou a aplicar, com compress)
+    bool compress;          // source é comprimido com gzip ao entrar no cache
+    bool vary;
+    uint64_t generation;    // HTTP_File_Cache_Generation() antes de abrir source
+} HTTP_File_Source;
+
+void HTTP_File_Cache_Setup(size_t bytes);
+bool HTTP_File_Cache_Get(const char *key, HTTP_Encoding encoding, HTTP_File_Hit *hit);
+uint64_t HTTP_File_Cache_Generation(void);
+bool HTTP_File_Cache_Put(const HTTP_File_Source *origin, int fd, HTTP_File_Hit *hit);
+void HTTP_File_Cache_Release(HTTP_File_Hit *hit);
+void HTTP_File_Cache_Invalidate(const char *path, bool tree);
+void HTTP_File_Cache_Stats_Print(FILE *fd);
+void HTTP_File_Cache_Cleanup(void);
+
+// --- Cache de descritores e metadados por caminho (inclui caminhos inexistentes) ---
+typedef struct
+{
+    struct Fd_Entry *entry; // Referência a soltar com HTTP_Fd_Cache_Release
+    int fd;                 // Compartilhado: leia com offset explícito (pread, sendfile)
+} HTTP_Fd_Handle;
+
+void HTTP_Fd_Cache_Setup(size_t fds);
+bool HTTP_Fd_Cache_Stat(const char *path, struct stat *st);
+int HTTP_Fd_Cache_Open(const char *path, struct stat *st, HTTP_Fd_Handle *handle);
+void HTTP_Fd_Cache_Release(HTTP_Fd_Handle *handle);
+void HTTP_Fd_Cache_Invalidate(const char *path, bool tree);
+void HTTP_Fd_Cache_Stats_Print(FILE *fd);
+void HTTP_Fd_Cache_Cleanup(void);
+
+// --- Observador inotify que invalida os caches de arquivos ---
+bool HTTP_File_Watch(const char *root);
+bool HTTP_File_Watch_Active(void);
+void HTTP_File_Watch_Stats_Print(FILE *fd);
+void HTTP_File_Watch_Stop(void);
+
 // --- URL / Path Mapping ---
+#define HTTP_MAP_INLINE_SEGMENTS 16 // Segmentos guardados no próprio mapa, sem alocação extra
+
 typedef struct
+{
+    const char *key;
+    const char *value;
+} HTTP_Map_Param;
+
+typedef struct HTTP_Map
 {
     const char *method;
-    const char *verb;
-    const char **path;
+    const char *verb;       // Query string crua, sem '?' (NULL = ausente)
+    const char **path;      // Segmentos decodificados, sem vazios, "." nem ".."
     size_t count;
-    void *internal;
+    bool directory;         // Caminho terminado em '/' (ou raiz)
+    HTTP_Arena *arena;      // Origem da memória (NULL = malloc)
+    HTTP_Map_Param *params; // Query decodificada, montada na primeira consulta
+    size_t param_count;
+    bool params_parsed;
+    const char *segments[HTTP_MAP_INLINE_SEGMENTS];
+    char storage[]; // Método, segmentos e query, com terminadores
 } HTTP_Map;
 
 HTTP_Map *HTTP_Map_Get(HTTP_Header *header);
+HTTP_Map *HTTP_Map_Get_Arena(HTTP_Header *header, HTTP_Arena *arena);
+bool HTTP_Map_Join(const HTTP_Map *map, char *buffer, size_t size);
+const char *HTTP_Map_Query(HTTP_Map *map, const char *key);
 void HTTP_Map_Print(HTTP_Map *map);
 void HTTP_Map_Destroy(HTTP_Map **map);
 
@@ -11,15 +11,73 @@ typedef enum
     HTTP_MODULE_FATAL    // Falha crítica; o servidor deve ser reiniciado
 } HTTP_Module_Response;
 
+/// Métodos aceitos por uma rota (máscara de bits)
+typedef enum
+{
+    HTTP_METHOD_GET = 1 << 0,
+    HTTP_METHOD_HEAD = 1 << 1,
+    HTTP_METHOD_POST = 1 << 2,
+    HTTP_METHOD_PUT = 1 << 3,
+    HTTP_METHOD_DELETE = 1 << 4,
+    HTTP_METHOD_OPTIONS = 1 << 5,
+    HTTP_METHOD_PATCH = 1 << 6,
+    HTTP_METHOD_OTHER = 1 << 7, // Qualquer método fora da lista
+    HTTP_METHOD_ANY = 0xff
+} HTTP_Method;
+
+/// Rota atendida por um módulo
+/// pattern: segmentos literais, ":nome" captura um segmento, "*nome" (último) captura o restante
+typedef struct
+{
+    unsigned methods;    // Máscara de HTTP_Method
+    const char *pattern; // Ex.: "/static/*path", "/users/:id"
+} HTTP_Route;
+
 /// Estrutura base de um módulo HTTP plugável
 typedef struct
 {
-    const char *name; // Nome do módulo
-    const char *ver;  // Versão do módulo
-    void *internal;   // Dados internos específicos do módulo
+    const char *name;          // Nome do módulo
+    const char *ver;           // Versão do módulo
+    void *internal;            // Dados internos específicos do módulo
+    const HTTP_Route *routes;  // Rotas atendidas, terminadas por {0} (NULL = todas as requisições)
 
-    void *(*load)(void);                                                                        // Função de inicialização
+    void *(*load)(void);                                                                        // Cria a instância de um worker ou shard (NULL = falha)
     HTTP_Module_Response (*action)(void *internal, HTTP_Connection *conn, HTTP_Header *header); // Manipulador principal
-    void (*destroy)(void **internal);                                                           // Função de limpeza
+    void (*destroy)(void **internal);                                                           // Libera a instância criada por load
 } HTTP_Module;
+
+/// Módulo candidato de uma rota, na ordem de registro
+typedef struct
+{
+    const HTTP_Module *module; // NULL encerra a lista
+    unsigned methods;
+    size_t index; // Posição do módulo na lista registrada
+    const HTTP_Route_Param *params; // Capturados pela rota que casou o módulo (lista de HTTP_Router_Match)
+    size_t param_count;
+} HTTP_Route_Handler;
+
+/// Instância dos módulos de um worker ou shard: o internal de cada módulo, na ordem da lista
+/// Sem concorrência dentro da instância, caches e buffers dispensam travas; a exceção é o modo
+/// thread, em que uma só instância atende todas as threads por conexão e o estado mutável precisa delas
+typedef struct HTTP_Module_Set
+{
+    const HTTP_Module **modules;
+    size_t count;
+    void *internal[];
+} HTTP_Module_Set;
+
+// --- Ciclo de vida dos módulos ---
+HTTP_Module_Set *HTTP_Modules_Load(const HTTP_Module **modules);
+void HTTP_Modules_Unload(HTTP_Module_Set **set);
+void HTTP_Modules_Bind(HTTP_Module_Set *set);
+void *HTTP_Module_Internal(HTTP_Connection *conn, size_t index);
+
+// --- Roteador (árvore radix por segmentos, montada na inicialização) ---
+typedef struct HTTP_Router HTTP_Router;
+
+HTTP_Router *HTTP_Router_Create(const HTTP_Module **modules);
+const HTTP_Route_Handler *HTTP_Router_Match(const HTTP_Router *router, HTTP_Connection *conn, unsigned method);
+void HTTP_Router_Destroy(HTTP_Router **router);
+unsigned HTTP_Method_Get(const char *method);
+const char *HTTP_Route_Get(HTTP_Connection *conn, const char *name);
 #endif
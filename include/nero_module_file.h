@@ -7,6 +7,7 @@ typedef struct
     const char *root;
     const char **default_document;
     const char **mine_types[2]; // [0] extensões, [1] tipos MIME correspondentes
+    char *resolved_root;        // Raiz absoluta, resolvida uma vez por instância (load)
 } file;
 
 static const char *default_documents[] = {
@@ -21,4 +22,4 @@ static const char *mime_types[] = {
     "text/plain", "application/json", NULL};
     
 #define FILE_READ_BUFFER_SIZE 65536
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <nero_http.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#define ARENA_ALIGN (sizeof(max_align_t))
+#define ARENA_ROUND(size) (((size) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+// --- Encadeia um novo bloco capaz de atender ao pedido ---
+static HTTP_Arena_Block *arena_grow(HTTP_Arena *arena, size_t size)
+{
+    size_t capacity = HTTP_ARENA_BLOCK;
+    while (capacity < size)
+        capacity *= 2;
+
+    HTTP_Arena_Block *block = malloc(sizeof(HTTP_Arena_Block) + capacity);
+    if (!block)
+    {
+        HTTP_PRINT_ERROR(stderr, "malloc");
+        return NULL;
+    }
+    block->size = capacity;
+    block->used = 0;
+    block->next = arena->blocks;
+    arena->blocks = block;
+    return block;
+}
+
+// --- Reserva memória alinhada; liberada em conjunto por HTTP_Arena_Reset ---
+void *HTTP_Arena_Alloc(HTTP_Arena *arena, size_t size)
+{
+    size = ARENA_ROUND(size ? size : 1);
+
+    HTTP_Arena_Block *block = arena->blocks;
+    if (!block || block->size - block->used < size)
+    {
+        block = arena_grow(arena, size);
+        if (!block)
+            return NULL;
+    }
+
+    void *memory = (char *)block->data + block->used;
+    block->used += size;
+    return memory;
+}
+
+void *HTTP_Arena_Calloc(HTTP_Arena *arena, size_t size)
+{
+    void *memory = HTTP_Arena_Alloc(arena, size);
+    if (memory)
+        memset(memory, 0, size);
+    return memory;
+}
+
+char *HTTP_Arena_Strndup(HTTP_Arena *arena, const char *string, size_t length)
+{
+    char *copy = HTTP_Arena_Alloc(arena, length + 1);
+    if (copy)
+    {
+        memcpy(copy, string, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+char *HTTP_Arena_Strdup(HTTP_Arena *arena, const char *string)
+{
+    return HTTP_Arena_Strndup(arena, string, strlen(string));
+}
+
+// --- Descarta tudo o que foi reservado (fim da requisição) ---
+// Se a requisição precisou de vários blocos, eles viram um único bloco do tamanho somado,
+// limitado a HTTP_ARENA_RETAIN para que conexões reaproveitadas não prendam picos de memória
+void HTTP_Arena_Reset(HTTP_Arena *arena)
+{
+    HTTP_Arena_Block *block = arena->blocks;
+    if (!block)
+        return;
+
+    size_t total = 0;
+    for (HTTP_Arena_Block *each = block; each; each = each->next)
+        total += each->size;
+    size_t keep = total < HTTP_ARENA_RETAIN ? total : HTTP_ARENA_RETAIN;
+
+    if (!block->next && block->size == keep)
+    {
+        block->used = 0;
+        return;
+    }
+
+    HTTP_Arena_Destroy(arena);
+    arena_grow(arena, keep);
+}
+
+void HTTP_Arena_Destroy(HTTP_Arena *arena)
+{
+    HTTP_Arena_Block *block = arena->blocks;
+    while (block)
+    {
+        HTTP_Arena_Block *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->blocks = NULL;
+}
@@ -0,0 +1,555 @@
+#include <nero_http.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef NERO_HTTP_ZLIB
+#include <zlib.h>
+
+#define COMPRESS_GZIP_WRAPPER 16 // windowBits + 16: cabeçalho e rodapé gzip em vez de zlib
+#define COMPRESS_CHUNK 16384     // Saída do deflate enviada a cada vez que enche
+
+static int compress_level; // Definido antes das threads; 0 = desativado
+static size_t compress_min;
+static atomic_uint_fast64_t compress_responses;
+static atomic_uint_fast64_t compress_files;
+static atomic_uint_fast64_t compress_in;
+static atomic_uint_fast64_t compress_out;
+
+// --- Filtro gzip de uma resposta ---
+// O cabeçalho escrito pelo módulo é acumulado até o \r\n\r\n, como no HTTP/2. Se a resposta
+// é elegível, ele sai logo, sem Content-Length, e o corpo (de tamanho já anunciado) passa pelo
+// deflate em trechos: em HTTP/1.1 cada trecho vira um chunk, em HTTP/2 um quadro DATA.
+// Senão tudo segue adiante e o filtro sai do caminho
+typedef enum
+{
+    COMPRESS_HEAD,
+    COMPRESS_BODY
+} Compress_State;
+
+struct HTTP_Compress
+{
+    Compress_State state;
+    char *head; // Na arena da requisição
+    size_t head_used;
+    size_t head_size;
+    size_t head_length; // Cabeçalho original, sem o corpo que veio junto
+    bool vary;          // O módulo já enviou Vary (Accept-Encoding é acrescentado a ele)
+    bool chunked;       // HTTP/1.1: o corpo comprimido segue com Transfer-Encoding: chunked
+    uint64_t remaining; // Bytes do corpo original ainda esperados
+    uint64_t length;    // Content-Length original
+    z_stream stream;
+    bool stream_ready;
+    char *out; // COMPRESS_CHUNK bytes na arena da requisição
+};
+
+void HTTP_Compress_Setup(int level, size_t min)
+{
+    compress_level = level < 0 ? 0 : level > 9 ? 9 : level;
+    compress_min = min;
+}
+
+// --- Tipos que ganham com compressão (texto, JSON, XML, SVG...) ---
+static bool compress_type(const char *type, size_t length)
+{
+    static const char *types[] = {
+        "application/json", "application/javascript", "application/xml",
+        "application/wasm", "image/svg+xml", NULL};
+
+    const char *end = memchr(type, ';', length);
+    if (end)
+        length = (size_t)(end - type);
+    while (length && (type[length - 1] == ' ' || type[length - 1] == '\t'))
+        length--;
+
+    if (length > 5 && strncasecmp(type, "text/", 5) == 0)
+        return true;
+    if (length > 5 && (strncasecmp(type + length - 5, "+json", 5) == 0 || strncasecmp(type + length - 4, "+xml", 4) == 0))
+        return true;
+    for (int i = 0; types[i]; i++)
+    {
+        if (strlen(types[i]) == length && strncasecmp(type, types[i], length) == 0)
+            return true;
+    }
+    return false;
+}
+
+// --- Corpo de um tipo e tamanho que vale comprimir ---
+bool HTTP_Compress_Accepts(const char *type, uint64_t size)
+{
+    return compress_level > 0 && size >= compress_min && size <= HTTP_COMPRESS_MAX &&
+           type && compress_type(type, strlen(type));
+}
+
+// Janela e tabela de hash proporcionais ao corpo: respostas pequenas não pagam os ~256 KiB do padrão
+static bool compress_init(z_stream *stream, uint64_t length)
+{
+    int bits = 9;
+    while (bits < 15 && (1ull << bits) < length)
+        bits++;
+    int mem_level = bits - 7 < 1 ? 1 : bits - 7;
+
+    memset(stream, 0, sizeof(*stream));
+    if (deflateInit2(stream, compress_level, Z_DEFLATED, bits + COMPRESS_GZIP_WRAPPER, mem_level, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        HTTP_PRINT_ERROR(stderr, "deflateInit2 failed");
+        return false;
+    }
+    return true;
+}
+
+// --- gzip de um bloco inteiro em uma passada (arquivos que vão para o cache) ---
+// *out vem de malloc e fica com quem chamou
+bool HTTP_Compress_Data(const char *data, size_t length, char **out, size_t *out_length)
+{
+    z_stream stream;
+    if (compress_level <= 0 || !compress_init(&stream, length))
+        return false;
+
+    size_t size = deflateBound(&stream, (uLong)length);
+    char *buffer = malloc(size);
+    if (!buffer)
+    {
+        deflateEnd(&stream);
+        return false;
+    }
+
+    stream.next_in = (Bytef *)data;
+    stream.avail_in = (uInt)length;
+    stream.next_out = (Bytef *)buffer;
+    stream.avail_out = (uInt)size;
+    int ret = deflate(&stream, Z_FINISH);
+    size_t produced = stream.total_out;
+    deflateEnd(&stream);
+    if (ret != Z_STREAM_END)
+    {
+        HTTP_PRINT_ERROR(stderr, "deflate failed");
+        free(buffer);
+        return false;
+    }
+
+    atomic_fetch_add_explicit(&compress_files, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&compress_in, length, memory_order_relaxed);
+    atomic_fetch_add_explicit(&compress_out, produced, memory_order_relaxed);
+    *out = buffer;
+    *out_length = produced;
+    return true;
+}
+
+// --- Arma o filtro para a requisição, se o cliente aceita gzip tanto quanto identity ---
+// Um cliente HTTP/1.0 não entende chunked e recebe o corpo como está
+void HTTP_Compress_Begin(HTTP_Connection *conn, HTTP_Header *header)
+{
+    conn->compress = NULL;
+    if (compress_level <= 0 || !header->prologue || strncmp(header->prologue, "HEAD ", 5) == 0)
+        return;
+
+    size_t prologue_length = strlen(header->prologue);
+    if (!conn->http2 && prologue_length >= 8 && strcmp(header->prologue + prologue_length - 8, "HTTP/1.0") == 0)
+        return;
+
+    uint16_t quality[HTTP_ENCODING_COUNT];
+    HTTP_Accept_Encoding(header, quality);
+    if (!quality[HTTP_ENCODING_GZIP] || quality[HTTP_ENCODING_GZIP] < quality[HTTP_ENCODING_IDENTITY])
+        return;
+
+    conn->compress = HTTP_Arena_Calloc(&conn->arena, sizeof(HTTP_Compress));
+    if (conn->compress)
+        conn->compress->chunked = !conn->http2;
+}
+
+static void compress_release(HTTP_Compress *compress)
+{
+    if (compress->stream_ready)
+        deflateEnd(&compress->stream);
+    compress->stream_ready = false;
+}
+
+// Resposta que segue sem compressão: o que foi acumulado sai e o filtro deixa de existir
+static int compress_pass(HTTP_Connection *conn, HTTP_Compress *compress, int length)
+{
+    conn->compress = NULL;
+    if (compress->head_used && HTTP_Write_Unfiltered(conn, compress->head, compress->head_used) < 0)
+        return -1;
+    return length;
+}
+
+static bool compress_value_has(const char *value, const char *value_end, const char *token)
+{
+    size_t length = strlen(token);
+    for (; value + length <= value_end; value++)
+    {
+        if (strncasecmp(value, token, length) == 0)
+            return true;
+    }
+    return false;
+}
+
+// --- Decide pelo cabeçalho: status com corpo inteiro, tipo elegível e tamanho conhecido ---
+static bool compress_eligible(HTTP_Compress *compress, const char *head, size_t length)
+{
+    const char *end = head + length;
+    const char *line_end = memchr(head, '\n', length);
+    const char *status = memchr(head, ' ', length);
+    if (!line_end || !status || status > line_end || end - status < 4)
+        return false;
+
+    int code = atoi(status + 1);
+    if (code < 200 || code == 204 || code == 206 || code == 304)
+        return false;
+
+    bool has_length = false;
+    bool has_type = false;
+    for (const char *line = line_end + 1; line < end; line = line_end + 1)
+    {
+        line_end = memchr(line, '\n', (size_t)(end - line));
+        if (!line_end)
+            break;
+        const char *colon = memchr(line, ':', (size_t)(line_end - line));
+        if (!colon)
+            continue;
+
+        const char *value = colon + 1;
+        const char *value_end = line_end;
+        while (value < value_end && (*value == ' ' || *value == '\t'))
+            value++;
+        while (value_end > value && (value_end[-1] == '\r' || value_end[-1] == ' ' || value_end[-1] == '\t'))
+            value_end--;
+
+        switch (HTTP_Header_Known(line, (size_t)(colon - line)))
+        {
+        case HTTP_HEADER_CONTENT_LENGTH:
+            has_length = true;
+            compress->length = strtoull(value, NULL, 10);
+            break;
+        case HTTP_HEADER_CONTENT_TYPE:
+            has_type = compress_type(value, (size_t)(value_end - value));
+            break;
+        case HTTP_HEADER_CONTENT_ENCODING:
+        case HTTP_HEADER_CONTENT_RANGE:
+        case HTTP_HEADER_TRANSFER_ENCODING:
+            return false;
+        case HTTP_HEADER_CACHE_CONTROL:
+            if (compress_value_has(value, value_end, "no-transform"))
+                return false;
+            break;
+        case HTTP_HEADER_VARY:
+            compress->vary = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return has_length && has_type && compress->length >= compress_min && compress->length <= HTTP_COMPRESS_MAX;
+}
+
+// --- Cabeçalho final: o original sem Content-Length, mais Content-Encoding, Vary e o enquadramento ---
+static bool compress_send_head(HTTP_Connection *conn, HTTP_Compress *compress)
+{
+    static const char vary_field[] = "Vary: Accept-Encoding\r\n";
+    static const char encoding_field[] = "Content-Encoding: gzip\r\n";
+    static const char chunked_field[] = "Transfer-Encoding: chunked\r\n";
+    const char *head = compress->head;
+    const char *end = head + compress->head_length;
+
+    static const char vary_extend[] = ", Accept-Encoding";
+    size_t tail = sizeof(vary_field) + sizeof(encoding_field) + sizeof(chunked_field) + 2; // Campos acrescentados
+    size_t size = compress->head_length + sizeof(vary_extend) + tail;
+    char *out = HTTP_Arena_Alloc(&conn->arena, size);
+    if (!out)
+        return false;
+
+    // Linha de status e campos, menos a linha vazia final
+    size_t used = 0;
+    const char *line = head;
+    bool first = true;
+    while (line < end)
+    {
+        const char *line_end = memchr(line, '\n', (size_t)(end - line));
+        if (!line_end)
+            break;
+        const char *next = line_end + 1;
+        const char *content_end = line_end > line && line_end[-1] == '\r' ? line_end - 1 : line_end;
+        if (content_end == line)
+            break;
+
+        const char *colon = first ? NULL : memchr(line, ':', (size_t)(content_end - line));
+        HTTP_Header_Id id = colon ? HTTP_Header_Known(line, (size_t)(colon - line)) : HTTP_HEADER_UNKNOWN;
+        first = false;
+        if (id == HTTP_HEADER_CONTENT_LENGTH)
+        {
+            line = next;
+            continue;
+        }
+
+        size_t line_length = (size_t)(content_end - line);
+        bool extend = id == HTTP_HEADER_VARY && !compress_value_has(colon + 1, content_end, "accept-encoding");
+        if (used + line_length + sizeof(vary_extend) + 2 + tail > size)
+            return false;
+
+        memcpy(out + used, line, line_length);
+        used += line_length;
+        if (extend)
+        {
+            memcpy(out + used, vary_extend, sizeof(vary_extend) - 1);
+            used += sizeof(vary_extend) - 1;
+        }
+        memcpy(out + used, "\r\n", 2);
+        used += 2;
+        line = next;
+    }
+
+    if (!compress->vary)
+    {
+        memcpy(out + used, vary_field, sizeof(vary_field) - 1);
+        used += sizeof(vary_field) - 1;
+    }
+    memcpy(out + used, encoding_field, sizeof(encoding_field) - 1);
+    used += sizeof(encoding_field) - 1;
+    if (compress->chunked)
+    {
+        memcpy(out + used, chunked_field, sizeof(chunked_field) - 1);
+        used += sizeof(chunked_field) - 1;
+    }
+    memcpy(out + used, "\r\n", 2);
+    used += 2;
+
+    return HTTP_Write_Unfiltered(conn, out, used) >= 0;
+}
+
+// --- Envia o que o deflate produziu até aqui (um chunk em HTTP/1.1) e libera a saída ---
+static bool compress_emit(HTTP_Connection *conn, HTTP_Compress *compress)
+{
+    size_t produced = COMPRESS_CHUNK - compress->stream.avail_out;
+    compress->stream.next_out = (Bytef *)compress->out;
+    compress->stream.avail_out = COMPRESS_CHUNK;
+    if (produced == 0)
+        return true;
+
+    if (compress->chunked)
+    {
+        char size_line[24];
+        int size_length = snprintf(size_line, sizeof(size_line), "%zx\r\n", produced);
+        return HTTP_Write_Unfiltered(conn, size_line, (size_t)size_length) >= 0 &&
+               HTTP_Write_Unfiltered(conn, compress->out, produced) >= 0 &&
+               HTTP_Write_Unfiltered(conn, "\r\n", 2) >= 0;
+    }
+    return HTTP_Write_Unfiltered(conn, compress->out, produced) >= 0;
+}
+
+// --- Passa um trecho do corpo pelo deflate; a saída sai a cada COMPRESS_CHUNK produzidos ---
+static bool compress_body(HTTP_Connection *conn, HTTP_Compress *compress, const char *data, size_t length)
+{
+    // Além do Content-Length anunciado o corpo é descartado, como no HTTP/2
+    if (length > compress->remaining)
+        length = (size_t)compress->remaining;
+    compress->remaining -= length;
+
+    z_stream *stream = &compress->stream;
+    stream->next_in = (Bytef *)data;
+    stream->avail_in = (uInt)length;
+    int flush = compress->remaining ? Z_NO_FLUSH : Z_FINISH;
+    for (;;)
+    {
+        int ret = deflate(stream, flush);
+        if (ret == Z_STREAM_ERROR)
+        {
+            HTTP_PRINT_ERROR(stderr, "deflate failed");
+            return false;
+        }
+        if (stream->avail_out == 0)
+        {
+            if (!compress_emit(conn, compress))
+                return false;
+            continue;
+        }
+        if (flush == Z_FINISH ? ret == Z_STREAM_END : stream->avail_in == 0)
+            break;
+    }
+    if (compress->remaining)
+        return true;
+
+    atomic_fetch_add_explicit(&compress_responses, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&compress_in, compress->length, memory_order_relaxed);
+    atomic_fetch_add_explicit(&compress_out, stream->total_out, memory_order_relaxed);
+
+    conn->compress = NULL;
+    bool sent = compress_emit(conn, compress) &&
+                (!compress->chunked || HTTP_Write_Unfiltered(conn, "0\r\n\r\n", 5) >= 0);
+    compress_release(compress);
+    return sent;
+}
+
+// --- Resposta elegível: o cabeçalho já sai e o deflate passa a receber o corpo ---
+static bool compress_start(HTTP_Connection *conn, HTTP_Compress *compress)
+{
+    compress->out = HTTP_Arena_Alloc(&conn->arena, COMPRESS_CHUNK);
+    if (!compress->out || !compress_init(&compress->stream, compress->length))
+        return false;
+    compress->stream_ready = true;
+
+    compress->stream.next_out = (Bytef *)compress->out;
+    compress->stream.avail_out = COMPRESS_CHUNK;
+    compress->remaining = compress->length;
+    compress->state = COMPRESS_BODY;
+    return true;
+}
+
+// --- HTTP_Write com o filtro armado ---
+int HTTP_Compress_Write(HTTP_Connection *conn, const char *data, size_t length)
+{
+    HTTP_Compress *compress = conn->compress;
+    if (compress->state == COMPRESS_BODY)
+    {
+        if (compress_body(conn, compress, data, length))
+            return (int)length;
+        conn->compress = NULL;
+        compress_release(compress);
+        return -1;
+    }
+
+    // Acumula o cabeçalho; o trecho de corpo que vier junto fica atrás dele
+    size_t scanned = compress->head_used > 3 ? compress->head_used - 3 : 0;
+    if (compress->head_size - compress->head_used < length)
+    {
+        size_t size = compress->head_size ? compress->head_size : HTTP_RESPONSE_HEAD_MAX;
+        while (size - compress->head_used < length)
+            size *= 2;
+        char *head = HTTP_Arena_Alloc(&conn->arena, size);
+        if (!head)
+            return -1;
+        if (compress->head_used)
+            memcpy(head, compress->head, compress->head_used);
+        compress->head = head;
+        compress->head_size = size;
+    }
+    memcpy(compress->head + compress->head_used, data, length);
+    compress->head_used += length;
+
+    const char *end = HTTP_Scan_HeaderEnd(compress->head + scanned, compress->head + compress->head_used);
+    if (!end)
+        return compress->head_used > HTTP_HEADER_MAX_SIZE ? compress_pass(conn, compress, (int)length) : (int)length;
+
+    compress->head_length = (size_t)(end - compress->head);
+    if (!compress_eligible(compress, compress->head, compress->head_length))
+        return compress_pass(conn, compress, (int)length);
+    if (!compress_start(conn, compress))
+    {
+        compress_release(compress);
+        return compress_pass(conn, compress, (int)length);
+    }
+    if (!compress_send_head(conn, compress))
+    {
+        conn->compress = NULL;
+        compress_release(compress);
+        return -1;
+    }
+
+    size_t body = compress->head_used - compress->head_length;
+    if (body == 0 && compress->length)
+        return (int)length;
+    if (compress_body(conn, compress, compress->head + compress->head_length, body))
+        return (int)length;
+    conn->compress = NULL;
+    compress_release(compress);
+    return -1;
+}
+
+// --- O módulo cuida da codificação (ou envia pelo kernel): o filtro sai do caminho ---
+// Chamado antes de escrever a resposta
+bool HTTP_Compress_Bypass(HTTP_Connection *conn)
+{
+    HTTP_Compress *compress = conn->compress;
+    if (!compress)
+        return true;
+    if (compress->state == COMPRESS_BODY)
+        return false;
+    return compress_pass(conn, compress, 0) >= 0;
+}
+
+// --- Fim da requisição: false se a resposta ficou incompleta (a conexão é encerrada) ---
+bool HTTP_Compress_End(HTTP_Connection *conn)
+{
+    HTTP_Compress *compress = conn->compress;
+    if (!compress)
+        return true;
+
+    if (compress->state == COMPRESS_HEAD)
+        return compress_pass(conn, compress, 0) >= 0;
+
+    // Corpo menor que o Content-Length: a resposta fica sem o chunk final e a conexão é encerrada
+    HTTP_PRINT_ERROR(stderr, "response body shorter than Content-Length");
+    conn->compress = NULL;
+    compress_release(compress);
+    return false;
+}
+
+void HTTP_Compress_Stats_Print(FILE *fd)
+{
+    if (compress_level <= 0)
+        return;
+
+    uint64_t in = atomic_load(&compress_in);
+    uint64_t out = atomic_load(&compress_out);
+    fprintf(fd, "Compressão gzip: %llu respostas, %llu arquivos, %llu -> %llu bytes (%.1f%%)\n",
+            (unsigned long long)atomic_load(&compress_responses),
+            (unsigned long long)atomic_load(&compress_files),
+            (unsigned long long)in, (unsigned long long)out,
+            in ? 100.0 * (double)out / (double)in : 0.0);
+}
+
+#else
+
+void HTTP_Compress_Setup(int level, size_t min)
+{
+    (void)min;
+    if (level > 0)
+        HTTP_PRINT_ERROR(stderr, "built without zlib, responses are not compressed");
+}
+
+bool HTTP_Compress_Accepts(const char *type, uint64_t size)
+{
+    (void)type;
+    (void)size;
+    return false;
+}
+
+bool HTTP_Compress_Data(const char *data, size_t length, char **out, size_t *out_length)
+{
+    (void)data;
+    (void)length;
+    (void)out;
+    (void)out_length;
+    return false;
+}
+
+void HTTP_Compress_Begin(HTTP_Connection *conn, HTTP_Header *header)
+{
+    (void)header;
+    conn->compress = NULL;
+}
+
+int HTTP_Compress_Write(HTTP_Connection *conn, const char *data, size_t length)
+{
+    return HTTP_Write_Unfiltered(conn, data, length);
+}
+
+bool HTTP_Compress_Bypass(HTTP_Connection *conn)
+{
+    (void)conn;
+    return true;
+}
+
+bool HTTP_Compress_End(HTTP_Connection *conn)
+{
+    (void)conn;
+    return true;
+}
+
+void HTTP_Compress_Stats_Print(FILE *fd)
+{
+    (void)fd;
+}
+
+#endif
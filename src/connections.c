@@ -1,6 +1,82 @@
 #include <nero_http.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+
+// --- Cria o socket de escuta; com reuseport cada shard pode ter o seu na mesma porta ---
+socket_fd HTTP_Listen(int port, int backlog, bool reuseport)
+{
+    socket_fd server = socket(AF_INET, SOCK_STREAM, 0);
+    if (server < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "socket");
+        return -1;
+    }
+
+#ifndef _WIN32
+    int enable = 1;
+    setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+#endif
+
+    if (reuseport)
+    {
+#ifdef SO_REUSEPORT
+        int enable_port = 1;
+        if (setsockopt(server, SOL_SOCKET, SO_REUSEPORT, &enable_port, sizeof(enable_port)) < 0)
+        {
+            HTTP_PRINT_ERROR(stderr, "SO_REUSEPORT");
+            close_socket(server);
+            return -1;
+        }
+#else
+        HTTP_PRINT_ERROR(stderr, "SO_REUSEPORT not supported");
+        close_socket(server);
+        return -1;
+#endif
+    }
+
+    struct sockaddr_in server_addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = INADDR_ANY,
+    };
+
+    if (bind(server, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "bind");
+        close_socket(server);
+        return -1;
+    }
+
+    if (listen(server, backlog) < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "listen");
+        close_socket(server);
+        return -1;
+    }
+
+    return server;
+}
+
+// --- Coloca o socket em modo não bloqueante ---
+bool HTTP_Socket_NonBlocking(socket_fd fd)
+{
+#ifdef _WIN32
+    u_long enable = 1;
+    return ioctlsocket(fd, FIONBIO, &enable) == 0;
+#else
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
 
 // --- Aceita nova conexão, cria e inicia thread para lidar com ela ---
+// O handshake TLS acontece na thread da conexão, fora do laço de aceitação
 HTTP_Connection *HTTP_Connection_Get(HTTP_Connection_Manager *context)
 {
     socket_fd clientfd = accept(context->server, NULL, NULL);
@@ -9,26 +85,32 @@ HTTP_Connection *HTTP_Connection_Get(HTTP_Connection_Manager *context)
         HTTP_PRINT_ERROR(stderr, "accept");
         return NULL;
     }
+    context->accepted++;
+
+    // Toda espera da thread passa pelo poll com o prazo da etapa atual
+    if (!HTTP_Socket_NonBlocking(clientfd))
+    {
+        HTTP_PRINT_ERROR(stderr, "non-blocking socket");
+        close_socket(clientfd);
+        return NULL;
+    }
 
     SSL *ssl = NULL;
     if (context->ssl_ctx)
     {
         ssl = SSL_new(context->ssl_ctx);
-        SSL_set_fd(ssl, clientfd);
-
-        if (SSL_accept(ssl) <= 0)
+        if (!ssl)
         {
-            HTTP_PRINT_SSL_ERROR(stderr, "ssl accept");
-            SSL_free(ssl);
+            HTTP_PRINT_SSL_ERROR(stderr, "SSL_new");
             close_socket(clientfd);
             return NULL;
         }
+        SSL_set_fd(ssl, clientfd);
     }
 
-    HTTP_Connection *conn = calloc(1, sizeof(HTTP_Connection));
+    HTTP_Connection *conn = HTTP_Manager_Acquire_Connection(context);
     if (!conn)
     {
-        HTTP_PRINT_ERROR(stderr, "calloc");
         if (ssl)
             SSL_free(ssl);
         close_socket(clientfd);
@@ -37,17 +119,19 @@ HTTP_Connection *HTTP_Connection_Get(HTTP_Connection_Manager *context)
 
     conn->client = clientfd;
     conn->ssl = ssl;
+    conn->state = ssl ? HTTP_STATE_HANDSHAKE : HTTP_STATE_READ_HEADER;
+    conn->accepted_at = HTTP_Now();
     conn->run = &context->run;
+    conn->modules = context->modules; // Definido antes da thread iniciar para evitar corrida
+    conn->router = context->router;
 
     if (pthread_create(&conn->thread, NULL, (void *(*)(void *))HTTP_HandleConnection, (void *)conn) != 0)
     {
         HTTP_PRINT_ERROR(stderr, "pthread create");
-        free(conn);
-        if (ssl)
-            SSL_free(ssl);
-        close_socket(clientfd);
+        HTTP_Connection_Destroy(&conn);
         return NULL;
     }
+    conn->threaded = true;
 
     return conn;
 }
@@ -58,6 +142,8 @@ void HTTP_Connection_Destroy(HTTP_Connection **conn)
     if (!conn || !(*conn))
         return;
 
+    HTTP_Timer_Cancel(&(*conn)->timer);
+
     if ((*conn)->ssl)
     {
         SSL_shutdown((*conn)->ssl);
@@ -69,11 +155,102 @@ void HTTP_Connection_Destroy(HTTP_Connection **conn)
         close_socket((*conn)->client);
     }
 
-    pthread_join((*conn)->thread, NULL);
-    free(*conn);
+    if ((*conn)->threaded)
+        pthread_join((*conn)->thread, NULL);
+
+    HTTP_Output_Clear(*conn);
+
+    // Devolve o objeto ao pool do gerenciador, preservando buffers e arena para reuso
+    HTTP_Connection_Manager *context = (*conn)->manager;
+    if (context)
+    {
+        char *buffer = (*conn)->buffer;
+        size_t buffer_size = (*conn)->buffer_size;
+        char *output = (*conn)->output;
+        size_t output_size = (*conn)->output_size;
+        HTTP_Arena arena = (*conn)->arena;
+        HTTP_Arena_Reset(&arena);
+        memset(*conn, 0, sizeof(HTTP_Connection));
+        (*conn)->buffer = buffer;
+        (*conn)->buffer_size = buffer_size;
+        (*conn)->output = output;
+        (*conn)->output_size = output_size;
+        (*conn)->arena = arena;
+        (*conn)->next = context->free_list;
+        context->free_list = *conn;
+    }
+    else
+    {
+        free((*conn)->buffer);
+        free((*conn)->output);
+        HTTP_Arena_Destroy(&(*conn)->arena);
+        free(*conn);
+    }
     *conn = NULL;
 }
 
+// --- Inicia o prazo de uma etapa da conexão conforme os limites do gerenciador ---
+void HTTP_Connection_Deadline(HTTP_Connection *conn, HTTP_Timeout timeout)
+{
+    int ms = conn->manager ? conn->manager->timeouts[timeout] : 0;
+    conn->timeout = timeout;
+    conn->deadline = ms > 0 ? HTTP_Now() + (uint64_t)ms * 1000000ull : 0;
+}
+
+// --- Prepara o pool de objetos e o eventfd de notificação do gerenciador ---
+bool HTTP_Manager_Init(HTTP_Connection_Manager *context)
+{
+    if (!context)
+        return false;
+
+    context->events = -1;
+    context->free_list = NULL;
+    context->slabs = NULL;
+    atomic_init(&context->completed, NULL);
+    HTTP_Timer_Init(&context->timers, HTTP_Now());
+
+#ifdef __linux__
+    context->notify = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (context->notify < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "eventfd");
+        return false;
+    }
+#else
+    context->notify = -1; // Sem eventfd: o gerenciador recolhe no timeout do poll
+#endif
+    return true;
+}
+
+// --- Obtém um objeto de conexão zerado do pool (aloca um novo bloco se vazio) ---
+HTTP_Connection *HTTP_Manager_Acquire_Connection(HTTP_Connection_Manager *context)
+{
+    if (!context->free_list)
+    {
+        HTTP_Connection_Slab *slab = calloc(1, sizeof(HTTP_Connection_Slab));
+        if (!slab)
+        {
+            HTTP_PRINT_ERROR(stderr, "calloc");
+            return NULL;
+        }
+        slab->next = context->slabs;
+        context->slabs = slab;
+
+        for (size_t i = 0; i < HTTP_CONNECTION_SLAB; i++)
+        {
+            slab->items[i].next = context->free_list;
+            context->free_list = &slab->items[i];
+        }
+    }
+
+    HTTP_Connection *conn = context->free_list;
+    context->free_list = conn->next;
+    conn->next = NULL;
+    conn->manager = context;
+    conn->timer.owner = conn;
+    return conn;
+}
+
 // --- Adiciona conexão na lista do gerenciador ---
 bool HTTP_Manager_Push_Connection(HTTP_Connection_Manager *context, HTTP_Connection *push)
 {
@@ -131,20 +308,77 @@ bool HTTP_Manager_Remove_Connection(HTTP_Connection_Manager *context, HTTP_Conne
     return false;
 }
 
-// --- Varre conexões e remove as que já terminaram ---
+// --- Devolve ao gerenciador uma conexão tratada por outra thread (lock-free) ---
+// Após a chamada a thread não deve mais tocar na conexão
+void HTTP_Manager_Complete(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    HTTP_Connection *head = atomic_load_explicit(&context->completed, memory_order_relaxed);
+    do
+    {
+        conn->completed = head;
+    } while (!atomic_compare_exchange_weak_explicit(&context->completed, &head, conn,
+                                                    memory_order_release, memory_order_relaxed));
+
+    // Só quem encontra a pilha vazia acorda o gerenciador; os demais já serão vistos
+#ifdef __linux__
+    if (!head && context->notify >= 0)
+        eventfd_write(context->notify, 1);
+#endif
+}
+
+// --- Retira de uma vez todas as conexões devolvidas (encadeadas por completed) ---
+HTTP_Connection *HTTP_Manager_Collect(HTTP_Connection_Manager *context)
+{
+#ifdef __linux__
+    eventfd_t value;
+    if (context->notify >= 0)
+        eventfd_read(context->notify, &value);
+#endif
+
+    return atomic_exchange_explicit(&context->completed, NULL, memory_order_acquire);
+}
+
+// --- Remove as conexões concluídas: custo proporcional apenas às que terminaram ---
 void HTTP_Manager_Connections(HTTP_Connection_Manager *context)
 {
-    HTTP_Connection *conn = context->base;
+    HTTP_Connection *conn = HTTP_Manager_Collect(context);
 
     while (conn != NULL)
     {
-        HTTP_Connection *next = conn->next;
+        HTTP_Connection *next = conn->completed;
+        HTTP_Manager_Remove_Connection(context, conn, -1, conn);
+        conn = next;
+    }
+}
 
-        if (conn->ended)
-        {
-            HTTP_Manager_Remove_Connection(context, conn, -1, conn);
-        }
+// --- Encerra as conexões, libera o pool e o eventfd do gerenciador ---
+void HTTP_Manager_Destroy(HTTP_Connection_Manager *context)
+{
+    if (!context)
+        return;
 
-        conn = next;
+    HTTP_Manager_Connections(context);
+    while (context->base)
+        HTTP_Manager_Remove_Connection(context, context->base, -1, context->base);
+
+    for (HTTP_Connection *conn = context->free_list; conn; conn = conn->next)
+    {
+        free(conn->buffer);
+        free(conn->output);
+        HTTP_Arena_Destroy(&conn->arena);
+    }
+    context->free_list = NULL;
+
+    while (context->slabs)
+    {
+        HTTP_Connection_Slab *next = context->slabs->next;
+        free(context->slabs);
+        context->slabs = next;
+    }
+
+    if (context->notify >= 0)
+    {
+        close(context->notify);
+        context->notify = -1;
     }
 }
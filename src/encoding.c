@@ -0,0 +1,105 @@
+#include <nero_http.h>
+#include <string.h>
+
+// --- Codificações de conteúdo conhecidas (RFC 9110, seção 8.4.1) ---
+static const char *encoding_names[HTTP_ENCODING_COUNT] = {
+    [HTTP_ENCODING_IDENTITY] = "identity",
+    [HTTP_ENCODING_GZIP] = "gzip",
+    [HTTP_ENCODING_BR] = "br",
+};
+
+const char *HTTP_Encoding_Name(HTTP_Encoding encoding)
+{
+    return encoding_names[encoding];
+}
+
+static bool encoding_token(const char *token, size_t length, const char *name)
+{
+    return strlen(name) == length && strncasecmp(token, name, length) == 0;
+}
+
+// "q=0.8" em milésimos; valores fora da gramática contam como 1
+static uint16_t encoding_quality(const char *value, const char *end)
+{
+    if (value >= end || (*value != '0' && *value != '1'))
+        return HTTP_QUALITY_MAX;
+
+    uint16_t quality = (uint16_t)(*value++ - '0') * 1000;
+    if (value < end && *value == '.')
+    {
+        uint16_t scale = 100;
+        for (value++; value < end && scale && *value >= '0' && *value <= '9'; value++, scale /= 10)
+            quality += (uint16_t)(*value - '0') * scale;
+    }
+    return quality > HTTP_QUALITY_MAX ? HTTP_QUALITY_MAX : quality;
+}
+
+// --- Peso de cada codificação em Accept-Encoding, em milésimos (0 = não aceita) ---
+// Sem o campo só identity é aceita; "*" vale para as não listadas, e identity
+// continua aceita a menos que seja recusada explicitamente (ou por "*;q=0")
+void HTTP_Accept_Encoding(HTTP_Header *header, uint16_t quality[HTTP_ENCODING_COUNT])
+{
+    for (int i = 0; i < HTTP_ENCODING_COUNT; i++)
+        quality[i] = 0;
+    quality[HTTP_ENCODING_IDENTITY] = HTTP_QUALITY_MAX;
+
+    const char *value = header ? HTTP_Header_Get(header, HTTP_HEADER_ACCEPT_ENCODING) : NULL;
+    if (!value)
+        return;
+
+    bool listed[HTTP_ENCODING_COUNT] = {false};
+    int star = -1;
+    for (const char *cursor = value; *cursor;)
+    {
+        const char *end = strchr(cursor, ',');
+        if (!end)
+            end = cursor + strlen(cursor);
+
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t'))
+            cursor++;
+        const char *token = cursor;
+        while (cursor < end && *cursor != ';' && *cursor != ' ' && *cursor != '\t')
+            cursor++;
+        size_t length = (size_t)(cursor - token);
+
+        uint16_t weight = HTTP_QUALITY_MAX;
+        for (const char *param = cursor; param < end; param++)
+        {
+            if ((*param == 'q' || *param == 'Q') && param + 1 < end && param[1] == '=' &&
+                (param == cursor || param[-1] == ';' || param[-1] == ' ' || param[-1] == '\t'))
+            {
+                weight = encoding_quality(param + 2, end);
+                break;
+            }
+        }
+
+        if (encoding_token(token, length, "*"))
+            star = weight;
+        else if (encoding_token(token, length, "x-gzip"))
+        {
+            quality[HTTP_ENCODING_GZIP] = weight;
+            listed[HTTP_ENCODING_GZIP] = true;
+        }
+        else
+        {
+            for (int i = 0; i < HTTP_ENCODING_COUNT; i++)
+            {
+                if (encoding_token(token, length, encoding_names[i]))
+                {
+                    quality[i] = weight;
+                    listed[i] = true;
+                }
+            }
+        }
+
+        cursor = *end ? end + 1 : end;
+    }
+
+    if (star < 0)
+        return;
+    for (int i = 0; i < HTTP_ENCODING_COUNT; i++)
+    {
+        if (!listed[i])
+            quality[i] = (uint16_t)star;
+    }
+}
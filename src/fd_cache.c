@@ -0,0 +1,445 @@
+#include <nero_http.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#define FD_CACHE_SHARDS 16      // Partições, cada uma com trava própria
+#define FD_CACHE_BUCKETS 256    // Posições da tabela de cada partição
+#define FD_CACHE_ENTRIES_PER_FD 4 // Entradas sem descritor (diretórios, 404) por fd do limite
+
+// --- Descritores abertos e metadados (stat) por caminho, inclusive de caminhos inexistentes ---
+// Só vale enquanto o observador inotify está ativo: ele é quem invalida as entradas.
+// O descritor é compartilhado por todas as threads, que leem com offset explícito
+// (pread, sendfile); a entrada só o fecha quando sai da tabela e o último handle é solto
+typedef struct Fd_Entry
+{
+    struct Fd_Entry *chain; // Próxima na mesma posição da tabela
+    struct Fd_Entry *newer; // Ordem de uso (LRU)
+    struct Fd_Entry *older;
+    uint64_t hash;
+    unsigned int refs; // Tabela + handles abertos (sob a trava da partição)
+    bool exists;       // Falso: entrada negativa (o caminho não existe)
+    int fd;            // -1 enquanto ninguém abriu (diretórios, consultas só de stat)
+    struct stat st;
+    char path[];
+} Fd_Entry;
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    Fd_Entry *table[FD_CACHE_BUCKETS];
+    Fd_Entry *newest;
+    Fd_Entry *oldest;
+    size_t count;
+    size_t fds;
+} Fd_Cache_Shard;
+
+static Fd_Cache_Shard fd_cache[FD_CACHE_SHARDS];
+static size_t fd_shard_limit; // Descritores por partição (0 = desativado)
+
+// Cada invalidação avança a geração: quem consultou o disco antes dela não insere o resultado
+static atomic_uint_fast64_t fd_generation;
+
+static atomic_uint_fast64_t fd_hits;
+static atomic_uint_fast64_t fd_misses;
+static atomic_uint_fast64_t fd_negative;
+
+static uint64_t fd_hash(const char *path)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (; *path; path++)
+    {
+        hash ^= (unsigned char)*path;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static Fd_Cache_Shard *fd_shard(uint64_t hash)
+{
+    return &fd_cache[hash % FD_CACHE_SHARDS];
+}
+
+static Fd_Entry **fd_slot(Fd_Cache_Shard *shard, uint64_t hash)
+{
+    return &shard->table[(hash / FD_CACHE_SHARDS) % FD_CACHE_BUCKETS];
+}
+
+static bool fd_enabled(void)
+{
+    return fd_shard_limit && HTTP_File_Watch_Active();
+}
+
+static void fd_put(Fd_Entry *entry)
+{
+    if (--entry->refs)
+        return;
+    if (entry->fd >= 0)
+        close(entry->fd);
+    free(entry);
+}
+
+// Descritores ainda em uso saem da contagem aqui e fecham com o último handle
+static void fd_unlink(Fd_Cache_Shard *shard, Fd_Entry *entry)
+{
+    Fd_Entry **slot = fd_slot(shard, entry->hash);
+    while (*slot != entry)
+        slot = &(*slot)->chain;
+    *slot = entry->chain;
+
+    if (entry->newer)
+        entry->newer->older = entry->older;
+    else
+        shard->newest = entry->older;
+    if (entry->older)
+        entry->older->newer = entry->newer;
+    else
+        shard->oldest = entry->newer;
+
+    shard->count--;
+    if (entry->fd >= 0)
+        shard->fds--;
+    fd_put(entry);
+}
+
+static void fd_touch(Fd_Cache_Shard *shard, Fd_Entry *entry)
+{
+    if (shard->newest == entry)
+        return;
+
+    entry->newer->older = entry->older;
+    if (entry->older)
+        entry->older->newer = entry->newer;
+    else
+        shard->oldest = entry->newer;
+
+    entry->older = shard->newest;
+    entry->newer = NULL;
+    shard->newest->newer = entry;
+    shard->newest = entry;
+}
+
+static Fd_Entry *fd_find(Fd_Cache_Shard *shard, uint64_t hash, const char *path)
+{
+    for (Fd_Entry *entry = *fd_slot(shard, hash); entry; entry = entry->chain)
+    {
+        if (entry->hash == hash && strcmp(entry->path, path) == 0)
+            return entry;
+    }
+    return NULL;
+}
+
+// --- Nova entrada (sob a trava); descarta as menos usadas para respeitar os limites ---
+static Fd_Entry *fd_insert(Fd_Cache_Shard *shard, uint64_t hash, const char *path,
+                           bool exists, const struct stat *st, int fd)
+{
+    size_t length = strlen(path);
+    Fd_Entry *entry = malloc(sizeof(Fd_Entry) + length + 1);
+    if (!entry)
+        return NULL;
+
+    while (shard->oldest && (shard->count >= fd_shard_limit * FD_CACHE_ENTRIES_PER_FD ||
+                             (fd >= 0 && shard->fds >= fd_shard_limit)))
+        fd_unlink(shard, shard->oldest);
+
+    entry->hash = hash;
+    entry->refs = 1;
+    entry->exists = exists;
+    entry->fd = fd;
+    if (st)
+        entry->st = *st;
+    memcpy(entry->path, path, length + 1);
+
+    Fd_Entry **slot = fd_slot(shard, hash);
+    entry->chain = *slot;
+    *slot = entry;
+    entry->newer = NULL;
+    entry->older = shard->newest;
+    if (shard->newest)
+        shard->newest->newer = entry;
+    else
+        shard->oldest = entry;
+    shard->newest = entry;
+    shard->count++;
+    if (fd >= 0)
+        shard->fds++;
+    return entry;
+}
+
+// Só respostas definitivas do disco viram entradas (ENOENT/ENOTDIR são negativas)
+static void fd_remember(const char *path, uint64_t hash, uint64_t generation, bool exists, const struct stat *st)
+{
+    Fd_Cache_Shard *shard = fd_shard(hash);
+    pthread_mutex_lock(&shard->lock);
+    if (atomic_load(&fd_generation) == generation && !fd_find(shard, hash, path))
+        fd_insert(shard, hash, path, exists, st, -1);
+    pthread_mutex_unlock(&shard->lock);
+}
+
+void HTTP_Fd_Cache_Setup(size_t fds)
+{
+    // Sobra espaço para as conexões: no máximo um quarto do limite de descritores do processo
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY &&
+        fds > (size_t)limit.rlim_cur / 4)
+        fds = (size_t)limit.rlim_cur / 4;
+
+    for (size_t i = 0; i < FD_CACHE_SHARDS; i++)
+        pthread_mutex_init(&fd_cache[i].lock, NULL);
+    fd_shard_limit = (fds + FD_CACHE_SHARDS - 1) / FD_CACHE_SHARDS;
+}
+
+// --- stat() consultando o cache; falso (errno definido) quando o caminho não existe ---
+bool HTTP_Fd_Cache_Stat(const char *path, struct stat *st)
+{
+    if (!fd_enabled())
+        return stat(path, st) == 0;
+
+    uint64_t hash = fd_hash(path);
+    Fd_Cache_Shard *shard = fd_shard(hash);
+    pthread_mutex_lock(&shard->lock);
+    Fd_Entry *entry = fd_find(shard, hash, path);
+    if (entry)
+    {
+        bool exists = entry->exists;
+        if (exists)
+            *st = entry->st;
+        fd_touch(shard, entry);
+        pthread_mutex_unlock(&shard->lock);
+
+        atomic_fetch_add_explicit(exists ? &fd_hits : &fd_negative, 1, memory_order_relaxed);
+        if (!exists)
+            errno = ENOENT;
+        return exists;
+    }
+    uint64_t generation = atomic_load(&fd_generation);
+    pthread_mutex_unlock(&shard->lock);
+
+    atomic_fetch_add_explicit(&fd_misses, 1, memory_order_relaxed);
+    bool exists = stat(path, st) == 0;
+    int error = errno;
+    if (exists || error == ENOENT || error == ENOTDIR)
+        fd_remember(path, hash, generation, exists, st);
+    errno = error;
+    return exists;
+}
+
+// --- Descritor do arquivo (compartilhado) e seus metadados; -1 (errno definido) em falha ---
+int HTTP_Fd_Cache_Open(const char *path, struct stat *st, HTTP_Fd_Handle *handle)
+{
+    handle->entry = NULL;
+    handle->fd = -1;
+
+    if (!fd_enabled())
+    {
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return -1;
+        if (fstat(fd, st) < 0)
+        {
+            close(fd);
+            return -1;
+        }
+        handle->fd = fd;
+        return fd;
+    }
+
+    uint64_t hash = fd_hash(path);
+    Fd_Cache_Shard *shard = fd_shard(hash);
+    pthread_mutex_lock(&shard->lock);
+    Fd_Entry *entry = fd_find(shard, hash, path);
+    if (entry && (!entry->exists || entry->fd >= 0))
+    {
+        bool exists = entry->exists;
+        if (exists)
+        {
+            entry->refs++;
+            *st = entry->st;
+            handle->entry = entry;
+            handle->fd = entry->fd;
+        }
+        fd_touch(shard, entry);
+        pthread_mutex_unlock(&shard->lock);
+
+        atomic_fetch_add_explicit(exists ? &fd_hits : &fd_negative, 1, memory_order_relaxed);
+        if (!exists)
+            errno = ENOENT;
+        return handle->fd;
+    }
+    uint64_t generation = atomic_load(&fd_generation);
+    pthread_mutex_unlock(&shard->lock);
+
+    atomic_fetch_add_explicit(&fd_misses, 1, memory_order_relaxed);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        int error = errno;
+        if (error == ENOENT || error == ENOTDIR)
+            fd_remember(path, hash, generation, false, NULL);
+        errno = error;
+        return -1;
+    }
+    if (fstat(fd, st) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    pthread_mutex_lock(&shard->lock);
+    if (atomic_load(&fd_generation) == generation)
+    {
+        entry = fd_find(shard, hash, path);
+        if (entry && entry->fd >= 0)
+        {
+            // Outra thread abriu o mesmo arquivo primeiro
+            close(fd);
+            fd = entry->fd;
+            *st = entry->st;
+        }
+        else
+        {
+            if (entry)
+                fd_unlink(shard, entry);
+            entry = fd_insert(shard, hash, path, true, st, fd);
+        }
+        if (entry)
+        {
+            entry->refs++;
+            handle->entry = entry;
+        }
+    }
+    pthread_mutex_unlock(&shard->lock);
+
+    handle->fd = fd;
+    return fd;
+}
+
+void HTTP_Fd_Cache_Release(HTTP_Fd_Handle *handle)
+{
+    Fd_Entry *entry = handle->entry;
+    if (entry)
+    {
+        Fd_Cache_Shard *shard = fd_shard(entry->hash);
+        pthread_mutex_lock(&shard->lock);
+        fd_put(entry);
+        pthread_mutex_unlock(&shard->lock);
+    }
+    else if (handle->fd >= 0)
+        close(handle->fd);
+
+    handle->entry = NULL;
+    handle->fd = -1;
+}
+
+// --- Remove o caminho (tree: também tudo abaixo dele; NULL: tudo) ---
+void HTTP_Fd_Cache_Invalidate(const char *path, bool tree)
+{
+    if (!fd_shard_limit)
+        return;
+    atomic_fetch_add(&fd_generation, 1);
+
+    if (path && !tree)
+    {
+        uint64_t hash = fd_hash(path);
+        Fd_Cache_Shard *shard = fd_shard(hash);
+        pthread_mutex_lock(&shard->lock);
+        Fd_Entry *entry = fd_find(shard, hash, path);
+        if (entry)
+            fd_unlink(shard, entry);
+        pthread_mutex_unlock(&shard->lock);
+        return;
+    }
+
+    size_t length = path ? strlen(path) : 0;
+    for (size_t i = 0; i < FD_CACHE_SHARDS; i++)
+    {
+        Fd_Cache_Shard *shard = &fd_cache[i];
+        pthread_mutex_lock(&shard->lock);
+        for (Fd_Entry *entry = shard->oldest, *newer; entry; entry = newer)
+        {
+            newer = entry->newer;
+            if (!path || (strncmp(entry->path, path, length) == 0 &&
+                          (entry->path[length] == '\0' || entry->path[length] == '/')))
+                fd_unlink(shard, entry);
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+void HTTP_Fd_Cache_Stats_Print(FILE *fd)
+{
+    if (!fd_shard_limit)
+        return;
+
+    size_t count = 0, fds = 0;
+    for (size_t i = 0; i < FD_CACHE_SHARDS; i++)
+    {
+        pthread_mutex_lock(&fd_cache[i].lock);
+        count += fd_cache[i].count;
+        fds += fd_cache[i].fds;
+        pthread_mutex_unlock(&fd_cache[i].lock);
+    }
+
+    fprintf(fd, "Cache de descritores: %zu entradas, %zu fds abertos (limite %zu), %llu acertos, %llu negativos, %llu faltas%s\n",
+            count, fds, fd_shard_limit * FD_CACHE_SHARDS,
+            (unsigned long long)atomic_load(&fd_hits),
+            (unsigned long long)atomic_load(&fd_negative),
+            (unsigned long long)atomic_load(&fd_misses),
+            HTTP_File_Watch_Active() ? "" : " (inotify inativo: desativado)");
+}
+
+// Handles ainda abertos fecham seus descritores ao serem soltos
+void HTTP_Fd_Cache_Cleanup(void)
+{
+    HTTP_Fd_Cache_Invalidate(NULL, true);
+}
+
+#else
+
+void HTTP_Fd_Cache_Setup(size_t fds)
+{
+    (void)fds;
+}
+
+bool HTTP_Fd_Cache_Stat(const char *path, struct stat *st)
+{
+    return stat(path, st) == 0;
+}
+
+int HTTP_Fd_Cache_Open(const char *path, struct stat *st, HTTP_Fd_Handle *handle)
+{
+    (void)path;
+    (void)st;
+    handle->entry = NULL;
+    handle->fd = -1;
+    return -1;
+}
+
+void HTTP_Fd_Cache_Release(HTTP_Fd_Handle *handle)
+{
+    handle->entry = NULL;
+    handle->fd = -1;
+}
+
+void HTTP_Fd_Cache_Invalidate(const char *path, bool tree)
+{
+    (void)path;
+    (void)tree;
+}
+
+void HTTP_Fd_Cache_Stats_Print(FILE *fd)
+{
+    (void)fd;
+}
+
+void HTTP_Fd_Cache_Cleanup(void)
+{
+}
+
+#endif
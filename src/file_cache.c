@@ -0,0 +1,730 @@
+#include <nero_http.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sched.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FILE_CACHE_BUCKETS 4096    // Posições da tabela (potência de dois)
+#define FILE_CACHE_FIELDS_MAX 224  // Content-Length, Content-Type, Content-Encoding e Vary pré-montados
+
+// --- Cache de arquivos em memória compartilhado por todos os laços e threads ---
+// Leitores não travam: cada posição da tabela conta quem está percorrendo sua cadeia
+// (em dois contadores alternados por época), e quem remove uma entrada espera esses
+// leitores saírem antes de soltar a referência da tabela. Inserção e descarte passam
+// por uma única trava e seguem o CLOCK-Pro: entradas quentes, frias e nós de teste
+// (sem dados) que lembram arquivos frios descartados há pouco
+typedef enum
+{
+    FILE_CACHE_COLD,
+    FILE_CACHE_HOT
+} File_Cache_State;
+
+typedef struct
+{
+    uint64_t device;
+    uint64_t inode;
+    uint64_t size;
+    int64_t mtime;
+    long mtime_ns;
+} File_Identity;
+
+struct HTTP_File_Entry
+{
+    _Atomic(HTTP_File_Entry *) chain; // Próxima na mesma posição da tabela (percorrida sem trava)
+    HTTP_File_Entry *prev;            // Anel do CLOCK (apenas sob a trava)
+    HTTP_File_Entry *next;
+    uint64_t hash;
+    bool resident;          // Imutável: nós de teste não têm dados e os leitores os ignoram
+    File_Cache_State state; // Apenas sob a trava
+    bool test;              // Fria em período de teste
+    atomic_uint refs;       // Tabela + leitores com HTTP_File_Hit
+    atomic_bool referenced; // Bit do CLOCK, marcado a cada acerto
+    atomic_uint_fast64_t checked_at;
+    File_Identity file;
+    File_Identity requested; // Caminho pedido, quando difere da origem (diretório, variante comprimida)
+    char *data;
+    uint64_t size;
+    size_t charge; // Bytes contados no orçamento
+    const char *key;
+    const char *source;
+    const char *type;
+    HTTP_Encoding encoding; // Parte da chave, com o caminho
+    bool vary;
+    size_t fields_length;
+    char fields[FILE_CACHE_FIELDS_MAX];
+    char strings[];
+};
+
+typedef struct
+{
+    _Atomic(HTTP_File_Entry *) head;
+    atomic_uint epoch;
+    atomic_uint readers[2];
+} File_Cache_Bucket;
+
+static File_Cache_Bucket file_buckets[FILE_CACHE_BUCKETS];
+static pthread_mutex_t file_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t file_budget; // Definido antes das threads; 0 = desativado
+static uint64_t file_max;
+static uint64_t compress_max; // Limite próprio do gzip feito pelo servidor (entrada e saída)
+
+// Estado do CLOCK-Pro, protegido por file_lock
+static HTTP_File_Entry *hand_hot;  // Rebaixa quentes não usadas e encerra testes
+static HTTP_File_Entry *hand_cold; // Descarta frias não usadas
+static HTTP_File_Entry *hand_test; // Encerra testes quando há nós de teste demais
+static size_t bytes_hot;
+static size_t bytes_cold;
+static size_t cold_target; // Parte do orçamento reservada às frias, ajustada pelos testes
+static size_t count_resident;
+static size_t count_test;
+
+// Cada invalidação avança a geração: quem leu o arquivo antes dela não insere o resultado
+static atomic_uint_fast64_t file_generation;
+
+static atomic_uint_fast64_t file_hits;
+static atomic_uint_fast64_t file_misses;
+static atomic_uint_fast64_t file_stale;
+static atomic_uint_fast64_t file_evicted;
+
+static uint64_t file_hash(const char *key, HTTP_Encoding encoding)
+{
+    uint64_t hash = 14695981039346656037ull ^ (uint64_t)encoding;
+    for (; *key; key++)
+    {
+        hash ^= (unsigned char)*key;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static File_Cache_Bucket *file_bucket(uint64_t hash)
+{
+    return &file_buckets[hash & (FILE_CACHE_BUCKETS - 1)];
+}
+
+static void file_identity(const struct stat *st, File_Identity *id)
+{
+    id->device = (uint64_t)st->st_dev;
+    id->inode = (uint64_t)st->st_ino;
+    id->size = (uint64_t)st->st_size;
+    id->mtime = (int64_t)st->st_mtime;
+#ifdef __linux__
+    id->mtime_ns = st->st_mtim.tv_nsec;
+#else
+    id->mtime_ns = 0;
+#endif
+}
+
+static bool file_unchanged(const char *path, const File_Identity *expected)
+{
+    struct stat st;
+    if (stat(path, &st) < 0)
+        return false;
+
+    File_Identity id;
+    file_identity(&st, &id);
+    return id.device == expected->device && id.inode == expected->inode &&
+           id.size == expected->size && id.mtime == expected->mtime &&
+           id.mtime_ns == expected->mtime_ns;
+}
+
+static void file_unref(HTTP_File_Entry *entry)
+{
+    if (atomic_fetch_sub_explicit(&entry->refs, 1, memory_order_acq_rel) == 1)
+    {
+        free(entry->data);
+        free(entry);
+    }
+}
+
+// --- Anel do CLOCK: a cabeça fica logo atrás do ponteiro quente ---
+static void ring_insert(HTTP_File_Entry *entry)
+{
+    if (!hand_hot)
+    {
+        entry->prev = entry->next = entry;
+        hand_hot = hand_cold = hand_test = entry;
+        return;
+    }
+    entry->next = hand_hot;
+    entry->prev = hand_hot->prev;
+    hand_hot->prev->next = entry;
+    hand_hot->prev = entry;
+}
+
+static void ring_remove(HTTP_File_Entry *entry)
+{
+    HTTP_File_Entry *next = entry->next == entry ? NULL : entry->next;
+    if (hand_hot == entry)
+        hand_hot = next;
+    if (hand_cold == entry)
+        hand_cold = next;
+    if (hand_test == entry)
+        hand_test = next;
+    entry->prev->next = entry->next;
+    entry->next->prev = entry->prev;
+}
+
+static bool file_same(const HTTP_File_Entry *entry, uint64_t hash, const char *key, HTTP_Encoding encoding)
+{
+    return entry->hash == hash && entry->encoding == encoding && strcmp(entry->key, key) == 0;
+}
+
+static HTTP_File_Entry *file_find(uint64_t hash, const char *key, HTTP_Encoding encoding)
+{
+    HTTP_File_Entry *entry = atomic_load_explicit(&file_bucket(hash)->head, memory_order_relaxed);
+    while (entry && !file_same(entry, hash, key, encoding))
+        entry = atomic_load_explicit(&entry->chain, memory_order_relaxed);
+    return entry;
+}
+
+static void file_link(HTTP_File_Entry *entry)
+{
+    File_Cache_Bucket *bucket = file_bucket(entry->hash);
+    atomic_store_explicit(&entry->chain, atomic_load_explicit(&bucket->head, memory_order_relaxed),
+                          memory_order_relaxed);
+    atomic_store(&bucket->head, entry); // Publica a entrada já preenchida
+    ring_insert(entry);
+    if (entry->resident)
+    {
+        count_resident++;
+        if (entry->state == FILE_CACHE_HOT)
+            bytes_hot += entry->charge;
+        else
+            bytes_cold += entry->charge;
+    }
+    else
+        count_test++;
+}
+
+// --- Tira a entrada da tabela e do anel; a memória some com a última referência ---
+static void file_remove(HTTP_File_Entry *entry)
+{
+    File_Cache_Bucket *bucket = file_bucket(entry->hash);
+    _Atomic(HTTP_File_Entry *) *link = &bucket->head;
+    HTTP_File_Entry *current;
+    while ((current = atomic_load_explicit(link, memory_order_relaxed)) != entry)
+        link = &current->chain;
+    atomic_store(link, atomic_load_explicit(&entry->chain, memory_order_relaxed));
+
+    // Quem já percorria esta cadeia pode estar sobre a entrada: a troca de época
+    // manda os novos leitores para o outro contador, e os dois se esvaziam em sequência
+    for (int i = 0; i < 2; i++)
+    {
+        unsigned int old = atomic_fetch_add(&bucket->epoch, 1) & 1;
+        while (atomic_load(&bucket->readers[old]) != 0)
+            sched_yield();
+    }
+
+    ring_remove(entry);
+    if (entry->resident)
+    {
+        count_resident--;
+        if (entry->state == FILE_CACHE_HOT)
+            bytes_hot -= entry->charge;
+        else
+            bytes_cold -= entry->charge;
+    }
+    else
+        count_test--;
+    file_unref(entry);
+}
+
+// --- Ajuste adaptativo da parte fria (entre 1/16 e 15/16 do orçamento) ---
+static void cold_target_grow(size_t charge)
+{
+    size_t max = file_budget - file_budget / 16;
+    cold_target = max - cold_target > charge ? cold_target + charge : max;
+}
+
+static void cold_target_shrink(size_t charge)
+{
+    size_t min = file_budget / 16;
+    cold_target = cold_target - min > charge ? cold_target - charge : min;
+}
+
+// --- Ponteiro de teste: encerra os testes mais antigos quando há nós de teste demais ---
+static void file_hand_test(void)
+{
+    while (count_test > count_resident && hand_test)
+    {
+        HTTP_File_Entry *entry = hand_test;
+        hand_test = entry->next;
+        if (!entry->resident)
+        {
+            cold_target_shrink(entry->charge);
+            file_remove(entry);
+        }
+        else if (entry->state == FILE_CACHE_COLD && entry->test)
+        {
+            entry->test = false;
+            cold_target_shrink(entry->charge);
+        }
+    }
+}
+
+// --- Ponteiro quente: rebaixa a primeira quente sem uso desde a última volta ---
+static void file_hand_hot(void)
+{
+    for (size_t steps = count_resident + count_test; steps > 0 && hand_hot; steps--)
+    {
+        HTTP_File_Entry *entry = hand_hot;
+        hand_hot = entry->next;
+
+        if (!entry->resident)
+        {
+            cold_target_shrink(entry->charge);
+            file_remove(entry);
+            continue;
+        }
+        if (entry->state == FILE_CACHE_COLD)
+        {
+            if (entry->test)
+            {
+                entry->test = false;
+                cold_target_shrink(entry->charge);
+            }
+            continue;
+        }
+        if (atomic_exchange_explicit(&entry->referenced, false, memory_order_relaxed))
+            continue;
+
+        entry->state = FILE_CACHE_COLD;
+        bytes_hot -= entry->charge;
+        bytes_cold += entry->charge;
+        return;
+    }
+}
+
+// Novo nó de teste no lugar de uma fria descartada durante o teste
+static void file_add_test(const HTTP_File_Entry *from)
+{
+    size_t key_length = strlen(from->key);
+    HTTP_File_Entry *entry = calloc(1, sizeof(HTTP_File_Entry) + key_length + 1);
+    if (!entry)
+        return;
+
+    memcpy(entry->strings, from->key, key_length + 1);
+    entry->key = entry->strings;
+    entry->hash = from->hash;
+    entry->encoding = from->encoding;
+    entry->charge = from->charge;
+    atomic_init(&entry->refs, 1);
+    file_link(entry);
+}
+
+// --- Ponteiro frio: uma fria usada ganha teste (ou sobe a quente), uma sem uso sai ---
+static void file_hand_cold(void)
+{
+    HTTP_File_Entry *entry = hand_cold;
+    while (!entry->resident || entry->state != FILE_CACHE_COLD)
+        entry = entry->next;
+    hand_cold = entry->next;
+
+    if (atomic_exchange_explicit(&entry->referenced, false, memory_order_relaxed))
+    {
+        ring_remove(entry);
+        if (entry->test)
+        {
+            entry->test = false;
+            entry->state = FILE_CACHE_HOT;
+            bytes_cold -= entry->charge;
+            bytes_hot += entry->charge;
+        }
+        else
+            entry->test = true;
+        ring_insert(entry);
+
+        while (bytes_hot > file_budget - cold_target && bytes_hot > 0 && hand_hot)
+        {
+            size_t before = bytes_hot;
+            file_hand_hot();
+            if (bytes_hot == before)
+                break;
+        }
+        return;
+    }
+
+    if (entry->test)
+        file_add_test(entry);
+    atomic_fetch_add_explicit(&file_evicted, 1, memory_order_relaxed);
+    file_remove(entry);
+    file_hand_test();
+}
+
+// --- Abre espaço para charge bytes; falso se nem esvaziando o anel ele cabe ---
+static bool file_reserve(size_t charge)
+{
+    size_t rounds = 4 * (count_resident + count_test) + 8;
+    while (bytes_hot + bytes_cold + charge > file_budget)
+    {
+        if (count_resident == 0 || rounds-- == 0)
+            return false;
+        if (bytes_cold == 0)
+            file_hand_hot();
+        else
+            file_hand_cold();
+    }
+    return true;
+}
+
+void HTTP_File_Cache_Setup(size_t bytes)
+{
+    file_budget = bytes;
+    file_max = bytes / 8 < HTTP_FILE_CACHE_MAX_FILE ? bytes / 8 : HTTP_FILE_CACHE_MAX_FILE;
+    compress_max = bytes / 8 < HTTP_COMPRESS_MAX ? bytes / 8 : HTTP_COMPRESS_MAX;
+    cold_target = bytes / 2;
+}
+
+// --- Com o inotify ativo as entradas são invalidadas por ele; sem ele, stat() a cada intervalo ---
+static bool file_fresh(HTTP_File_Entry *entry)
+{
+    if (HTTP_File_Watch_Active())
+        return true;
+
+    uint64_t now = HTTP_Now();
+    uint64_t checked = atomic_load_explicit(&entry->checked_at, memory_order_relaxed);
+    if (now < checked + (uint64_t)HTTP_FILE_CACHE_VALID_MS * 1000000ull)
+        return true;
+
+    if (!file_unchanged(entry->source, &entry->file) ||
+        (entry->source != entry->key && !file_unchanged(entry->key, &entry->requested)))
+        return false;
+
+    atomic_store_explicit(&entry->checked_at, now, memory_order_relaxed);
+    return true;
+}
+
+static void file_hit(HTTP_File_Entry *entry, HTTP_File_Hit *hit)
+{
+    hit->entry = entry;
+    hit->data = entry->data;
+    hit->size = entry->size;
+    hit->type = entry->type;
+    hit->encoding = entry->encoding;
+    hit->vary = entry->vary;
+    hit->fields = entry->fields;
+    hit->fields_length = entry->fields_length;
+}
+
+bool HTTP_File_Cache_Get(const char *key, HTTP_Encoding encoding, HTTP_File_Hit *hit)
+{
+    hit->entry = NULL;
+    if (!file_budget)
+        return false;
+
+    uint64_t hash = file_hash(key, encoding);
+    File_Cache_Bucket *bucket = file_bucket(hash);
+    unsigned int slot = atomic_load(&bucket->epoch) & 1;
+    atomic_fetch_add(&bucket->readers[slot], 1);
+
+    HTTP_File_Entry *entry = atomic_load(&bucket->head);
+    while (entry && (!entry->resident || !file_same(entry, hash, key, encoding)))
+        entry = atomic_load(&entry->chain);
+    if (entry)
+        atomic_fetch_add_explicit(&entry->refs, 1, memory_order_relaxed);
+
+    atomic_fetch_sub(&bucket->readers[slot], 1);
+
+    if (!entry)
+    {
+        atomic_fetch_add_explicit(&file_misses, 1, memory_order_relaxed);
+        return false;
+    }
+
+    // Só escreve o bit quando ele muda: acertos seguidos não disputam a linha de cache
+    if (!atomic_load_explicit(&entry->referenced, memory_order_relaxed))
+        atomic_store_explicit(&entry->referenced, true, memory_order_relaxed);
+
+    file_hit(entry, hit);
+    if (!file_fresh(entry))
+    {
+        // A próxima inserção com a mesma chave substitui a entrada vencida
+        HTTP_File_Cache_Release(hit);
+        atomic_fetch_add_explicit(&file_stale, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&file_misses, 1, memory_order_relaxed);
+        return false;
+    }
+
+    atomic_fetch_add_explicit(&file_hits, 1, memory_order_relaxed);
+    return true;
+}
+
+// --- Geração a guardar antes de abrir o arquivo que será passado a HTTP_File_Cache_Put ---
+uint64_t HTTP_File_Cache_Generation(void)
+{
+    return atomic_load(&file_generation);
+}
+
+bool HTTP_File_Cache_Put(const HTTP_File_Source *origin, int fd, HTTP_File_Hit *hit)
+{
+    hit->entry = NULL;
+    if (!file_budget)
+        return false;
+
+    const char *key = origin->key;
+    const char *source = origin->source;
+    const char *type = origin->type;
+
+    // O gzip do servidor tem limite próprio, o mesmo na entrada e na saída: um texto aceito
+    // aqui cabe depois de comprimido (salvo se o gzip não reduzir nada), e um maior nem chega
+    // a ser comprimido; o filtro da resposta cuida dele sem um deflate jogado fora antes
+    struct stat st;
+    uint64_t limit = origin->compress ? compress_max : file_max;
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || (uint64_t)st.st_size > limit)
+        return false;
+
+    bool indirect = strcmp(key, source) != 0;
+    size_t key_length = strlen(key);
+    size_t source_length = indirect ? strlen(source) + 1 : 0;
+    size_t type_length = strlen(type);
+    size_t strings = key_length + 1 + source_length + type_length + 1;
+
+    HTTP_File_Entry *entry = calloc(1, sizeof(HTTP_File_Entry) + strings);
+    if (!entry)
+        return false;
+
+    uint64_t size = (uint64_t)st.st_size;
+    entry->data = malloc(size ? (size_t)size : 1);
+    if (!entry->data)
+    {
+        free(entry);
+        return false;
+    }
+
+    // Cópia no heap em vez de mmap: um arquivo truncado no disco não derruba o processo (SIGBUS)
+    for (uint64_t offset = 0; offset < size;)
+    {
+        ssize_t bytes_read = pread(fd, entry->data + offset, (size_t)(size - offset), (off_t)offset);
+        if (bytes_read < 0 && errno == EINTR)
+            continue;
+        if (bytes_read <= 0)
+        {
+            free(entry->data);
+            free(entry);
+            return false;
+        }
+        offset += (uint64_t)bytes_read;
+    }
+
+    if (origin->compress)
+    {
+        char *compressed;
+        size_t compressed_size;
+        bool ok = HTTP_Compress_Data(entry->data, (size_t)size, &compressed, &compressed_size);
+        free(entry->data);
+        if (!ok || compressed_size > compress_max)
+        {
+            if (ok)
+                free(compressed);
+            free(entry);
+            return false;
+        }
+        entry->data = compressed;
+        size = compressed_size;
+    }
+
+    char *strings_end = entry->strings;
+    entry->key = memcpy(strings_end, key, key_length + 1);
+    strings_end += key_length + 1;
+    entry->source = entry->key;
+    if (indirect)
+    {
+        entry->source = memcpy(strings_end, source, source_length);
+        strings_end += source_length;
+    }
+    entry->type = memcpy(strings_end, type, type_length + 1);
+
+    file_identity(&st, &entry->file);
+    struct stat requested_st;
+    bool encoded = origin->encoding != HTTP_ENCODING_IDENTITY;
+    int fields = snprintf(entry->fields, sizeof(entry->fields),
+                          "Content-Length: %llu\r\nContent-Type: %s\r\n%s%s%s%s",
+                          (unsigned long long)size, type,
+                          encoded ? "Content-Encoding: " : "",
+                          encoded ? HTTP_Encoding_Name(origin->encoding) : "",
+                          encoded ? "\r\n" : "",
+                          origin->vary ? "Vary: Accept-Encoding\r\n" : "");
+    if ((indirect && stat(key, &requested_st) < 0) || fields < 0 || (size_t)fields >= sizeof(entry->fields))
+    {
+        free(entry->data);
+        free(entry);
+        return false;
+    }
+    if (indirect)
+        file_identity(&requested_st, &entry->requested);
+
+    entry->fields_length = (size_t)fields;
+    entry->size = size;
+    entry->encoding = origin->encoding;
+    entry->vary = origin->vary;
+    entry->hash = file_hash(key, origin->encoding);
+    entry->resident = true;
+    entry->state = FILE_CACHE_COLD;
+    entry->charge = sizeof(HTTP_File_Entry) + strings + (size_t)size;
+    atomic_init(&entry->refs, 2); // Tabela + quem está inserindo
+    atomic_init(&entry->checked_at, HTTP_Now());
+
+    pthread_mutex_lock(&file_lock);
+    if (atomic_load(&file_generation) != origin->generation)
+    {
+        // Algo mudou no disco desde a abertura: a cópia pode já estar vencida
+        pthread_mutex_unlock(&file_lock);
+        file_hit(entry, hit);
+        atomic_store_explicit(&entry->refs, 1, memory_order_relaxed);
+        return true;
+    }
+
+    HTTP_File_Entry *old = file_find(entry->hash, key, origin->encoding);
+    if (old)
+    {
+        // Voltar durante o teste prova que a parte fria é pequena demais: entra quente
+        if (!old->resident)
+        {
+            cold_target_grow(old->charge);
+            entry->state = FILE_CACHE_HOT;
+        }
+        else
+            entry->state = old->state;
+        file_remove(old);
+    }
+
+    bool room = file_reserve(entry->charge);
+    if (room)
+        file_link(entry);
+    pthread_mutex_unlock(&file_lock);
+
+    if (!room)
+    {
+        free(entry->data);
+        free(entry);
+        return false;
+    }
+
+    file_hit(entry, hit);
+    return true;
+}
+
+void HTTP_File_Cache_Release(HTTP_File_Hit *hit)
+{
+    if (!hit->entry)
+        return;
+    file_unref(hit->entry);
+    hit->entry = NULL;
+}
+
+static bool file_matches(const char *path, size_t length, const char *candidate, bool tree)
+{
+    if (strncmp(candidate, path, length) != 0)
+        return false;
+    return candidate[length] == '\0' || (tree && candidate[length] == '/');
+}
+
+// --- Remove o caminho, como chave ou como origem (tree: também tudo abaixo dele; NULL: tudo) ---
+void HTTP_File_Cache_Invalidate(const char *path, bool tree)
+{
+    if (!file_budget)
+        return;
+    atomic_fetch_add(&file_generation, 1);
+
+    size_t length = path ? strlen(path) : 0;
+    pthread_mutex_lock(&file_lock);
+    HTTP_File_Entry *entry = hand_hot;
+    for (size_t steps = count_resident + count_test; steps > 0 && entry; steps--)
+    {
+        HTTP_File_Entry *next = entry->next;
+        if (!path || file_matches(path, length, entry->key, tree) ||
+            (entry->resident && file_matches(path, length, entry->source, tree)))
+        {
+            file_remove(entry);
+            if (!hand_hot)
+                break;
+        }
+        entry = next;
+    }
+    pthread_mutex_unlock(&file_lock);
+}
+
+void HTTP_File_Cache_Stats_Print(FILE *fd)
+{
+    if (!file_budget)
+        return;
+
+    pthread_mutex_lock(&file_lock);
+    size_t resident = count_resident;
+    size_t hot = bytes_hot;
+    size_t cold = bytes_cold;
+    size_t target = cold_target;
+    pthread_mutex_unlock(&file_lock);
+
+    fprintf(fd, "Cache de arquivos: %zu entradas, %zu bytes (%zu quentes, %zu frios, alvo frio %zu), %llu acertos, %llu faltas (%llu vencidas), %llu descartes\n",
+            resident, hot + cold, hot, cold, target,
+            (unsigned long long)atomic_load(&file_hits),
+            (unsigned long long)atomic_load(&file_misses),
+            (unsigned long long)atomic_load(&file_stale),
+            (unsigned long long)atomic_load(&file_evicted));
+}
+
+// Leitores que ainda seguram entradas as liberam ao soltar a última referência
+void HTTP_File_Cache_Cleanup(void)
+{
+    pthread_mutex_lock(&file_lock);
+    while (hand_hot)
+        file_remove(hand_hot);
+    pthread_mutex_unlock(&file_lock);
+}
+
+#else
+
+void HTTP_File_Cache_Setup(size_t bytes)
+{
+    (void)bytes;
+}
+
+bool HTTP_File_Cache_Get(const char *key, HTTP_Encoding encoding, HTTP_File_Hit *hit)
+{
+    (void)key;
+    (void)encoding;
+    hit->entry = NULL;
+    return false;
+}
+
+uint64_t HTTP_File_Cache_Generation(void)
+{
+    return 0;
+}
+
+bool HTTP_File_Cache_Put(const HTTP_File_Source *origin, int fd, HTTP_File_Hit *hit)
+{
+    (void)origin;
+    (void)fd;
+    hit->entry = NULL;
+    return false;
+}
+
+void HTTP_File_Cache_Release(HTTP_File_Hit *hit)
+{
+    hit->entry = NULL;
+}
+
+void HTTP_File_Cache_Invalidate(const char *path, bool tree)
+{
+    (void)path;
+    (void)tree;
+}
+
+void HTTP_File_Cache_Stats_Print(FILE *fd)
+{
+    (void)fd;
+}
+
+void HTTP_File_Cache_Cleanup(void)
+{
+}
+
+#endif
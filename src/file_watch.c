@@ -0,0 +1,359 @@
+#include <nero_http.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <limits.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FILE_WATCH_MASK (IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | \
+                         IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+
+// --- Observador inotify das raízes servidas ---
+// O inotify não é recursivo: cada diretório abaixo da raiz tem seu watch, e diretórios
+// criados ou movidos para dentro dela ganham o seu ao aparecer. Cada evento invalida o
+// caminho e o diretório pai nos caches de arquivos e de descritores; se algum watch não
+// puder ser criado (limite do sistema), o observador se desativa e os caches voltam a
+// conferir o disco por conta própria
+typedef struct
+{
+    int wd;
+    bool root;
+    char *path;
+} File_Watch_Dir;
+
+static pthread_mutex_t watch_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t watch_thread;
+static int watch_fd = -1;
+static bool watch_started;
+static bool watch_failed; // Uma falha desativa o observador até o fim do processo
+static atomic_bool watch_active;
+static atomic_bool watch_run;
+static File_Watch_Dir *watch_dirs; // Protegidos por watch_lock
+static size_t watch_count;
+static size_t watch_capacity;
+static atomic_uint_fast64_t watch_events;
+
+static void watch_invalidate(const char *path, bool tree)
+{
+    HTTP_Fd_Cache_Invalidate(path, tree);
+    HTTP_File_Cache_Invalidate(path, tree);
+}
+
+// Sem garantia de eventos, nada do que está em cache pode continuar valendo
+static void watch_deactivate(void)
+{
+    if (!atomic_exchange(&watch_active, false))
+        return;
+    HTTP_PRINT_ERROR(stderr, "inotify watcher disabled, file caches fall back to stat()");
+    watch_invalidate(NULL, true);
+}
+
+static File_Watch_Dir *watch_find(int wd)
+{
+    for (size_t i = 0; i < watch_count; i++)
+    {
+        if (watch_dirs[i].wd == wd)
+            return &watch_dirs[i];
+    }
+    return NULL;
+}
+
+static void watch_forget(File_Watch_Dir *dir)
+{
+    free(dir->path);
+    *dir = watch_dirs[--watch_count];
+}
+
+// --- Watch para o diretório e todos os subdiretórios (sob watch_lock) ---
+static bool watch_add_tree(const char *path, bool root)
+{
+    int wd = inotify_add_watch(watch_fd, path, FILE_WATCH_MASK);
+    if (wd < 0)
+    {
+        // O diretório pode ter sumido entre o evento e o watch; a remoção chega como evento
+        if (errno == ENOENT || errno == ENOTDIR)
+            return true;
+        HTTP_PRINT_ERROR(stderr, "inotify_add_watch %s: %s", path, strerror(errno));
+        return false;
+    }
+
+    // Um diretório já observado devolve o mesmo wd
+    if (!watch_find(wd))
+    {
+        if (watch_count == watch_capacity)
+        {
+            size_t capacity = watch_capacity ? watch_capacity * 2 : 64;
+            File_Watch_Dir *dirs = realloc(watch_dirs, capacity * sizeof(File_Watch_Dir));
+            if (!dirs)
+                return false;
+            watch_dirs = dirs;
+            watch_capacity = capacity;
+        }
+        char *copy = strdup(path);
+        if (!copy)
+            return false;
+        watch_dirs[watch_count++] = (File_Watch_Dir){.wd = wd, .root = root, .path = copy};
+    }
+
+    DIR *dir = opendir(path);
+    if (!dir)
+        return true;
+
+    bool ok = true;
+    struct dirent *entry;
+    while (ok && (entry = readdir(dir)) != NULL)
+    {
+        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
+            continue;
+
+        // Links simbólicos não são seguidos (evita ciclos)
+        bool directory = entry->d_type == DT_DIR;
+        char child[PATH_MAX];
+        if (snprintf(child, sizeof(child), "%s/%s", path, entry->d_name) >= (int)sizeof(child))
+            continue;
+        if (entry->d_type == DT_UNKNOWN)
+        {
+            struct stat st;
+            directory = lstat(child, &st) == 0 && S_ISDIR(st.st_mode);
+        }
+        if (directory)
+            ok = watch_add_tree(child, false);
+    }
+    closedir(dir);
+    return ok;
+}
+
+// Diretório movido para fora: os watches abaixo dele passariam a relatar caminhos antigos
+static void watch_remove_tree(const char *path)
+{
+    size_t length = strlen(path);
+    for (size_t i = 0; i < watch_count;)
+    {
+        File_Watch_Dir *dir = &watch_dirs[i];
+        if (strncmp(dir->path, path, length) == 0 && (dir->path[length] == '\0' || dir->path[length] == '/'))
+        {
+            inotify_rm_watch(watch_fd, dir->wd);
+            watch_forget(dir);
+        }
+        else
+            i++;
+    }
+}
+
+static void watch_event(const struct inotify_event *event)
+{
+    atomic_fetch_add_explicit(&watch_events, 1, memory_order_relaxed);
+    if (event->mask & IN_Q_OVERFLOW)
+    {
+        // Eventos perdidos: tudo pode ter mudado
+        watch_invalidate(NULL, true);
+        return;
+    }
+
+    File_Watch_Dir *dir = watch_find(event->wd);
+    if (!dir)
+        return;
+
+    if (event->mask & IN_IGNORED)
+    {
+        watch_forget(dir);
+        return;
+    }
+
+    if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF))
+    {
+        if (dir->root)
+            watch_deactivate();
+        else
+            watch_invalidate(dir->path, true);
+        return;
+    }
+
+    if (!event->len)
+        return;
+
+    char path[PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s/%s", dir->path, event->name) >= (int)sizeof(path))
+        return;
+
+    // O pai também sai: listagem e documento padrão dependem do conteúdo do diretório
+    bool directory = (event->mask & IN_ISDIR) != 0;
+    watch_invalidate(path, directory);
+    watch_invalidate(dir->path, false);
+
+    // Variante comprimida (arquivo.gz, arquivo.br): o original guarda se ela existe
+    size_t length = strlen(path);
+    if (!directory && length > 3 && (!strcmp(path + length - 3, ".gz") || !strcmp(path + length - 3, ".br")))
+    {
+        path[length - 3] = '\0';
+        watch_invalidate(path, false);
+        path[length - 3] = '.';
+    }
+
+    if (directory && (event->mask & IN_MOVED_FROM))
+        watch_remove_tree(path);
+    if (directory && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+    {
+        if (!watch_add_tree(path, false))
+            watch_deactivate();
+        // O que foi consultado dentro dele antes do watch existir
+        watch_invalidate(path, true);
+    }
+}
+
+static void *watch_loop(void *arg)
+{
+    (void)arg;
+    char buffer[16384] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    while (atomic_load(&watch_run))
+    {
+        socket_poll_fd fds[] = {
+            {.fd = watch_fd, .events = POLLIN}};
+        int ready = poll_socket(fds, 1, 100); // Confere watch_run a cada 100ms
+        if (ready < 0 && errno != EINTR)
+        {
+            HTTP_PRINT_ERROR(stderr, "inotify poll");
+            break;
+        }
+        if (ready <= 0)
+            continue;
+
+        ssize_t length = read(watch_fd, buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            if (length < 0 && (errno == EINTR || errno == EAGAIN))
+                continue;
+            HTTP_PRINT_ERROR(stderr, "inotify read");
+            break;
+        }
+
+        pthread_mutex_lock(&watch_lock);
+        for (char *cursor = buffer; cursor < buffer + length;)
+        {
+            const struct inotify_event *event = (const struct inotify_event *)cursor;
+            watch_event(event);
+            cursor += sizeof(struct inotify_event) + event->len;
+        }
+        pthread_mutex_unlock(&watch_lock);
+    }
+
+    // Saída por erro (e não por HTTP_File_Watch_Stop) deixa os caches sem invalidação
+    if (atomic_load(&watch_run))
+        watch_deactivate();
+    else
+        atomic_store(&watch_active, false);
+    return NULL;
+}
+
+// --- Passa a observar a raiz; várias instâncias do módulo podem pedir a mesma ---
+bool HTTP_File_Watch(const char *root)
+{
+    pthread_mutex_lock(&watch_lock);
+    bool ok = false;
+    bool known = false;
+    for (size_t i = 0; i < watch_count; i++)
+        known |= watch_dirs[i].root && strcmp(watch_dirs[i].path, root) == 0;
+
+    if (known)
+        ok = atomic_load(&watch_active);
+    else if (!watch_failed && !(watch_started && !atomic_load(&watch_active)))
+    {
+        if (watch_fd < 0)
+        {
+            watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (watch_fd < 0)
+                HTTP_PRINT_ERROR(stderr, "inotify_init1: %s", strerror(errno));
+        }
+        ok = watch_fd >= 0 && watch_add_tree(root, true);
+
+        if (ok && !watch_started)
+        {
+            atomic_store(&watch_run, true);
+            atomic_store(&watch_active, true);
+            watch_started = pthread_create(&watch_thread, NULL, watch_loop, NULL) == 0;
+            if (!watch_started)
+            {
+                HTTP_PRINT_ERROR(stderr, "pthread_create (inotify)");
+                atomic_store(&watch_active, false);
+                ok = false;
+            }
+        }
+        watch_failed = !ok;
+    }
+    pthread_mutex_unlock(&watch_lock);
+
+    if (!ok)
+        watch_deactivate();
+    return ok;
+}
+
+bool HTTP_File_Watch_Active(void)
+{
+    return atomic_load_explicit(&watch_active, memory_order_acquire);
+}
+
+void HTTP_File_Watch_Stats_Print(FILE *fd)
+{
+    if (!watch_started)
+        return;
+
+    pthread_mutex_lock(&watch_lock);
+    size_t count = watch_count;
+    pthread_mutex_unlock(&watch_lock);
+
+    fprintf(fd, "Observador inotify: %s, %zu diretórios, %llu eventos\n",
+            HTTP_File_Watch_Active() ? "ativo" : "inativo", count,
+            (unsigned long long)atomic_load(&watch_events));
+}
+
+void HTTP_File_Watch_Stop(void)
+{
+    if (watch_started)
+    {
+        atomic_store(&watch_run, false);
+        pthread_join(watch_thread, NULL);
+        watch_started = false;
+    }
+
+    pthread_mutex_lock(&watch_lock);
+    while (watch_count)
+        watch_forget(&watch_dirs[0]);
+    free(watch_dirs);
+    watch_dirs = NULL;
+    watch_capacity = 0;
+    if (watch_fd >= 0)
+        close(watch_fd);
+    watch_fd = -1;
+    pthread_mutex_unlock(&watch_lock);
+}
+
+#else
+
+bool HTTP_File_Watch(const char *root)
+{
+    (void)root;
+    return false;
+}
+
+bool HTTP_File_Watch_Active(void)
+{
+    return false;
+}
+
+void HTTP_File_Watch_Stats_Print(FILE *fd)
+{
+    (void)fd;
+}
+
+void HTTP_File_Watch_Stop(void)
+{
+}
+
+#endif
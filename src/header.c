@@ -1,55 +1,164 @@
 #include <nero_http.h>
-#include <time.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+// --- Tabela de cabeçalhos conhecidos (hash perfeito sobre comprimento, primeira e última letra) ---
+// Os coeficientes foram escolhidos para não haver colisões entre os nomes abaixo;
+// ao incluir um nome, confirme que a posição continua livre (-Woverride-init acusa)
+#define KNOWN_SLOTS 64
+#define KNOWN_HASH(length, first, last) \
+    (((unsigned)(length) * 2u + (unsigned)(first) * 17u + (unsigned)(last) * 5u) & (KNOWN_SLOTS - 1))
+#define KNOWN(id, lower, first, last) \
+    [KNOWN_HASH(sizeof(lower) - 1, first, last)] = {lower, sizeof(lower) - 1, id}
+
+typedef struct
+{
+    const char *name; // Em minúsculas
+    size_t length;
+    HTTP_Header_Id id;
+} HTTP_Known_Slot;
+
+static const HTTP_Known_Slot known_slots[KNOWN_SLOTS] = {
+    KNOWN(HTTP_HEADER_HOST, "host", 'h', 't'),
+    KNOWN(HTTP_HEADER_CONNECTION, "connection", 'c', 'n'),
+    KNOWN(HTTP_HEADER_KEEP_ALIVE, "keep-alive", 'k', 'e'),
+    KNOWN(HTTP_HEADER_CONTENT_LENGTH, "content-length", 'c', 'h'),
+    KNOWN(HTTP_HEADER_CONTENT_TYPE, "content-type", 'c', 'e'),
+    KNOWN(HTTP_HEADER_CONTENT_ENCODING, "content-encoding", 'c', 'g'),
+    KNOWN(HTTP_HEADER_CONTENT_RANGE, "content-range", 'c', 'e'),
+    KNOWN(HTTP_HEADER_TRANSFER_ENCODING, "transfer-encoding", 't', 'g'),
+    KNOWN(HTTP_HEADER_RANGE, "range", 'r', 'e'),
+    KNOWN(HTTP_HEADER_IF_RANGE, "if-range", 'i', 'e'),
+    KNOWN(HTTP_HEADER_IF_NONE_MATCH, "if-none-match", 'i', 'h'),
+    KNOWN(HTTP_HEADER_IF_MODIFIED_SINCE, "if-modified-since", 'i', 'e'),
+    KNOWN(HTTP_HEADER_ACCEPT, "accept", 'a', 't'),
+    KNOWN(HTTP_HEADER_ACCEPT_ENCODING, "accept-encoding", 'a', 'g'),
+    KNOWN(HTTP_HEADER_ACCEPT_LANGUAGE, "accept-language", 'a', 'e'),
+    KNOWN(HTTP_HEADER_ACCEPT_RANGES, "accept-ranges", 'a', 's'),
+    KNOWN(HTTP_HEADER_USER_AGENT, "user-agent", 'u', 't'),
+    KNOWN(HTTP_HEADER_COOKIE, "cookie", 'c', 'e'),
+    KNOWN(HTTP_HEADER_REFERER, "referer", 'r', 'r'),
+    KNOWN(HTTP_HEADER_UPGRADE, "upgrade", 'u', 'e'),
+    KNOWN(HTTP_HEADER_EXPECT, "expect", 'e', 't'),
+    KNOWN(HTTP_HEADER_AUTHORIZATION, "authorization", 'a', 'n'),
+    KNOWN(HTTP_HEADER_CACHE_CONTROL, "cache-control", 'c', 'l'),
+    KNOWN(HTTP_HEADER_DATE, "date", 'd', 'e'),
+    KNOWN(HTTP_HEADER_SERVER, "server", 's', 'r'),
+    KNOWN(HTTP_HEADER_ETAG, "etag", 'e', 'g'),
+    KNOWN(HTTP_HEADER_LAST_MODIFIED, "last-modified", 'l', 'd'),
+    KNOWN(HTTP_HEADER_VARY, "vary", 'v', 'y'),
+    KNOWN(HTTP_HEADER_LOCATION, "location", 'l', 'n'),
+};
+
+// --- Reconhece um nome de cabeçalho conhecido (sem distinção de caixa) ---
+HTTP_Header_Id HTTP_Header_Known(const char *name, size_t length)
+{
+    if (length == 0)
+        return HTTP_HEADER_UNKNOWN;
+
+    // | 0x20 converte letras para minúsculas; outros bytes só caem numa posição que não confere
+    const HTTP_Known_Slot *slot = &known_slots[KNOWN_HASH(length, name[0] | 0x20, name[length - 1] | 0x20)];
+    if (slot->name && slot->length == length && strncasecmp(name, slot->name, length) == 0)
+        return slot->id;
+    return HTTP_HEADER_UNKNOWN;
+}
+
+// --- Memória de um cabeçalho montado: da arena, quando houver, ou do heap ---
+static void *header_alloc(HTTP_Header *header, size_t size)
+{
+    return header->arena ? HTTP_Arena_Alloc(header->arena, size) : malloc(size);
+}
+
+static char *header_strdup(HTTP_Header *header, const char *string)
+{
+    return header->arena ? HTTP_Arena_Strdup(header->arena, string) : strdup(string);
+}
+
+static void header_free(HTTP_Header *header, void *memory)
+{
+    if (!header->arena)
+        free(memory);
+}
+
 // --- Envio de Cabeçalhos HTTP ---
 bool HTTP_Header_SendToClient(HTTP_Connection *conn, HTTP_Header *header, int status_code)
 {
     if (!conn || !header)
         return false;
 
-    char buffer[1024];
-    snprintf(buffer, sizeof(buffer), "HTTP/1.1 %d OK\r\n", status_code);
-
-    int bytes_written = HTTP_Write(conn, buffer, strlen(buffer));
-    if (bytes_written < 0)
-        goto fail;
+    char status[64];
+    int status_length = snprintf(status, sizeof(status), "HTTP/1.1 %03d %s\r\n", status_code, HTTP_Status_Reason(status_code));
+    if (status_length < 0 || (size_t)status_length >= sizeof(status))
+    {
+        HTTP_PRINT_ERROR(stderr, "status line too long");
+        return false;
+    }
 
-    header->prologue = strdup(buffer);
-    char *remove_break = strchr(header->prologue, '\r');
-    if (remove_break)
-        *remove_break = '\0';
+    header_free(header, header->prologue);
+    header->prologue = header_strdup(header, status);
+    if (header->prologue)
+        header->prologue[status_length - 2] = '\0';
 
+    // Serializa o bloco inteiro para que saia em um único envio (ou registro TLS)
+    size_t length = (size_t)status_length + 2;
     for (HTTP_Header_Value *value = header->values; value; value = value->next)
-    {
-        bytes_written = HTTP_Write(conn, value->name, strlen(value->name));
-        if (bytes_written < 0)
-            goto fail;
+        length += strlen(value->name) + 2 + (value->value ? strlen(value->value) : 0) + 2;
 
-        bytes_written = HTTP_Write(conn, ": ", 2);
-        if (bytes_written < 0)
-            goto fail;
+    char stack[2048];
+    char *block = length <= sizeof(stack) ? stack : malloc(length);
+    if (!block)
+    {
+        HTTP_PRINT_ERROR(stderr, "malloc");
+        return false;
+    }
 
+    char *p = block;
+    memcpy(p, status, (size_t)status_length);
+    p += status_length;
+    for (HTTP_Header_Value *value = header->values; value; value = value->next)
+    {
+        size_t name_length = strlen(value->name);
+        memcpy(p, value->name, name_length);
+        p += name_length;
+        *p++ = ':';
+        *p++ = ' ';
         if (value->value)
         {
-            bytes_written = HTTP_Write(conn, value->value, strlen(value->value));
-            if (bytes_written < 0)
-                goto fail;
+            size_t value_length = strlen(value->value);
+            memcpy(p, value->value, value_length);
+            p += value_length;
         }
-
-        bytes_written = HTTP_Write(conn, "\r\n", 2);
-        if (bytes_written < 0)
-            goto fail;
+        *p++ = '\r';
+        *p++ = '\n';
     }
+    *p++ = '\r';
+    *p++ = '\n';
+
+    int bytes_written = HTTP_Write(conn, block, length);
+    if (block != stack)
+        free(block);
 
-    HTTP_Write(conn, "\r\n", 2);
+    if (bytes_written < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "failed to send header");
+        return false;
+    }
     return true;
+}
 
-fail:
-    HTTP_PRINT_ERROR(stderr, "failed to send header");
-    return false;
+// --- Procura o primeiro valor de um cabeçalho montado ---
+static HTTP_Header_Value *header_find(HTTP_Header *header, const char *name, HTTP_Header_Id id)
+{
+    if (id != HTTP_HEADER_UNKNOWN)
+        return header->known_values[id];
+
+    for (HTTP_Header_Value *current = header->values; current; current = current->next)
+    {
+        if (current->id == HTTP_HEADER_UNKNOWN && strcasecmp(current->name, name) == 0)
+            return current;
+    }
+    return NULL;
 }
 
 // --- Adiciona ou atualiza um cabeçalho ---
@@ -58,22 +167,23 @@ bool HTTP_Header_Push(HTTP_Header *header, const char *name, const char *value,
     if (!header || !name)
         return false;
 
-    HTTP_Header_Value *last = NULL;
+    HTTP_Header_Id id = HTTP_Header_Known(name, strlen(name));
 
-    for (HTTP_Header_Value *current = header->values; current; current = current->next)
+    HTTP_Header_Value *current = replace ? header_find(header, name, id) : NULL;
+    if (current)
     {
-        if (strcasecmp(current->name, name) == 0)
+        char *copy = value ? header_strdup(header, value) : NULL;
+        if (value && !copy)
         {
-            free(current->value);
-            current->value = value ? strdup(value) : NULL;
-
-            if (replace)
-                return true; // Atualiza valor existente
+            HTTP_PRINT_ERROR(stderr, "strdup");
+            return false;
         }
-        last = current;
+        header_free(header, current->value);
+        current->value = copy;
+        return true; // Atualiza valor existente
     }
 
-    HTTP_Header_Value *new_value = malloc(sizeof(HTTP_Header_Value));
+    HTTP_Header_Value *new_value = header_alloc(header, sizeof(HTTP_Header_Value));
     if (!new_value)
     {
         HTTP_PRINT_ERROR(stderr, "malloc");
@@ -81,22 +191,27 @@ bool HTTP_Header_Push(HTTP_Header *header, const char *name, const char *value,
     }
 
     new_value->next = NULL;
-    new_value->name = strdup(name);
-    new_value->value = value ? strdup(value) : NULL;
+    new_value->id = id;
+    new_value->name = header_strdup(header, name);
+    new_value->value = value ? header_strdup(header, value) : NULL;
 
     if (!new_value->name || (value && !new_value->value))
     {
         HTTP_PRINT_ERROR(stderr, "strdup");
-        free(new_value->name);
-        free(new_value->value);
-        free(new_value);
+        header_free(header, new_value->name);
+        header_free(header, new_value->value);
+        header_free(header, new_value);
         return false;
     }
 
-    if (last)
-        last->next = new_value;
+    if (header->last)
+        header->last->next = new_value;
     else
         header->values = new_value;
+    header->last = new_value;
+
+    if (id != HTTP_HEADER_UNKNOWN && !header->known_values[id])
+        header->known_values[id] = new_value;
 
     header->count++;
     return true;
@@ -108,27 +223,48 @@ bool HTTP_Header_RemoveObject(HTTP_Header *header, const char *name, bool firstF
     if (!header || !name)
         return false;
 
+    HTTP_Header_Id id = HTTP_Header_Known(name, strlen(name));
     HTTP_Header_Value *current = header->values;
     HTTP_Header_Value *prev = NULL;
+    bool removed = false;
 
     while (current)
     {
-        if (strcasecmp(current->name, name) == 0)
+        if (current->id == id && (id != HTTP_HEADER_UNKNOWN || strcasecmp(current->name, name) == 0))
         {
+            HTTP_Header_Value *next = current->next;
             if (prev)
-                prev->next = current->next;
+                prev->next = next;
             else
-                header->values = current->next;
+                header->values = next;
+            if (header->last == current)
+                header->last = prev;
 
-            free(current->name);
-            free(current->value);
-            free(current);
+            header_free(header, current->name);
+            header_free(header, current->value);
+            header_free(header, current);
             header->count--;
+            removed = true;
 
             if (firstFind)
+            {
+                // O índice passa para a próxima ocorrência, se houver
+                if (id != HTTP_HEADER_UNKNOWN)
+                {
+                    header->known_values[id] = NULL;
+                    for (HTTP_Header_Value *rest = next; rest; rest = rest->next)
+                    {
+                        if (rest->id == id)
+                        {
+                            header->known_values[id] = rest;
+                            break;
+                        }
+                    }
+                }
                 return true;
+            }
 
-            current = prev ? prev->next : header->values;
+            current = next;
             continue;
         }
 
@@ -136,7 +272,9 @@ bool HTTP_Header_RemoveObject(HTTP_Header *header, const char *name, bool firstF
         current = current->next;
     }
 
-    return false;
+    if (id != HTTP_HEADER_UNKNOWN)
+        header->known_values[id] = NULL;
+    return removed;
 }
 
 // --- Libera memória dos cabeçalhos ---
@@ -145,6 +283,14 @@ void HTTP_Header_Destroy(HTTP_Header **header)
     if (!header || !(*header))
         return;
 
+    // Requisições recebidas pertencem à conexão e são liberadas com o buffer;
+    // cabeçalhos montados na arena somem no reinício dela
+    if ((*header)->base || (*header)->arena)
+    {
+        *header = NULL;
+        return;
+    }
+
     HTTP_Header_Value *current = (*header)->values;
 
     while (current)
@@ -164,189 +310,244 @@ void HTTP_Header_Destroy(HTTP_Header **header)
 // --- Cria um novo cabeçalho padrão de servidor ---
 HTTP_Header *HTTP_Header_CreateServerHeader()
 {
-    HTTP_Header *header = malloc(sizeof(HTTP_Header));
+    return HTTP_Header_CreateServerHeader_Arena(NULL);
+}
+
+// --- Cria o cabeçalho padrão na arena da requisição (NULL = heap); dispensa o destroy ---
+HTTP_Header *HTTP_Header_CreateServerHeader_Arena(HTTP_Arena *arena)
+{
+    HTTP_Header *header = arena ? HTTP_Arena_Calloc(arena, sizeof(HTTP_Header)) : calloc(1, sizeof(HTTP_Header));
     if (!header)
     {
-        HTTP_PRINT_ERROR(stderr, "malloc");
+        HTTP_PRINT_ERROR(stderr, "calloc");
         return NULL;
     }
-
-    header->values = NULL;
-    header->count = 0;
+    header->arena = arena;
 
     HTTP_Header_Push(header, "Server", "NeroServer/0.1", false);
 
-    char buffer[30];
-    time_t now = time(NULL);
-    struct tm *tm_info = gmtime(&now);
-    strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", tm_info);
-    HTTP_Header_Push(header, "Date", buffer, false);
+    HTTP_Header_Push(header, "Date", HTTP_Date_Now(), false);
 
     return header;
 }
 
-// --- Leitura do cabeçalho HTTP do cliente ---
-HTTP_Header *HTTP_Header_GetFromClient(HTTP_Connection *conn)
+// --- Garante espaço para mais bytes no buffer de leitura (mais o terminador nulo) ---
+bool HTTP_Header_Reserve(HTTP_Connection *conn, size_t extra)
 {
-    bool slash_r = false;
-    int count = 0;
+    if (conn->buffer_size - conn->buffer_used >= extra + 1)
+        return true;
 
-    char *buffer = malloc(1024);
-    size_t length = 1024;
-    size_t total_read = 0;
+    size_t size = conn->buffer_size ? conn->buffer_size : HTTP_READ_CHUNK;
+    while (size - conn->buffer_used < extra + 1)
+        size *= 2;
 
+    char *buffer = realloc(conn->buffer, size);
     if (!buffer)
     {
-        HTTP_PRINT_ERROR(stderr, "malloc");
-        return NULL;
+        HTTP_PRINT_ERROR(stderr, "realloc");
+        return false;
     }
+    conn->buffer = buffer;
+    conn->buffer_size = size;
+    return true;
+}
 
-    do
+// --- Procura o fim do cabeçalho (\r\n\r\n) nos bytes recebidos ---
+// Retoma de onde a busca anterior parou; descarta antes o corpo da requisição anterior
+char *HTTP_Header_End(HTTP_Connection *conn)
+{
+    if (conn->discard > 0 && conn->buffer_used > 0)
     {
-        if (total_read >= length)
+        size_t drop = conn->discard < conn->buffer_used ? conn->discard : conn->buffer_used;
+        memmove(conn->buffer, conn->buffer + drop, conn->buffer_used - drop);
+        conn->buffer_used -= drop;
+        conn->discard -= drop;
+        conn->buffer_scanned = 0;
+    }
+    if (conn->discard > 0)
+        return NULL;
+
+    char *p = conn->buffer + (conn->buffer_scanned > 3 ? conn->buffer_scanned - 3 : 0);
+    const char *end = HTTP_Scan_HeaderEnd(p, conn->buffer + conn->buffer_used);
+    if (end)
+        return (char *)end;
+
+    conn->buffer_scanned = conn->buffer_used;
+    return NULL;
+}
+
+// --- Interpreta a requisição que termina em end, sem cópias ---
+// O cabeçalho retornado pertence à conexão e aponta para o buffer até HTTP_Header_Consume
+HTTP_Header *HTTP_Header_Take(HTTP_Connection *conn, char *end)
+{
+    conn->request_size = (size_t)(end - conn->buffer);
+    conn->request_body = 0;
+
+    HTTP_Header *header = &conn->request;
+    if (!HTTP_Header_Parse(header, conn->buffer, conn->request_size))
+        return NULL;
+
+    const char *length = HTTP_Header_Get(header, HTTP_HEADER_CONTENT_LENGTH);
+    if (length)
+        conn->request_body = (size_t)strtoull(length, NULL, 10);
+    return header;
+}
+
+// --- Remove a requisição atendida do buffer, preservando a próxima (pipelining) ---
+void HTTP_Header_Consume(HTTP_Connection *conn)
+{
+    size_t consumed = conn->request_size < conn->buffer_used ? conn->request_size : conn->buffer_used;
+    memmove(conn->buffer, conn->buffer + consumed, conn->buffer_used - consumed);
+    conn->buffer_used -= consumed;
+    conn->buffer_scanned = 0;
+    conn->request_size = 0;
+    conn->request.base = NULL;
+    conn->request.count = 0;
+    HTTP_Arena_Reset(&conn->arena);
+
+    // Corpo não lido pelos módulos (HTTP_Read desconta o que entregou): descartado conforme chegar
+    conn->discard = conn->request_body;
+    conn->request_body = 0;
+}
+
+// --- Leitura do cabeçalho HTTP do cliente (modo thread) ---
+// Lê tudo o que estiver disponível; bytes além do cabeçalho ficam para a próxima requisição
+HTTP_Header *HTTP_Header_GetFromClient(HTTP_Connection *conn)
+{
+    char *end;
+    while (!(end = HTTP_Header_End(conn)))
+    {
+        if (conn->buffer_used >= HTTP_HEADER_MAX_SIZE)
         {
-            length += 1024;
-            char *new_buffer = realloc(buffer, length);
-            if (!new_buffer)
-            {
-                HTTP_PRINT_ERROR(stderr, "realloc");
-                free(buffer);
-                return NULL;
-            }
-            buffer = new_buffer;
+            HTTP_PRINT_ERROR(stderr, "header too large");
+            return NULL;
         }
 
-        char *lastPointer = buffer + total_read;
-        int bytes_read = HTTP_Read(conn, lastPointer, 4);
+        if (!HTTP_Header_Reserve(conn, HTTP_READ_CHUNK))
+            return NULL;
+
+        int bytes_read = HTTP_Read(conn, conn->buffer + conn->buffer_used,
+                                   conn->buffer_size - conn->buffer_used - 1);
         if (bytes_read <= 0)
         {
-            HTTP_PRINT_ERROR(stderr, "failed to read header");
-            free(buffer);
+            // Fechamento limpo entre requisições não é erro
+            if (bytes_read < 0 || conn->buffer_used > 0)
+                HTTP_PRINT_ERROR(stderr, "failed to read header");
             return NULL;
         }
 
-        for (char *p = lastPointer; p < lastPointer + bytes_read; p++)
-        {
-            if (*p == '\r')
-                slash_r = true;
-            else if (*p == '\n')
-            {
-                if (slash_r)
-                {
-                    slash_r = false;
-                    count++;
-                }
-                else
-                {
-                    slash_r = false;
-                    count = 0;
-                }
+        // O primeiro byte inicia o prazo para o cabeçalho completo
+        if (conn->buffer_used == 0 && conn->discard == 0)
+            HTTP_Connection_Deadline(conn, HTTP_TIMEOUT_HEADER);
+        conn->buffer_used += (size_t)bytes_read;
+    }
 
-                if (count == 2)
-                {
-                    *p = '\0'; // finaliza string do header
-                    break;
-                }
-            }
-            else
-            {
-                slash_r = false;
-                count = 0;
-            }
-        }
+    return HTTP_Header_Take(conn, end);
+}
 
-        total_read += bytes_read;
+// --- Interpreta no lugar um cabeçalho completo (terminado em \r\n\r\n) ---
+// Não aloca: a linha inicial e os campos viram fatias do próprio buffer,
+// com os fins de linha e os ':' substituídos por terminadores nulos
+bool HTTP_Header_Parse(HTTP_Header *header, char *buffer, size_t length)
+{
+    if (!header || !buffer)
+        return false;
 
-    } while (count < 2);
+    header->prologue = NULL;
+    header->values = NULL;
+    header->last = NULL;
+    header->count = 0;
+    header->arena = NULL;
+    header->base = buffer;
+    memset(header->known_fields, 0, sizeof(header->known_fields));
 
-    if (total_read == 0)
-    {
-        free(buffer);
-        return NULL;
-    }
+    char *end = buffer + length;
+    char *line = buffer;
 
-    HTTP_Header *header = calloc(1, sizeof(HTTP_Header));
-    if (!header)
+    while (line < end)
     {
-        HTTP_PRINT_ERROR(stderr, "calloc");
-        free(buffer);
-        return NULL;
-    }
+        // Uma única varredura encontra o ':' (se houver) e o fim da linha
+        char *colon = (char *)HTTP_Scan_Any(line, end, ':', '\n');
+        if (colon == end)
+            break;
+        char *line_end = *colon == '\n' ? colon : (char *)HTTP_Scan_Any(colon, end, '\n', '\n');
+        if (line_end == end)
+            break;
+        if (colon == line_end)
+            colon = NULL;
+
+        char *next = line_end + 1;
+        if (line_end > line && line_end[-1] == '\r')
+            line_end--;
+        *line_end = '\0';
 
-    char *prologue_end = strstr(buffer, "\r\n");
-    if (prologue_end)
-    {
-        size_t prologue_length = prologue_end - buffer;
-        header->prologue = malloc(prologue_length + 1);
         if (!header->prologue)
         {
-            HTTP_PRINT_ERROR(stderr, "malloc");
-            free(buffer);
-            free(header);
-            return NULL;
+            header->prologue = line;
+            line = next;
+            continue;
         }
-        memcpy(header->prologue, buffer, prologue_length);
-        header->prologue[prologue_length] = '\0';
-    }
-    else
-    {
-        header->prologue = strdup(buffer);
-    }
-
-    // Processa os campos de cabeçalho
-    char *buffer_header = prologue_end ? prologue_end + 2 : buffer;
-    char *next_colon = NULL;
-    char *next_end_line = NULL;
 
-    do
-    {
-        next_colon = strchr(buffer_header, ':');
-        next_end_line = strstr(buffer_header, "\r\n");
+        // Linha vazia: fim do cabeçalho
+        if (line_end == line)
+            break;
 
-        if (!next_colon || !next_end_line || next_colon > next_end_line)
+        if (!colon)
             break;
 
-        size_t name_length = next_colon - buffer_header;
-        char *name = malloc(name_length + 1);
-        if (!name)
+        // Nome do campo: apenas caracteres de token, sem espaço antes do ':'
+        if (colon == line || HTTP_Scan_Token(line, colon) != (size_t)(colon - line))
         {
-            HTTP_PRINT_ERROR(stderr, "malloc");
-            HTTP_Header_Destroy(&header);
-            free(buffer);
-            return NULL;
+            HTTP_PRINT_ERROR(stderr, "invalid header field name");
+            return false;
         }
-        memcpy(name, buffer_header, name_length);
-        name[name_length] = '\0';
-
-        // Pula ':' e espaço
-        char *value_start = next_colon + 1;
-        while (*value_start == ' ')
-            value_start++;
 
-        size_t value_length = next_end_line - value_start;
-        char *value = malloc(value_length + 1);
-        if (!value)
+        if (header->count == HTTP_HEADER_MAX_FIELDS)
         {
-            HTTP_PRINT_ERROR(stderr, "malloc");
-            free(name);
-            HTTP_Header_Destroy(&header);
-            free(buffer);
-            return NULL;
+            HTTP_PRINT_ERROR(stderr, "too many header fields");
+            return false;
         }
-        memcpy(value, value_start, value_length);
-        value[value_length] = '\0';
 
-        HTTP_Header_Push(header, name, value, false);
+        char *value = colon + 1;
+        while (value < line_end && (*value == ' ' || *value == '\t'))
+            value++;
+        char *value_end = line_end;
+        while (value_end > value && (value_end[-1] == ' ' || value_end[-1] == '\t'))
+            value_end--;
+        *colon = '\0';
+        *value_end = '\0';
+
+        // Campos conhecidos ficam indexados; vale a primeira ocorrência
+        HTTP_Header_Id id = HTTP_Header_Known(line, (size_t)(colon - line));
+        if (id != HTTP_HEADER_UNKNOWN && !header->known_fields[id])
+            header->known_fields[id] = (uint8_t)(header->count + 1);
+
+        HTTP_Header_Field *field = &header->fields[header->count++];
+        field->name = (uint32_t)(line - buffer);
+        field->name_length = (uint32_t)(colon - line);
+        field->value = (uint32_t)(value - buffer);
+        field->value_length = (uint32_t)(value_end - value);
+
+        line = next;
+    }
 
-        free(name);
-        free(value);
+    return header->prologue != NULL;
+}
 
-        buffer_header = next_end_line + 2;
+// --- Busca valor de um cabeçalho conhecido (acesso direto pelo índice) ---
+const char *HTTP_Header_Get(HTTP_Header *header, HTTP_Header_Id id)
+{
+    if (!header || id < 0 || id >= HTTP_HEADER_KNOWN)
+        return NULL;
 
-    } while (1);
+    if (header->base)
+    {
+        uint8_t index = header->known_fields[id];
+        return index ? header->base + header->fields[index - 1].value : NULL;
+    }
 
-    free(buffer);
-    return header;
+    HTTP_Header_Value *value = header->known_values[id];
+    return value ? value->value : NULL;
 }
 
 // --- Busca valor de um cabeçalho pelo nome ---
@@ -355,12 +556,25 @@ const char *HTTP_Header_GetValue(HTTP_Header *header, const char *object)
     if (!header || !object)
         return NULL;
 
-    for (HTTP_Header_Value *value = header->values; value; value = value->next)
+    size_t length = strlen(object);
+    HTTP_Header_Id id = HTTP_Header_Known(object, length);
+    if (id != HTTP_HEADER_UNKNOWN)
+        return HTTP_Header_Get(header, id);
+
+    // Demais nomes: busca linear
+    if (header->base)
     {
-        if (strcasecmp(value->name, object) == 0)
-            return value->value;
+        for (size_t i = 0; i < header->count; i++)
+        {
+            HTTP_Header_Field *field = &header->fields[i];
+            if (field->name_length == length && strncasecmp(header->base + field->name, object, length) == 0)
+                return header->base + field->value;
+        }
+        return NULL;
     }
-    return NULL;
+
+    HTTP_Header_Value *value = header_find(header, object, HTTP_HEADER_UNKNOWN);
+    return value ? value->value : NULL;
 }
 
 // --- Imprime cabeçalho para debug ---
@@ -371,6 +585,9 @@ void HTTP_Header_Print(HTTP_Header *header)
 
     printf("Prologue: %s\n", header->prologue);
 
+    for (size_t i = 0; header->base && i < header->count; i++)
+        printf("%s: %s\n", header->base + header->fields[i].name, header->base + header->fields[i].value);
+
     for (HTTP_Header_Value *value = header->values; value; value = value->next)
     {
         printf("%s: %s\n", value->name, value->value ? value->value : "(null)");
@@ -0,0 +1,522 @@
+#include <nero_http.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HPACK_ENTRY_OVERHEAD 32 // Custo fixo de cada entrada da tabela dinâmica (RFC 7541 4.1)
+#define HPACK_CAPACITY (sizeof(((HTTP_Hpack_Decoder *)0)->entries) / sizeof(HTTP_Hpack_Entry))
+#define HPACK_STATIC_COUNT 61
+
+// --- Tabela estática (RFC 7541, Apêndice A) ---
+static const struct
+{
+    const char *name;
+    const char *value;
+} hpack_static[HPACK_STATIC_COUNT] = {
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+};
+
+// --- Código de Huffman (RFC 7541, Apêndice B); o símbolo 256 é o EOS ---
+static const uint32_t hpack_huffman_codes[257] = {
+    0x00001ff8, 0x007fffd8, 0x0fffffe2, 0x0fffffe3, 0x0fffffe4, 0x0fffffe5, 0x0fffffe6, 0x0fffffe7,
+    0x0fffffe8, 0x00ffffea, 0x3ffffffc, 0x0fffffe9, 0x0fffffea, 0x3ffffffd, 0x0fffffeb, 0x0fffffec,
+    0x0fffffed, 0x0fffffee, 0x0fffffef, 0x0ffffff0, 0x0ffffff1, 0x0ffffff2, 0x3ffffffe, 0x0ffffff3,
+    0x0ffffff4, 0x0ffffff5, 0x0ffffff6, 0x0ffffff7, 0x0ffffff8, 0x0ffffff9, 0x0ffffffa, 0x0ffffffb,
+    0x00000014, 0x000003f8, 0x000003f9, 0x00000ffa, 0x00001ff9, 0x00000015, 0x000000f8, 0x000007fa,
+    0x000003fa, 0x000003fb, 0x000000f9, 0x000007fb, 0x000000fa, 0x00000016, 0x00000017, 0x00000018,
+    0x00000000, 0x00000001, 0x00000002, 0x00000019, 0x0000001a, 0x0000001b, 0x0000001c, 0x0000001d,
+    0x0000001e, 0x0000001f, 0x0000005c, 0x000000fb, 0x00007ffc, 0x00000020, 0x00000ffb, 0x000003fc,
+    0x00001ffa, 0x00000021, 0x0000005d, 0x0000005e, 0x0000005f, 0x00000060, 0x00000061, 0x00000062,
+    0x00000063, 0x00000064, 0x00000065, 0x00000066, 0x00000067, 0x00000068, 0x00000069, 0x0000006a,
+    0x0000006b, 0x0000006c, 0x0000006d, 0x0000006e, 0x0000006f, 0x00000070, 0x00000071, 0x00000072,
+    0x000000fc, 0x00000073, 0x000000fd, 0x00001ffb, 0x0007fff0, 0x00001ffc, 0x00003ffc, 0x00000022,
+    0x00007ffd, 0x00000003, 0x00000023, 0x00000004, 0x00000024, 0x00000005, 0x00000025, 0x00000026,
+    0x00000027, 0x00000006, 0x00000074, 0x00000075, 0x00000028, 0x00000029, 0x0000002a, 0x00000007,
+    0x0000002b, 0x00000076, 0x0000002c, 0x00000008, 0x00000009, 0x0000002d, 0x00000077, 0x00000078,
+    0x00000079, 0x0000007a, 0x0000007b, 0x00007ffe, 0x000007fc, 0x00003ffd, 0x00001ffd, 0x0ffffffc,
+    0x000fffe6, 0x003fffd2, 0x000fffe7, 0x000fffe8, 0x003fffd3, 0x003fffd4, 0x003fffd5, 0x007fffd9,
+    0x003fffd6, 0x007fffda, 0x007fffdb, 0x007fffdc, 0x007fffdd, 0x007fffde, 0x00ffffeb, 0x007fffdf,
+    0x00ffffec, 0x00ffffed, 0x003fffd7, 0x007fffe0, 0x00ffffee, 0x007fffe1, 0x007fffe2, 0x007fffe3,
+    0x007fffe4, 0x001fffdc, 0x003fffd8, 0x007fffe5, 0x003fffd9, 0x007fffe6, 0x007fffe7, 0x00ffffef,
+    0x003fffda, 0x001fffdd, 0x000fffe9, 0x003fffdb, 0x003fffdc, 0x007fffe8, 0x007fffe9, 0x001fffde,
+    0x007fffea, 0x003fffdd, 0x003fffde, 0x00fffff0, 0x001fffdf, 0x003fffdf, 0x007fffeb, 0x007fffec,
+    0x001fffe0, 0x001fffe1, 0x003fffe0, 0x001fffe2, 0x007fffed, 0x003fffe1, 0x007fffee, 0x007fffef,
+    0x000fffea, 0x003fffe2, 0x003fffe3, 0x003fffe4, 0x007ffff0, 0x003fffe5, 0x003fffe6, 0x007ffff1,
+    0x03ffffe0, 0x03ffffe1, 0x000fffeb, 0x0007fff1, 0x003fffe7, 0x007ffff2, 0x003fffe8, 0x01ffffec,
+    0x03ffffe2, 0x03ffffe3, 0x03ffffe4, 0x07ffffde, 0x07ffffdf, 0x03ffffe5, 0x00fffff1, 0x01ffffed,
+    0x0007fff2, 0x001fffe3, 0x03ffffe6, 0x07ffffe0, 0x07ffffe1, 0x03ffffe7, 0x07ffffe2, 0x00fffff2,
+    0x001fffe4, 0x001fffe5, 0x03ffffe8, 0x03ffffe9, 0x0ffffffd, 0x07ffffe3, 0x07ffffe4, 0x07ffffe5,
+    0x000fffec, 0x00fffff3, 0x000fffed, 0x001fffe6, 0x003fffe9, 0x001fffe7, 0x001fffe8, 0x007ffff3,
+    0x003fffea, 0x003fffeb, 0x01ffffee, 0x01ffffef, 0x00fffff4, 0x00fffff5, 0x03ffffea, 0x007ffff4,
+    0x03ffffeb, 0x07ffffe6, 0x03ffffec, 0x03ffffed, 0x07ffffe7, 0x07ffffe8, 0x07ffffe9, 0x07ffffea,
+    0x07ffffeb, 0x0ffffffe, 0x07ffffec, 0x07ffffed, 0x07ffffee, 0x07ffffef, 0x07fffff0, 0x03ffffee,
+    0x3fffffff,
+};
+
+static const uint8_t hpack_huffman_lengths[257] = {
+    13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+    28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+    5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+    13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+    15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+    6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+    20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+    24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+    22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+    21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+    26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+    19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+    20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+    26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+    30,
+};
+
+// --- Árvore de decodificação, montada uma vez a partir dos códigos ---
+// Filho positivo é outro nó; negativo é -(símbolo + 1); zero é ausente
+static int16_t hpack_tree[256][2];
+static pthread_once_t hpack_tree_once = PTHREAD_ONCE_INIT;
+
+static void hpack_build_tree(void)
+{
+    int16_t nodes = 1;
+    for (int symbol = 0; symbol < 257; symbol++)
+    {
+        int node = 0;
+        for (int bit = hpack_huffman_lengths[symbol] - 1; bit >= 0; bit--)
+        {
+            int branch = (hpack_huffman_codes[symbol] >> bit) & 1;
+            if (bit == 0)
+                hpack_tree[node][branch] = (int16_t)-(symbol + 1);
+            else
+            {
+                if (hpack_tree[node][branch] == 0)
+                    hpack_tree[node][branch] = nodes++;
+                node = hpack_tree[node][branch];
+            }
+        }
+    }
+}
+
+void HTTP_Hpack_Init(HTTP_Hpack_Decoder *decoder)
+{
+    pthread_once(&hpack_tree_once, hpack_build_tree);
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->max_size = HTTP_HPACK_TABLE_SIZE;
+}
+
+// --- Inteiro com prefixo de n bits (RFC 7541 5.1) ---
+static bool hpack_integer(const uint8_t **p, const uint8_t *end, int prefix, uint32_t *value)
+{
+    uint32_t max = (1u << prefix) - 1;
+    uint64_t result = *(*p)++ & max;
+    if (result < max)
+    {
+        *value = (uint32_t)result;
+        return true;
+    }
+
+    for (unsigned shift = 0; *p < end && shift <= 28; shift += 7)
+    {
+        uint8_t byte = *(*p)++;
+        result += (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+        {
+            if (result > UINT32_MAX)
+                return false;
+            *value = (uint32_t)result;
+            return true;
+        }
+    }
+    return false;
+}
+
+// --- Decodifica um literal Huffman; o preenchimento final deve ser de no máximo 7 bits 1 ---
+static bool hpack_huffman_decode(const uint8_t *data, size_t length, char *out, size_t *out_length)
+{
+    size_t used = 0;
+    int node = 0;
+    int depth = 0;
+    bool ones = true;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        for (int bit = 7; bit >= 0; bit--)
+        {
+            int branch = (data[i] >> bit) & 1;
+            int next = hpack_tree[node][branch];
+            if (next < 0)
+            {
+                if (next == -257) // EOS no meio do literal
+                    return false;
+                out[used++] = (char)(-next - 1);
+                node = 0;
+                depth = 0;
+                ones = true;
+            }
+            else if (next == 0)
+                return false;
+            else
+            {
+                node = next;
+                depth++;
+                ones = ones && branch;
+            }
+        }
+    }
+
+    *out_length = used;
+    return depth <= 7 && ones;
+}
+
+static bool hpack_reserve(HTTP_Hpack_Decoder *decoder, size_t size)
+{
+    if (decoder->scratch_size >= size)
+        return true;
+
+    char *scratch = realloc(decoder->scratch, size);
+    if (!scratch)
+    {
+        HTTP_PRINT_ERROR(stderr, "realloc");
+        return false;
+    }
+    decoder->scratch = scratch;
+    decoder->scratch_size = size;
+    return true;
+}
+
+// --- Literal de string (RFC 7541 5.2): cru aponta para o bloco, Huffman vai para scratch + offset ---
+static bool hpack_string(HTTP_Hpack_Decoder *decoder, const uint8_t **p, const uint8_t *end, size_t offset,
+                         const char **string, size_t *length, bool *in_scratch)
+{
+    if (*p >= end)
+        return false;
+
+    bool huffman = **p & 0x80;
+    uint32_t raw_length;
+    if (!hpack_integer(p, end, 7, &raw_length) || raw_length > (size_t)(end - *p))
+        return false;
+
+    const uint8_t *data = *p;
+    *p += raw_length;
+    *in_scratch = huffman;
+
+    if (!huffman)
+    {
+        *string = (const char *)data;
+        *length = raw_length;
+        return true;
+    }
+
+    // O menor código tem 5 bits: cada octeto gera no máximo 8/5 símbolos
+    if (!hpack_reserve(decoder, offset + (size_t)raw_length * 8 / 5 + 1))
+        return false;
+    *string = decoder->scratch + offset;
+    return hpack_huffman_decode(data, raw_length, decoder->scratch + offset, length);
+}
+
+static HTTP_Hpack_Entry *hpack_dynamic(HTTP_Hpack_Decoder *decoder, size_t index)
+{
+    return &decoder->entries[(decoder->first + index) % HPACK_CAPACITY];
+}
+
+static void hpack_evict(HTTP_Hpack_Decoder *decoder, size_t limit)
+{
+    while (decoder->count && decoder->size > limit)
+    {
+        HTTP_Hpack_Entry *oldest = hpack_dynamic(decoder, decoder->count - 1);
+        decoder->size -= oldest->name_length + oldest->value_length + HPACK_ENTRY_OVERHEAD;
+        free(oldest->data);
+        oldest->data = NULL;
+        decoder->count--;
+    }
+}
+
+// --- Nome e valor do índice (1 a 61 estático, depois dinâmico do mais novo ao mais velho) ---
+static bool hpack_lookup(HTTP_Hpack_Decoder *decoder, uint32_t index, const char **name, size_t *name_length,
+                         const char **value, size_t *value_length)
+{
+    if (index == 0)
+        return false;
+
+    if (index <= HPACK_STATIC_COUNT)
+    {
+        *name = hpack_static[index - 1].name;
+        *name_length = strlen(*name);
+        *value = hpack_static[index - 1].value;
+        *value_length = strlen(*value);
+        return true;
+    }
+
+    index -= HPACK_STATIC_COUNT + 1;
+    if (index >= decoder->count)
+        return false;
+
+    HTTP_Hpack_Entry *entry = hpack_dynamic(decoder, index);
+    *name = entry->data;
+    *name_length = entry->name_length;
+    *value = entry->data + entry->name_length + 1;
+    *value_length = entry->value_length;
+    return true;
+}
+
+// A cópia é feita antes do despejo: o nome pode vir de uma entrada que está saindo
+static bool hpack_insert(HTTP_Hpack_Decoder *decoder, const char *name, size_t name_length,
+                         const char *value, size_t value_length)
+{
+    size_t entry_size = name_length + value_length + HPACK_ENTRY_OVERHEAD;
+    if (entry_size > decoder->max_size)
+    {
+        // Entrada maior que a tabela apenas a esvazia (RFC 7541 4.4)
+        hpack_evict(decoder, 0);
+        return true;
+    }
+
+    char *data = malloc(name_length + value_length + 2);
+    if (!data)
+    {
+        HTTP_PRINT_ERROR(stderr, "malloc");
+        return false;
+    }
+    memcpy(data, name, name_length);
+    data[name_length] = '\0';
+    memcpy(data + name_length + 1, value, value_length);
+    data[name_length + 1 + value_length] = '\0';
+
+    hpack_evict(decoder, decoder->max_size - entry_size);
+
+    decoder->first = (decoder->first + HPACK_CAPACITY - 1) % HPACK_CAPACITY;
+    decoder->entries[decoder->first] = (HTTP_Hpack_Entry){
+        .data = data,
+        .name_length = (uint32_t)name_length,
+        .value_length = (uint32_t)value_length};
+    decoder->count++;
+    decoder->size += entry_size;
+    return true;
+}
+
+// --- Decodifica um bloco de cabeçalho completo; false é erro de compressão (fatal para a conexão) ---
+bool HTTP_Hpack_Decode(HTTP_Hpack_Decoder *decoder, const uint8_t *block, size_t length, HTTP_Hpack_Emit emit, void *context)
+{
+    const uint8_t *p = block;
+    const uint8_t *end = block + length;
+    bool fields = false;
+
+    while (p < end)
+    {
+        uint8_t first = *p;
+        uint32_t index;
+
+        // Campo indexado
+        if (first & 0x80)
+        {
+            const char *name, *value;
+            size_t name_length, value_length;
+            if (!hpack_integer(&p, end, 7, &index) ||
+                !hpack_lookup(decoder, index, &name, &name_length, &value, &value_length))
+                return false;
+            emit(context, name, name_length, value, value_length);
+            fields = true;
+            continue;
+        }
+
+        // Atualização do tamanho da tabela: só antes do primeiro campo do bloco
+        if ((first & 0xe0) == 0x20)
+        {
+            if (fields || !hpack_integer(&p, end, 5, &index) || index > HTTP_HPACK_TABLE_SIZE)
+                return false;
+            decoder->max_size = index;
+            hpack_evict(decoder, index);
+            continue;
+        }
+
+        // Literais: com indexação incremental (01), sem indexação (0000) ou nunca indexado (0001)
+        bool indexing = (first & 0xc0) == 0x40;
+        if (!hpack_integer(&p, end, indexing ? 6 : 4, &index))
+            return false;
+
+        const char *name, *value;
+        size_t name_length, value_length;
+        bool name_scratch = false, value_scratch;
+        if (index)
+        {
+            if (!hpack_lookup(decoder, index, &name, &name_length, &value, &value_length))
+                return false;
+        }
+        else if (!hpack_string(decoder, &p, end, 0, &name, &name_length, &name_scratch))
+            return false;
+
+        if (!hpack_string(decoder, &p, end, name_scratch ? name_length : 0, &value, &value_length, &value_scratch))
+            return false;
+        if (name_scratch)
+            name = decoder->scratch; // O valor pode ter realocado o scratch
+
+        emit(context, name, name_length, value, value_length);
+        fields = true;
+
+        if (indexing && !hpack_insert(decoder, name, name_length, value, value_length))
+            return false;
+    }
+
+    return true;
+}
+
+void HTTP_Hpack_Destroy(HTTP_Hpack_Decoder *decoder)
+{
+    hpack_evict(decoder, 0);
+    free(decoder->scratch);
+    decoder->scratch = NULL;
+    decoder->scratch_size = 0;
+}
+
+// --- Codificação ---
+static uint8_t *hpack_encode_integer(uint8_t *out, uint8_t flags, int prefix, size_t value)
+{
+    size_t max = ((size_t)1 << prefix) - 1;
+    if (value < max)
+    {
+        *out++ = (uint8_t)(flags | value);
+        return out;
+    }
+
+    *out++ = (uint8_t)(flags | max);
+    value -= max;
+    while (value >= 0x80)
+    {
+        *out++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (uint8_t)value;
+    return out;
+}
+
+static unsigned char hpack_lower(unsigned char c, bool lowercase)
+{
+    return lowercase && c >= 'A' && c <= 'Z' ? (unsigned char)(c + 32) : c;
+}
+
+// Huffman apenas quando encurta o literal; nomes saem em minúsculas (RFC 9113 8.2.1)
+static uint8_t *hpack_encode_string(uint8_t *out, const char *string, size_t length, bool lowercase)
+{
+    const unsigned char *s = (const unsigned char *)string;
+    size_t bits = 0;
+    for (size_t i = 0; i < length; i++)
+        bits += hpack_huffman_lengths[hpack_lower(s[i], lowercase)];
+
+    size_t huffman_length = (bits + 7) / 8;
+    if (huffman_length >= length)
+    {
+        out = hpack_encode_integer(out, 0x00, 7, length);
+        for (size_t i = 0; i < length; i++)
+            *out++ = hpack_lower(s[i], lowercase);
+        return out;
+    }
+
+    out = hpack_encode_integer(out, 0x80, 7, huffman_length);
+    uint64_t pending = 0;
+    unsigned count = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        unsigned char c = hpack_lower(s[i], lowercase);
+        pending = pending << hpack_huffman_lengths[c] | hpack_huffman_codes[c];
+        count += hpack_huffman_lengths[c];
+        while (count >= 8)
+        {
+            count -= 8;
+            *out++ = (uint8_t)(pending >> count);
+        }
+        pending &= ((uint64_t)1 << count) - 1;
+    }
+    if (count)
+        *out++ = (uint8_t)(pending << (8 - count) | (0xff >> count)); // Preenchimento com o prefixo do EOS
+    return out;
+}
+
+// --- Codifica um campo da resposta sem usar a tabela dinâmica do cliente ---
+// Campo idêntico a uma entrada estática vira só o índice; nome estático vira literal com nome indexado.
+// out precisa de HTTP_HPACK_ENCODED_MAX(name_length, value_length) octetos; retorna quantos foram usados
+size_t HTTP_Hpack_Encode(uint8_t *out, const char *name, size_t name_length, const char *value, size_t value_length)
+{
+    uint8_t *start = out;
+    size_t name_index = 0;
+
+    for (size_t i = 0; i < HPACK_STATIC_COUNT; i++)
+    {
+        const char *static_name = hpack_static[i].name;
+        if (strncasecmp(static_name, name, name_length) != 0 || static_name[name_length] != '\0')
+            continue;
+
+        const char *static_value = hpack_static[i].value;
+        if (static_value[0] && strncmp(static_value, value, value_length) == 0 && static_value[value_length] == '\0')
+            return (size_t)(hpack_encode_integer(out, 0x80, 7, i + 1) - start);
+        if (!name_index)
+            name_index = i + 1;
+    }
+
+    // Literal sem indexação (RFC 7541 6.2.2)
+    out = hpack_encode_integer(out, 0x00, 4, name_index);
+    if (!name_index)
+        out = hpack_encode_string(out, name, name_length, true);
+    out = hpack_encode_string(out, value, value_length, false);
+    return (size_t)(out - start);
+}
@@ -146,24 +146,85 @@ size_t HTML_Attribute_LookupSize(const HTML_attribute *attribute)
     return strlen(attribute->content) + strlen(attribute->name) + 4;
 }
 
+// Memória da árvore: da arena, quando houver, ou do heap
+static void *html_alloc(struct HTTP_Arena *arena, size_t size)
+{
+    return arena ? HTTP_Arena_Calloc(arena, size) : calloc(1, size);
+}
+
+static char *html_strdup(struct HTTP_Arena *arena, const char *string)
+{
+    return arena ? HTTP_Arena_Strdup(arena, string) : strdup(string);
+}
+
+static void html_free(struct HTTP_Arena *arena, void *memory)
+{
+    if (!arena)
+        free(memory);
+}
+
+// Capacidade de um vetor NULL-terminated com count itens: potência de dois >= count + 1.
+// Não fica guardada; como todo vetor nasce aqui, basta recalculá-la a partir do tamanho
+static size_t html_vector_capacity(size_t count)
+{
+    size_t capacity = 4;
+    while (capacity < count + 1)
+        capacity <<= 1;
+    return capacity;
+}
+
+// Insere item na posição pos; cresce dobrando, então n inserções custam O(n) também na arena
+static void **html_vector_insert(struct HTTP_Arena *arena, void **vector, size_t size, size_t pos, void *item)
+{
+    if (!vector || size + 2 > html_vector_capacity(size))
+    {
+        void **grown = html_alloc(arena, html_vector_capacity(size + 1) * sizeof(void *));
+        if (!grown)
+        {
+            HTTP_PRINT_ERROR(stderr, "calloc");
+            return NULL;
+        }
+        if (size)
+            memcpy(grown, vector, size * sizeof(void *));
+        html_free(arena, vector);
+        vector = grown;
+    }
+
+    memmove(vector + pos + 1, vector + pos, (size - pos) * sizeof(void *));
+    vector[pos] = item;
+    vector[size + 1] = NULL;
+    return vector;
+}
+
 HTML_document *HTML_Create_Document(void)
 {
-    HTML_document *new = calloc(1, sizeof(HTML_document));
+    return HTML_Create_Document_Arena(NULL);
+}
+
+HTML_document *HTML_Create_Document_Arena(struct HTTP_Arena *arena)
+{
+    HTML_document *new = html_alloc(arena, sizeof(HTML_document));
     if (!new)
     {
         HTTP_PRINT_ERROR(stderr, "calloc");
         return NULL;
     }
-    new->html = HTML_Create_Tag("html", NULL, false);
+    new->arena = arena;
+    new->html = HTML_Create_Tag_Arena(arena, "html", NULL, false);
     new->doctype = html_doctype;
     return new;
 }
 
 HTML_tag *HTML_Create_Tag(const char *name, const char *text_content, bool void_tag)
+{
+    return HTML_Create_Tag_Arena(NULL, name, text_content, void_tag);
+}
+
+HTML_tag *HTML_Create_Tag_Arena(struct HTTP_Arena *arena, const char *name, const char *text_content, bool void_tag)
 {
     if (!name)
         return NULL;
-    HTML_tag *tag = calloc(1, sizeof(HTML_tag));
+    HTML_tag *tag = html_alloc(arena, sizeof(HTML_tag));
     if (!tag)
     {
         HTTP_PRINT_ERROR(stderr, "malloc");
@@ -171,41 +232,50 @@ HTML_tag *HTML_Create_Tag(const char *name, const char *text_content, bool void_
     }
 
     tag->void_element = void_tag;
+    tag->arena = arena;
 
-    tag->name = strdup(name);
-    tag->text_content = text_content ? strdup(text_content) : NULL;
+    tag->name = html_strdup(arena, name);
+    tag->text_content = text_content ? html_strdup(arena, text_content) : NULL;
     if (text_content && !tag->text_content)
     {
-        free(tag->name);
-        free(tag);
+        html_free(arena, tag->name);
+        html_free(arena, tag);
         return NULL;
     }
 
     if (!tag->name)
     {
-        free(tag);
+        html_free(arena, tag);
         return NULL;
     }
     return tag;
 }
 
 HTML_attribute *HTML_Create_Attribute(const char *name, const char *value)
+{
+    return HTML_Create_Attribute_Arena(NULL, name, value);
+}
+
+HTML_attribute *HTML_Create_Attribute_Arena(struct HTTP_Arena *arena, const char *name, const char *value)
 {
     if (!name || !value)
         return NULL;
 
-    HTML_attribute *attribute = malloc(sizeof(HTML_attribute));
+    HTML_attribute *attribute = html_alloc(arena, sizeof(HTML_attribute));
     if (!attribute)
     {
         HTTP_PRINT_ERROR(stderr, "malloc");
         return NULL;
     }
 
-    attribute->name = strdup(name);
-    attribute->content = strdup(value);
+    attribute->arena = arena;
+    attribute->name = html_strdup(arena, name);
+    attribute->content = html_strdup(arena, value);
     if (!attribute->name || !attribute->content)
     {
-        free(attribute);
+        html_free(arena, attribute->name);
+        html_free(arena, attribute->content);
+        html_free(arena, attribute);
         return NULL;
     }
     return attribute;
@@ -215,6 +285,13 @@ void HTML_Destroy_Document(HTML_document **document)
 {
     if (!document || !(*document))
         return;
+
+    // Documentos na arena são liberados no reinício dela
+    if ((*document)->arena)
+    {
+        *document = NULL;
+        return;
+    }
     HTML_Destroy_Tag(&(*document)->html);
     free(*document);
     *document = NULL;
@@ -225,6 +302,12 @@ void HTML_Destroy_Tag(HTML_tag **tag)
     if (!tag || !(*tag))
         return;
 
+    if ((*tag)->arena)
+    {
+        *tag = NULL;
+        return;
+    }
+
     free((*tag)->name);
     free((*tag)->text_content);
 
@@ -252,6 +335,13 @@ void HTML_Destroy_Attribute(HTML_attribute ***attribute_vector)
 
     HTML_attribute **vec = *attribute_vector;
 
+    // O vetor nasce na arena do primeiro atributo inserido
+    if (vec[0] && vec[0]->arena)
+    {
+        *attribute_vector = NULL;
+        return;
+    }
+
     for (size_t i = 0; vec[i] != NULL; i++)
     {
         free(vec[i]->name);
@@ -348,29 +438,10 @@ bool HTML_Add_Child(HTML_tag *parent, HTML_tag *child, HTML_Flags flags, size_t
         return true;
     }
 
-    // Alocar novo vetor
-    HTML_tag **new_vector = calloc(vector_size + 2, sizeof(HTML_tag *));
-    if (!new_vector)
-    {
-        HTTP_PRINT_ERROR(stderr, "calloc");
+    HTML_tag **vector = (HTML_tag **)html_vector_insert(parent->arena, (void **)parent->children, vector_size, insert_pos, child);
+    if (!vector)
         return false;
-    }
-
-    // Copia antes do ponto de inserção
-    if (insert_pos > 0)
-        memcpy(new_vector, parent->children, sizeof(HTML_tag *) * insert_pos);
-
-    // Insere novo filho
-    new_vector[insert_pos] = child;
-
-    // Copia restante
-    if (insert_pos < vector_size)
-        memcpy(new_vector + insert_pos + 1, parent->children + insert_pos, sizeof(HTML_tag *) * (vector_size - insert_pos));
-
-    // Finaliza
-    new_vector[vector_size + 1] = NULL;
-    free(parent->children);
-    parent->children = new_vector;
+    parent->children = vector;
 
     return true;
 }
@@ -455,35 +526,16 @@ bool HTML_Add_Attribute(HTML_attribute ***attribute_vector, HTML_attribute *attr
     if (to_replace)
     {
         (*attribute_vector)[insert_pos] = attribute;
-        free(to_replace->content);
-        free(to_replace->name);
-        free(to_replace);
+        html_free(to_replace->arena, to_replace->content);
+        html_free(to_replace->arena, to_replace->name);
+        html_free(to_replace->arena, to_replace);
         return true;
     }
 
-    // Alocar novo vetor
-    HTML_attribute **new_vector = calloc(vector_size + 2, sizeof(HTML_attribute *));
-    if (!new_vector)
-    {
-        HTTP_PRINT_ERROR(stderr, "calloc");
+    HTML_attribute **vector = (HTML_attribute **)html_vector_insert(attribute->arena, (void **)*attribute_vector, vector_size, insert_pos, attribute);
+    if (!vector)
         return false;
-    }
-
-    // Copia antes do ponto de inserção
-    if (insert_pos > 0)
-        memcpy(new_vector, *attribute_vector, sizeof(HTML_attribute *) * insert_pos);
-
-    // Insere novo atributo
-    new_vector[insert_pos] = attribute;
-
-    // Copia restante
-    if (insert_pos < vector_size)
-        memcpy(new_vector + insert_pos + 1, *attribute_vector + insert_pos, sizeof(HTML_attribute *) * (vector_size - insert_pos));
-
-    // Finaliza
-    new_vector[vector_size + 1] = NULL;
-    free(*attribute_vector);
-    *attribute_vector = new_vector;
+    *attribute_vector = vector;
 
     return true;
 }
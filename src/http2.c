@@ -0,0 +1,1051 @@
+#include <nero_http.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <netinet/tcp.h>
+#endif
+
+#define H2_PREFACE "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"
+#define H2_PREFACE_LENGTH (sizeof(H2_PREFACE) - 1)
+#define H2_FRAME_HEADER 9
+#define H2_DEFAULT_WINDOW 65535
+#define H2_MAX_WINDOW 0x7fffffff
+#define H2_MAX_FRAME_LIMIT 16777215
+
+// --- Tipos de quadro ---
+enum
+{
+    H2_DATA,
+    H2_HEADERS,
+    H2_PRIORITY,
+    H2_RST_STREAM,
+    H2_SETTINGS,
+    H2_PUSH_PROMISE,
+    H2_PING,
+    H2_GOAWAY,
+    H2_WINDOW_UPDATE,
+    H2_CONTINUATION
+};
+
+#define H2_FLAG_END_STREAM 0x01
+#define H2_FLAG_ACK 0x01
+#define H2_FLAG_END_HEADERS 0x04
+#define H2_FLAG_PADDED 0x08
+#define H2_FLAG_PRIORITY 0x20
+
+// --- Códigos de erro (RFC 9113 7) ---
+enum
+{
+    H2_NO_ERROR = 0x0,
+    H2_PROTOCOL_ERROR = 0x1,
+    H2_INTERNAL_ERROR = 0x2,
+    H2_FLOW_CONTROL_ERROR = 0x3,
+    H2_STREAM_CLOSED = 0x5,
+    H2_FRAME_SIZE_ERROR = 0x6,
+    H2_REFUSED_STREAM = 0x7,
+    H2_COMPRESSION_ERROR = 0x9,
+    H2_ENHANCE_YOUR_CALM = 0xb
+};
+
+// --- Parâmetros de SETTINGS ---
+enum
+{
+    H2_SETTINGS_HEADER_TABLE_SIZE = 0x1,
+    H2_SETTINGS_ENABLE_PUSH = 0x2,
+    H2_SETTINGS_MAX_CONCURRENT_STREAMS = 0x3,
+    H2_SETTINGS_INITIAL_WINDOW_SIZE = 0x4,
+    H2_SETTINGS_MAX_FRAME_SIZE = 0x5,
+    H2_SETTINGS_MAX_HEADER_LIST_SIZE = 0x6
+};
+
+typedef struct
+{
+    char *data;
+    size_t used;
+    size_t size;
+} H2_Buffer;
+
+typedef struct HTTP_H2_Stream
+{
+    uint32_t id;
+    int64_t window;      // Janela de envio do stream
+    bool closed_remote;  // END_STREAM recebido: o cliente não envia mais nada
+    bool reset;          // Encerrado por RST_STREAM
+    bool head;           // Requisição HEAD: o corpo escrito pelo módulo é descartado
+    char *request;       // Requisição remontada como cabeçalho HTTP/1.1
+    size_t request_length;
+    struct HTTP_H2_Stream *next;  // Streams abertos
+    struct HTTP_H2_Stream *ready; // Fila de despacho para os módulos
+} HTTP_H2_Stream;
+
+struct HTTP_H2_Session
+{
+    HTTP_Hpack_Decoder decoder;
+    HTTP_H2_Stream *streams;
+    size_t stream_count;
+    HTTP_H2_Stream *ready_first; // Requisições completas, na ordem de chegada
+    HTTP_H2_Stream *ready_last;
+    HTTP_H2_Stream *current;     // Stream que os módulos estão respondendo
+    uint32_t last_stream;        // Maior stream aberto pelo cliente
+    bool closing;                // GOAWAY recebido: nenhum stream novo é aceito
+    bool failed;                 // Conexão encerrada (erro de protocolo ou de E/S)
+    size_t offset;               // Bytes de conn->buffer já consumidos pelo leitor de quadros
+    int64_t window;              // Janela de envio da conexão
+    uint32_t initial_window;     // SETTINGS_INITIAL_WINDOW_SIZE do cliente
+    uint32_t max_frame;          // SETTINGS_MAX_FRAME_SIZE do cliente
+
+    // Bloco de cabeçalho em montagem (HEADERS seguido de CONTINUATION)
+    uint32_t block_stream; // 0 = nenhum
+    bool block_end_stream;
+    H2_Buffer block;
+
+    // Requisição sendo decodificada
+    H2_Buffer fields;
+    H2_Buffer cookie;
+    H2_Buffer method;
+    H2_Buffer path;
+    H2_Buffer authority;
+    bool scheme;
+    bool host;
+    bool regular;   // Já houve campo comum: pseudo-cabeçalhos não são mais aceitos
+    bool malformed;
+
+    // Resposta do stream atual
+    H2_Buffer head;    // Cabeçalho HTTP/1.1 escrito pelo módulo, até o \r\n\r\n
+    H2_Buffer encoded; // Bloco HPACK da resposta
+    bool head_sent;
+    bool ended;        // END_STREAM já enviado
+    bool has_length;
+    uint64_t remaining; // Corpo ainda devido conforme o Content-Length
+};
+
+static bool h2_reserve(H2_Buffer *buffer, size_t length)
+{
+    if (buffer->size - buffer->used >= length)
+        return true;
+
+    size_t size = buffer->size ? buffer->size : 256;
+    while (size - buffer->used < length)
+        size *= 2;
+
+    char *grown = realloc(buffer->data, size);
+    if (!grown)
+    {
+        HTTP_PRINT_ERROR(stderr, "realloc");
+        return false;
+    }
+    buffer->data = grown;
+    buffer->size = size;
+    return true;
+}
+
+static bool h2_append(H2_Buffer *buffer, const void *data, size_t length)
+{
+    if (!h2_reserve(buffer, length))
+        return false;
+    memcpy(buffer->data + buffer->used, data, length);
+    buffer->used += length;
+    return true;
+}
+
+static uint32_t h2_be32(const uint8_t *p)
+{
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static void h2_put32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)(value >> 24);
+    p[1] = (uint8_t)(value >> 16);
+    p[2] = (uint8_t)(value >> 8);
+    p[3] = (uint8_t)value;
+}
+
+// --- Envia um quadro: o cabeçalho vai para a saída acumulada e a carga segue por HTTP_Write_Raw ---
+static bool h2_send(HTTP_Connection *conn, HTTP_H2_Session *session, uint8_t type, uint8_t flags,
+                    uint32_t stream, const void *payload, size_t length)
+{
+    if (session->failed)
+        return false;
+
+    uint8_t header[H2_FRAME_HEADER] = {
+        (uint8_t)(length >> 16), (uint8_t)(length >> 8), (uint8_t)length, type, flags};
+    h2_put32(header + 5, stream);
+
+    if (!HTTP_Output_Append(conn, (const char *)header, sizeof(header)) ||
+        (length && HTTP_Write_Raw(conn, payload, length) < 0))
+    {
+        session->failed = true;
+        return false;
+    }
+    return true;
+}
+
+static bool h2_send_u32(HTTP_Connection *conn, HTTP_H2_Session *session, uint8_t type, uint32_t stream, uint32_t value)
+{
+    uint8_t payload[4];
+    h2_put32(payload, value);
+    return h2_send(conn, session, type, 0, stream, payload, sizeof(payload));
+}
+
+// --- Erro de conexão: GOAWAY com o código e fim do atendimento ---
+static bool h2_fail(HTTP_Connection *conn, HTTP_H2_Session *session, uint32_t code)
+{
+    if (!session->failed)
+    {
+        uint8_t payload[8];
+        h2_put32(payload, session->last_stream);
+        h2_put32(payload + 4, code);
+        h2_send(conn, session, H2_GOAWAY, 0, 0, payload, sizeof(payload));
+        HTTP_Flush_Raw(conn);
+        HTTP_PRINT_ERROR(stderr, "http2 connection error 0x%x", (unsigned)code);
+    }
+    session->failed = true;
+    return false;
+}
+
+static HTTP_H2_Stream *h2_find(HTTP_H2_Session *session, uint32_t id)
+{
+    for (HTTP_H2_Stream *stream = session->streams; stream; stream = stream->next)
+    {
+        if (stream->id == id)
+            return stream;
+    }
+    return NULL;
+}
+
+static void h2_remove(HTTP_H2_Session *session, HTTP_H2_Stream *stream)
+{
+    for (HTTP_H2_Stream **link = &session->streams; *link; link = &(*link)->next)
+    {
+        if (*link == stream)
+        {
+            *link = stream->next;
+            break;
+        }
+    }
+
+    HTTP_H2_Stream *previous = NULL;
+    for (HTTP_H2_Stream *ready = session->ready_first; ready; previous = ready, ready = ready->ready)
+    {
+        if (ready != stream)
+            continue;
+        if (previous)
+            previous->ready = stream->ready;
+        else
+            session->ready_first = stream->ready;
+        if (session->ready_last == stream)
+            session->ready_last = previous;
+        break;
+    }
+
+    session->stream_count--;
+    free(stream->request);
+    free(stream);
+}
+
+// --- Erro de stream: RST_STREAM; o stream some, exceto o que os módulos ainda estão respondendo ---
+static bool h2_reset(HTTP_Connection *conn, HTTP_H2_Session *session, uint32_t id, uint32_t code)
+{
+    HTTP_H2_Stream *stream = h2_find(session, id);
+    if (stream)
+    {
+        stream->reset = true;
+        if (stream != session->current)
+            h2_remove(session, stream);
+    }
+    return h2_send_u32(conn, session, H2_RST_STREAM, id, code);
+}
+
+// --- Garante need bytes não consumidos em conn->buffer, lendo do cliente se preciso ---
+static bool h2_fill(HTTP_Connection *conn, HTTP_H2_Session *session, size_t need)
+{
+    while (conn->buffer_used - session->offset < need)
+    {
+        if (session->offset)
+        {
+            memmove(conn->buffer, conn->buffer + session->offset, conn->buffer_used - session->offset);
+            conn->buffer_used -= session->offset;
+            session->offset = 0;
+        }
+
+        if (!HTTP_Header_Reserve(conn, need > HTTP_READ_CHUNK ? need : HTTP_READ_CHUNK))
+            return false;
+
+        // A leitura envia antes o que estiver acumulado na saída
+        int bytes_read = HTTP_Read_Raw(conn, conn->buffer + conn->buffer_used,
+                                       conn->buffer_size - conn->buffer_used - 1);
+        if (bytes_read <= 0)
+            return false;
+        conn->buffer_used += (size_t)bytes_read;
+    }
+    return true;
+}
+
+static bool h2_frame_buffered(HTTP_Connection *conn, HTTP_H2_Session *session)
+{
+    size_t available = conn->buffer_used - session->offset;
+    if (available < H2_FRAME_HEADER)
+        return false;
+
+    const uint8_t *header = (const uint8_t *)conn->buffer + session->offset;
+    size_t length = (size_t)header[0] << 16 | (size_t)header[1] << 8 | header[2];
+    return available >= H2_FRAME_HEADER + length;
+}
+
+// --- Decodificação da requisição ---
+static bool h2_is(const char *name, size_t length, const char *literal)
+{
+    return strlen(literal) == length && memcmp(name, literal, length) == 0;
+}
+
+// Nomes em minúsculas e sem separadores; valores sem \0, \r ou \n (RFC 9113 8.2.1)
+static bool h2_valid(const char *name, size_t name_length, const char *value, size_t value_length)
+{
+    if (!name_length)
+        return false;
+    for (size_t i = 0; i < name_length; i++)
+    {
+        unsigned char c = (unsigned char)name[i];
+        if (c <= ' ' || c >= 0x7f || (c >= 'A' && c <= 'Z') || (c == ':' && i > 0))
+            return false;
+    }
+    for (size_t i = 0; i < value_length; i++)
+    {
+        if (value[i] == '\0' || value[i] == '\r' || value[i] == '\n')
+            return false;
+    }
+    return true;
+}
+
+static void h2_field(void *context, const char *name, size_t name_length, const char *value, size_t value_length)
+{
+    HTTP_H2_Session *session = context;
+    if (session->malformed)
+        return;
+
+    if (!h2_valid(name, name_length, value, value_length) ||
+        session->fields.used + session->cookie.used + name_length + value_length > HTTP_HEADER_MAX_SIZE)
+    {
+        session->malformed = true;
+        return;
+    }
+
+    // Pseudo-cabeçalhos: únicos e antes de qualquer campo comum
+    if (name[0] == ':')
+    {
+        H2_Buffer *target = NULL;
+        if (h2_is(name, name_length, ":method"))
+            target = &session->method;
+        else if (h2_is(name, name_length, ":path"))
+            target = &session->path;
+        else if (h2_is(name, name_length, ":authority"))
+            target = &session->authority;
+        else if (h2_is(name, name_length, ":scheme") && !session->scheme)
+        {
+            session->scheme = true;
+            return;
+        }
+
+        if (target == &session->authority && !value_length)
+            return;
+
+        // Método e caminho formam a linha inicial: sem espaços
+        if (session->regular || !target || target->used || !value_length ||
+            (target != &session->authority && memchr(value, ' ', value_length)))
+        {
+            session->malformed = true;
+            return;
+        }
+        session->malformed = !h2_append(target, value, value_length);
+        return;
+    }
+    session->regular = true;
+
+    // Campos da conexão não existem em HTTP/2
+    if (h2_is(name, name_length, "connection") || h2_is(name, name_length, "keep-alive") ||
+        h2_is(name, name_length, "proxy-connection") || h2_is(name, name_length, "transfer-encoding") ||
+        h2_is(name, name_length, "upgrade") ||
+        (h2_is(name, name_length, "te") && !h2_is(value, value_length, "trailers")))
+    {
+        session->malformed = true;
+        return;
+    }
+
+    // Cookies podem chegar divididos; voltam a ser um único campo (RFC 9113 8.2.3)
+    if (h2_is(name, name_length, "cookie"))
+    {
+        session->malformed = (session->cookie.used && !h2_append(&session->cookie, "; ", 2)) ||
+                             !h2_append(&session->cookie, value, value_length);
+        return;
+    }
+
+    if (h2_is(name, name_length, "host"))
+        session->host = true;
+
+    session->malformed = !h2_append(&session->fields, name, name_length) ||
+                         !h2_append(&session->fields, ": ", 2) ||
+                         !h2_append(&session->fields, value, value_length) ||
+                         !h2_append(&session->fields, "\r\n", 2);
+}
+
+// --- Remonta a requisição como cabeçalho HTTP/1.1 para o parser e os módulos ---
+static char *h2_request(HTTP_H2_Session *session, size_t *length)
+{
+    H2_Buffer request = {0};
+    bool ok = h2_append(&request, session->method.data, session->method.used) &&
+              h2_append(&request, " ", 1) &&
+              h2_append(&request, session->path.data, session->path.used) &&
+              h2_append(&request, " HTTP/2.0\r\n", sizeof(" HTTP/2.0\r\n") - 1);
+
+    if (ok && !session->host && session->authority.used)
+        ok = h2_append(&request, "host: ", 6) &&
+             h2_append(&request, session->authority.data, session->authority.used) &&
+             h2_append(&request, "\r\n", 2);
+
+    if (ok && session->fields.used)
+        ok = h2_append(&request, session->fields.data, session->fields.used);
+
+    if (ok && session->cookie.used)
+        ok = h2_append(&request, "cookie: ", 8) &&
+             h2_append(&request, session->cookie.data, session->cookie.used) &&
+             h2_append(&request, "\r\n", 2);
+
+    if (!ok || !h2_append(&request, "\r\n", 2))
+    {
+        free(request.data);
+        return NULL;
+    }
+
+    *length = request.used;
+    return request.data;
+}
+
+// --- Requisição completa (END_STREAM recebido): entra na fila dos módulos ---
+// O corpo é descartado, mas só se responde depois dele: clientes que ainda estão enviando
+// costumam tratar uma resposta antecipada (e o RST_STREAM que a acompanha) como falha
+static void h2_ready(HTTP_H2_Session *session, HTTP_H2_Stream *stream)
+{
+    stream->closed_remote = true;
+    if (session->ready_last)
+        session->ready_last->ready = stream;
+    else
+        session->ready_first = stream;
+    session->ready_last = stream;
+}
+
+// --- Bloco de cabeçalho completo: decodifica e abre o stream ---
+static bool h2_headers_complete(HTTP_Connection *conn, HTTP_H2_Session *session)
+{
+    uint32_t id = session->block_stream;
+    bool end_stream = session->block_end_stream;
+    session->block_stream = 0;
+
+    session->fields.used = 0;
+    session->cookie.used = 0;
+    session->method.used = 0;
+    session->path.used = 0;
+    session->authority.used = 0;
+    session->scheme = false;
+    session->host = false;
+    session->regular = false;
+    session->malformed = false;
+
+    // Mesmo blocos descartados passam pelo decodificador: a tabela dinâmica precisa acompanhar o cliente
+    if (!HTTP_Hpack_Decode(&session->decoder, (const uint8_t *)session->block.data, session->block.used, h2_field, session))
+        return h2_fail(conn, session, H2_COMPRESSION_ERROR);
+
+    // Trailers de um stream existente encerram o envio do cliente
+    if (id <= session->last_stream)
+    {
+        HTTP_H2_Stream *stream = h2_find(session, id);
+        if (!stream)
+            return true;
+        if (stream->closed_remote || !end_stream)
+            return h2_reset(conn, session, id, stream->closed_remote ? H2_STREAM_CLOSED : H2_PROTOCOL_ERROR);
+        h2_ready(session, stream);
+        return true;
+    }
+
+    session->last_stream = id;
+    if (session->closing)
+        return true;
+    if (session->stream_count >= HTTP_H2_MAX_STREAMS)
+        return h2_reset(conn, session, id, H2_REFUSED_STREAM);
+    if (session->malformed || !session->method.used || !session->path.used || !session->scheme)
+        return h2_reset(conn, session, id, H2_PROTOCOL_ERROR);
+
+    HTTP_H2_Stream *stream = calloc(1, sizeof(HTTP_H2_Stream));
+    if (!stream || !(stream->request = h2_request(session, &stream->request_length)))
+    {
+        HTTP_PRINT_ERROR(stderr, "calloc failed");
+        free(stream);
+        return h2_reset(conn, session, id, H2_INTERNAL_ERROR);
+    }
+    stream->id = id;
+    stream->window = session->initial_window;
+    stream->head = h2_is(session->method.data, session->method.used, "HEAD");
+
+    stream->next = session->streams;
+    session->streams = stream;
+    session->stream_count++;
+    if (end_stream)
+        h2_ready(session, stream);
+    return true;
+}
+
+// --- Remove o preenchimento de DATA e HEADERS; false se o tamanho declarado não cabe ---
+static bool h2_unpad(uint8_t flags, const uint8_t **payload, size_t *length)
+{
+    if (!(flags & H2_FLAG_PADDED))
+        return true;
+    if (*length < 1 || (*payload)[0] >= *length)
+        return false;
+    *length -= 1 + (*payload)[0];
+    (*payload)++;
+    return true;
+}
+
+static bool h2_settings(HTTP_Connection *conn, HTTP_H2_Session *session, uint8_t flags,
+                        const uint8_t *payload, size_t length)
+{
+    if (flags & H2_FLAG_ACK)
+        return length == 0 || h2_fail(conn, session, H2_FRAME_SIZE_ERROR);
+    if (length % 6)
+        return h2_fail(conn, session, H2_FRAME_SIZE_ERROR);
+
+    for (size_t i = 0; i < length; i += 6)
+    {
+        uint16_t id = (uint16_t)(payload[i] << 8 | payload[i + 1]);
+        uint32_t value = h2_be32(payload + i + 2);
+
+        switch (id)
+        {
+        case H2_SETTINGS_ENABLE_PUSH:
+            if (value > 1)
+                return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+            break;
+
+        case H2_SETTINGS_INITIAL_WINDOW_SIZE:
+        {
+            // A diferença vale para todos os streams abertos, inclusive deixando janelas negativas
+            if (value > H2_MAX_WINDOW)
+                return h2_fail(conn, session, H2_FLOW_CONTROL_ERROR);
+            int64_t delta = (int64_t)value - session->initial_window;
+            for (HTTP_H2_Stream *stream = session->streams; stream; stream = stream->next)
+            {
+                stream->window += delta;
+                if (stream->window > H2_MAX_WINDOW)
+                    return h2_fail(conn, session, H2_FLOW_CONTROL_ERROR);
+            }
+            session->initial_window = value;
+            break;
+        }
+
+        case H2_SETTINGS_MAX_FRAME_SIZE:
+            if (value < HTTP_H2_FRAME_SIZE || value > H2_MAX_FRAME_LIMIT)
+                return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+            session->max_frame = value;
+            break;
+
+        default:
+            // Sem push nem tabela dinâmica no codificador: os demais não mudam nada aqui
+            break;
+        }
+    }
+
+    return h2_send(conn, session, H2_SETTINGS, H2_FLAG_ACK, 0, NULL, 0);
+}
+
+static bool h2_window_update(HTTP_Connection *conn, HTTP_H2_Session *session, uint32_t id,
+                             const uint8_t *payload, size_t length)
+{
+    if (length != 4)
+        return h2_fail(conn, session, H2_FRAME_SIZE_ERROR);
+
+    uint32_t increment = h2_be32(payload) & H2_MAX_WINDOW;
+    if (id == 0)
+    {
+        if (!increment || session->window + increment > H2_MAX_WINDOW)
+            return h2_fail(conn, session, increment ? H2_FLOW_CONTROL_ERROR : H2_PROTOCOL_ERROR);
+        session->window += increment;
+        return true;
+    }
+
+    if (id > session->last_stream)
+        return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+
+    HTTP_H2_Stream *stream = h2_find(session, id);
+    if (!stream)
+        return true;
+    if (!increment || stream->window + increment > H2_MAX_WINDOW)
+        return h2_reset(conn, session, id, increment ? H2_FLOW_CONTROL_ERROR : H2_PROTOCOL_ERROR);
+    stream->window += increment;
+    return true;
+}
+
+// --- Trata um quadro recebido; false encerra a conexão ---
+static bool h2_process(HTTP_Connection *conn, HTTP_H2_Session *session, uint8_t type, uint8_t flags,
+                       uint32_t id, const uint8_t *payload, size_t length)
+{
+    // Entre HEADERS e o fim do bloco só pode vir CONTINUATION do mesmo stream
+    if (session->block_stream ? type != H2_CONTINUATION || id != session->block_stream
+                              : type == H2_CONTINUATION)
+        return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+
+    switch (type)
+    {
+    case H2_DATA:
+    {
+        if (id == 0 || id > session->last_stream)
+            return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+        size_t frame_length = length;
+        if (!h2_unpad(flags, &payload, &length))
+            return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+
+        // O corpo é descartado, mas o quadro inteiro conta no controle de fluxo e é devolvido
+        if (frame_length && !h2_send_u32(conn, session, H2_WINDOW_UPDATE, 0, (uint32_t)frame_length))
+            return false;
+
+        HTTP_H2_Stream *stream = h2_find(session, id);
+        if (!stream)
+            return true;
+        if (stream->closed_remote)
+            return h2_reset(conn, session, id, H2_STREAM_CLOSED);
+        if (flags & H2_FLAG_END_STREAM)
+            h2_ready(session, stream);
+        else if (frame_length)
+            return h2_send_u32(conn, session, H2_WINDOW_UPDATE, id, (uint32_t)frame_length);
+        return true;
+    }
+
+    case H2_HEADERS:
+        if (id == 0 || !(id & 1))
+            return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+        if (!h2_unpad(flags, &payload, &length))
+            return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+        if (flags & H2_FLAG_PRIORITY)
+        {
+            if (length < 5)
+                return h2_fail(conn, session, H2_FRAME_SIZE_ERROR);
+            payload += 5;
+            length -= 5;
+        }
+
+        session->block_stream = id;
+        session->block_end_stream = flags & H2_FLAG_END_STREAM;
+        session->block.used = 0;
+        if (!h2_append(&session->block, payload, length))
+            return h2_fail(conn, session, H2_INTERNAL_ERROR);
+        return !(flags & H2_FLAG_END_HEADERS) || h2_headers_complete(conn, session);
+
+    case H2_CONTINUATION:
+        if (session->block.used + length > HTTP_HEADER_MAX_SIZE)
+            return h2_fail(conn, session, H2_ENHANCE_YOUR_CALM);
+        if (!h2_append(&session->block, payload, length))
+            return h2_fail(conn, session, H2_INTERNAL_ERROR);
+        return !(flags & H2_FLAG_END_HEADERS) || h2_headers_complete(conn, session);
+
+    case H2_PRIORITY:
+        // Prioridades não mudam a ordem de atendimento (RFC 9113 5.3.2)
+        if (id == 0)
+            return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+        return length == 5 || h2_reset(conn, session, id, H2_FRAME_SIZE_ERROR);
+
+    case H2_RST_STREAM:
+    {
+        if (length != 4)
+            return h2_fail(conn, session, H2_FRAME_SIZE_ERROR);
+        if (id == 0 || id > session->last_stream)
+            return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+        HTTP_H2_Stream *stream = h2_find(session, id);
+        if (stream)
+        {
+            stream->reset = true;
+            if (stream != session->current)
+                h2_remove(session, stream);
+        }
+        return true;
+    }
+
+    case H2_SETTINGS:
+        if (id != 0)
+            return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+        return h2_settings(conn, session, flags, payload, length);
+
+    case H2_PING:
+        if (length != 8)
+            return h2_fail(conn, session, H2_FRAME_SIZE_ERROR);
+        if (id != 0)
+            return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+        return (flags & H2_FLAG_ACK) || h2_send(conn, session, H2_PING, H2_FLAG_ACK, 0, payload, length);
+
+    case H2_GOAWAY:
+        if (id != 0)
+            return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+        session->closing = true;
+        return true;
+
+    case H2_WINDOW_UPDATE:
+        return h2_window_update(conn, session, id, payload, length);
+
+    case H2_PUSH_PROMISE:
+        // Apenas o servidor promete streams
+        return h2_fail(conn, session, H2_PROTOCOL_ERROR);
+
+    default:
+        // Tipos desconhecidos são ignorados (RFC 9113 4.1)
+        return true;
+    }
+}
+
+// --- Lê e trata o próximo quadro ---
+static bool h2_read_frame(HTTP_Connection *conn, HTTP_H2_Session *session)
+{
+    if (!h2_fill(conn, session, H2_FRAME_HEADER))
+    {
+        session->failed = true;
+        return false;
+    }
+
+    const uint8_t *header = (const uint8_t *)conn->buffer + session->offset;
+    size_t length = (size_t)header[0] << 16 | (size_t)header[1] << 8 | header[2];
+    if (length > HTTP_H2_FRAME_SIZE)
+        return h2_fail(conn, session, H2_FRAME_SIZE_ERROR);
+
+    if (!h2_fill(conn, session, H2_FRAME_HEADER + length))
+    {
+        session->failed = true;
+        return false;
+    }
+
+    // A leitura pode ter movido o buffer; a carga fica intacta até o próximo h2_fill
+    header = (const uint8_t *)conn->buffer + session->offset;
+    session->offset += H2_FRAME_HEADER + length;
+    return h2_process(conn, session, header[3], header[4], h2_be32(header + 5) & H2_MAX_WINDOW,
+                      header + H2_FRAME_HEADER, length);
+}
+
+// --- Resposta: cabeçalho HTTP/1.1 do módulo vira HEADERS (+ CONTINUATION) ---
+static bool h2_send_headers(HTTP_Connection *conn, HTTP_H2_Session *session, HTTP_H2_Stream *stream,
+                            char *head, size_t length)
+{
+    char *end = head + length;
+    char *line_end = memchr(head, '\n', length);
+    char *status = memchr(head, ' ', length);
+    if (!line_end || !status || status > line_end || end - status < 4 ||
+        status[1] < '1' || status[1] > '5' || status[2] < '0' || status[2] > '9' || status[3] < '0' || status[3] > '9')
+    {
+        HTTP_PRINT_ERROR(stderr, "invalid response status line");
+        return false;
+    }
+
+    session->encoded.used = 0;
+    if (!h2_reserve(&session->encoded, HTTP_HPACK_ENCODED_MAX(7, 3)))
+        return false;
+    session->encoded.used = HTTP_Hpack_Encode((uint8_t *)session->encoded.data, ":status", 7, status + 1, 3);
+    int code = (status[1] - '0') * 100 + (status[2] - '0') * 10 + (status[3] - '0');
+
+    for (char *line = line_end + 1; line < end; line = line_end + 1)
+    {
+        line_end = memchr(line, '\n', (size_t)(end - line));
+        if (!line_end)
+            break;
+        char *colon = memchr(line, ':', (size_t)(line_end - line));
+        if (!colon)
+            continue;
+
+        size_t name_length = (size_t)(colon - line);
+        char *value = colon + 1;
+        char *value_end = line_end;
+        while (value < value_end && (*value == ' ' || *value == '\t'))
+            value++;
+        while (value_end > value && (value_end[-1] == '\r' || value_end[-1] == ' ' || value_end[-1] == '\t'))
+            value_end--;
+        size_t value_length = (size_t)(value_end - value);
+
+        HTTP_Header_Id id = HTTP_Header_Known(line, name_length);
+        if (id == HTTP_HEADER_CONNECTION || id == HTTP_HEADER_KEEP_ALIVE ||
+            id == HTTP_HEADER_TRANSFER_ENCODING || id == HTTP_HEADER_UPGRADE)
+            continue;
+        if (id == HTTP_HEADER_CONTENT_LENGTH)
+        {
+            session->has_length = true;
+            session->remaining = strtoull(value, NULL, 10);
+        }
+
+        if (!h2_reserve(&session->encoded, HTTP_HPACK_ENCODED_MAX(name_length, value_length)))
+            return false;
+        session->encoded.used += HTTP_Hpack_Encode((uint8_t *)session->encoded.data + session->encoded.used,
+                                                   line, name_length, value, value_length);
+    }
+
+    // Sem corpo a enviar, o próprio HEADERS encerra o stream
+    bool end_stream = stream->head || code == 204 || code == 304 || (session->has_length && !session->remaining);
+
+    size_t sent = 0;
+    do
+    {
+        size_t chunk = session->encoded.used - sent;
+        if (chunk > session->max_frame)
+            chunk = session->max_frame;
+        bool last = sent + chunk == session->encoded.used;
+
+        uint8_t flags = last ? H2_FLAG_END_HEADERS : 0;
+        if (sent == 0 && end_stream)
+            flags |= H2_FLAG_END_STREAM;
+        if (!h2_send(conn, session, sent == 0 ? H2_HEADERS : H2_CONTINUATION, flags, stream->id,
+                     session->encoded.data + sent, chunk))
+            return false;
+        sent += chunk;
+    } while (sent < session->encoded.used);
+
+    session->head_sent = true;
+    session->ended = end_stream;
+    return true;
+}
+
+// --- Resposta: corpo vira DATA dentro das janelas do stream e da conexão ---
+static bool h2_send_data(HTTP_Connection *conn, HTTP_H2_Session *session, HTTP_H2_Stream *stream,
+                         const char *data, size_t length)
+{
+    // Depois do END_STREAM (HEAD, 304 ou além do Content-Length) o corpo é descartado
+    if (session->ended)
+        return true;
+    if (session->has_length && length > session->remaining)
+        length = (size_t)session->remaining;
+
+    while (length > 0)
+    {
+        int64_t window = session->window < stream->window ? session->window : stream->window;
+        if (window <= 0)
+        {
+            // Janela esgotada: segue tratando quadros (inclusive de outros streams) até o WINDOW_UPDATE
+            if (!h2_read_frame(conn, session) || stream->reset)
+                return false;
+            continue;
+        }
+
+        size_t chunk = length;
+        if (chunk > session->max_frame)
+            chunk = session->max_frame;
+        if ((int64_t)chunk > window)
+            chunk = (size_t)window;
+
+        bool last = session->has_length && chunk == session->remaining;
+        if (!h2_send(conn, session, H2_DATA, last ? H2_FLAG_END_STREAM : 0, stream->id, data, chunk))
+            return false;
+
+        session->window -= (int64_t)chunk;
+        stream->window -= (int64_t)chunk;
+        if (session->has_length)
+            session->remaining -= chunk;
+        session->ended = last;
+        data += chunk;
+        length -= chunk;
+    }
+    return true;
+}
+
+// --- HTTP_Write durante uma resposta HTTP/2 ---
+// O cabeçalho escrito pelo módulo é acumulado até o \r\n\r\n; o restante é corpo
+int HTTP_H2_Write(HTTP_Connection *conn, const char *data, size_t length)
+{
+    HTTP_H2_Session *session = conn->http2;
+    HTTP_H2_Stream *stream = session->current;
+    if (!stream || stream->reset || session->failed)
+        return -1;
+
+    if (!session->head_sent)
+    {
+        size_t scanned = session->head.used > 3 ? session->head.used - 3 : 0;
+        if (!h2_append(&session->head, data, length))
+            return -1;
+
+        const char *end = HTTP_Scan_HeaderEnd(session->head.data + scanned, session->head.data + session->head.used);
+        if (!end)
+            return session->head.used > HTTP_HEADER_MAX_SIZE ? -1 : (int)length;
+
+        size_t head_length = (size_t)(end - session->head.data);
+        if (!h2_send_headers(conn, session, stream, session->head.data, head_length) ||
+            !h2_send_data(conn, session, stream, end, session->head.used - head_length))
+            return -1;
+        return (int)length;
+    }
+
+    return h2_send_data(conn, session, stream, data, length) ? (int)length : -1;
+}
+
+// --- HTTP_Flush durante uma resposta HTTP/2 ---
+// A saída sai quando o laço voltar a ler do cliente: respostas de streams seguidos vão juntas
+bool HTTP_H2_Flush(HTTP_Connection *conn)
+{
+    HTTP_H2_Session *session = conn->http2;
+    return !session->failed;
+}
+
+// --- Fecha o stream respondido: END_STREAM se o módulo não o enviou ---
+static void h2_finish(HTTP_Connection *conn, HTTP_H2_Session *session, HTTP_H2_Stream *stream)
+{
+    if (stream->reset || session->failed)
+        return;
+
+    // Cabeçalho incompleto ou corpo menor que o Content-Length: a resposta não pode ser concluída
+    if (!session->head_sent || (!session->ended && session->has_length && session->remaining))
+    {
+        h2_send_u32(conn, session, H2_RST_STREAM, stream->id, H2_INTERNAL_ERROR);
+        return;
+    }
+    if (!session->ended)
+        h2_send(conn, session, H2_DATA, H2_FLAG_END_STREAM, stream->id, NULL, 0);
+}
+
+// --- Executa os módulos para um stream, como uma requisição HTTP/1.1 ---
+static void h2_dispatch(HTTP_Connection *conn, HTTP_H2_Session *session, HTTP_H2_Stream *stream)
+{
+    session->current = stream;
+    session->head.used = 0;
+    session->head_sent = false;
+    session->ended = false;
+    session->has_length = false;
+    session->remaining = 0;
+
+    HTTP_Header *header = &conn->request;
+    if (HTTP_Header_Parse(header, stream->request, stream->request_length))
+        HTTP_Dispatch(conn, header);
+    else
+    {
+        HTTP_Response response;
+        HTTP_Response_Begin(&response, 400);
+        HTTP_Response_Length(&response, 0);
+        HTTP_Response_Send(conn, &response);
+    }
+    h2_finish(conn, session, stream);
+
+    header->base = NULL;
+    header->count = 0;
+    conn->map = NULL;
+    HTTP_Arena_Reset(&conn->arena);
+    session->current = NULL;
+    h2_remove(session, stream);
+}
+
+// --- Escolha do protocolo no ALPN: "h2" primeiro, quando habilitado ---
+int HTTP_H2_Select_ALPN(SSL *ssl, const unsigned char **out, unsigned char *out_length,
+                        const unsigned char *in, unsigned int in_length, void *enabled)
+{
+    static const unsigned char protocols[] = "\x02h2\x08http/1.1";
+    const unsigned char *offer = protocols;
+    unsigned int offer_length = sizeof(protocols) - 1;
+    (void)ssl;
+
+    if (!*(bool *)enabled)
+    {
+        offer += 3;
+        offer_length -= 3;
+    }
+
+    if (SSL_select_next_proto((unsigned char **)out, out_length, offer, offer_length, in, in_length) != OPENSSL_NPN_NEGOTIATED)
+        return SSL_TLSEXT_ERR_NOACK;
+    return SSL_TLSEXT_ERR_OK;
+}
+
+bool HTTP_H2_Negotiated(HTTP_Connection *conn)
+{
+    const unsigned char *protocol = NULL;
+    unsigned int length = 0;
+    if (!conn->ssl)
+        return false;
+
+    SSL_get0_alpn_selected(conn->ssl, &protocol, &length);
+    return length == 2 && memcmp(protocol, "h2", 2) == 0;
+}
+
+static void h2_destroy(HTTP_Connection *conn, HTTP_H2_Session *session)
+{
+    while (session->streams)
+        h2_remove(session, session->streams);
+
+    HTTP_Hpack_Destroy(&session->decoder);
+    H2_Buffer *buffers[] = {&session->block, &session->fields, &session->cookie, &session->method,
+                            &session->path, &session->authority, &session->head, &session->encoded};
+    for (size_t i = 0; i < sizeof(buffers) / sizeof(buffers[0]); i++)
+        free(buffers[i]->data);
+
+    // Bytes restantes pertencem a quadros que não serão mais tratados
+    conn->buffer_used = 0;
+    conn->http2 = NULL;
+    free(session);
+}
+
+// --- Atende uma conexão HTTP/2 (modo thread) ---
+// Streams são multiplexados na conexão e respondidos na ordem de chegada; enquanto um
+// aguarda janela de envio, os quadros dos demais seguem sendo lidos e enfileirados
+void HTTP_H2_Serve(HTTP_Connection *conn)
+{
+    HTTP_H2_Session *session = calloc(1, sizeof(HTTP_H2_Session));
+    if (!session)
+    {
+        HTTP_PRINT_ERROR(stderr, "calloc failed");
+        return;
+    }
+    HTTP_Hpack_Init(&session->decoder);
+    session->window = H2_DEFAULT_WINDOW;
+    session->initial_window = H2_DEFAULT_WINDOW;
+    session->max_frame = HTTP_H2_FRAME_SIZE;
+    conn->http2 = session;
+
+    // O fim de uma janela de envio costuma ser um segmento pequeno: sem Nagle ele não espera o ACK atrasado
+    int nodelay = 1;
+    setsockopt(conn->client, IPPROTO_TCP, TCP_NODELAY, (const char *)&nodelay, sizeof(nodelay));
+
+    HTTP_Connection_Deadline(conn, HTTP_TIMEOUT_FIRST_BYTE);
+    if (!h2_fill(conn, session, H2_PREFACE_LENGTH) || memcmp(conn->buffer, H2_PREFACE, H2_PREFACE_LENGTH) != 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "invalid http2 preface");
+        h2_destroy(conn, session);
+        return;
+    }
+    session->offset = H2_PREFACE_LENGTH;
+
+    uint8_t settings[6];
+    settings[0] = 0;
+    settings[1] = H2_SETTINGS_MAX_CONCURRENT_STREAMS;
+    h2_put32(settings + 2, HTTP_H2_MAX_STREAMS);
+    h2_send(conn, session, H2_SETTINGS, 0, 0, settings, sizeof(settings));
+
+    while (*(conn->run) && !session->failed)
+    {
+        // Quadros já recebidos vêm antes: podem cancelar ou ajustar os streams na fila
+        HTTP_H2_Stream *stream = session->ready_first;
+        if (stream && !h2_frame_buffered(conn, session))
+        {
+            session->ready_first = stream->ready;
+            if (!session->ready_first)
+                session->ready_last = NULL;
+            stream->ready = NULL;
+            h2_dispatch(conn, session, stream);
+            continue;
+        }
+
+        if (!stream)
+        {
+            if (session->closing)
+                break;
+            HTTP_Connection_Deadline(conn, HTTP_TIMEOUT_IDLE);
+        }
+        if (!h2_read_frame(conn, session))
+            break;
+    }
+
+    // Encerramento gracioso: o cliente sabe até qual stream foi atendido
+    if (!session->failed)
+    {
+        uint8_t payload[8];
+        h2_put32(payload, session->last_stream);
+        h2_put32(payload + 4, H2_NO_ERROR);
+        if (h2_send(conn, session, H2_GOAWAY, 0, 0, payload, sizeof(payload)))
+            HTTP_Flush_Raw(conn);
+    }
+    h2_destroy(conn, session);
+}
@@ -3,118 +3,270 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Memória do mapa: da arena da requisição, quando houver, ou do heap
+static void *map_alloc(HTTP_Arena *arena, size_t size)
+{
+    return arena ? HTTP_Arena_Calloc(arena, size) : calloc(1, size);
+}
+
+static void map_free(HTTP_Arena *arena, void *memory)
+{
+    if (!arena)
+        free(memory);
+}
+
+static int map_hex(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// --- Amplia o vetor de segmentos além do inline, dimensionado pelas barras restantes ---
+static bool map_grow(HTTP_Map *map, size_t *capacity, const char *p, const char *end)
+{
+    size_t remaining = 1;
+    while ((p = memchr(p, '/', (size_t)(end - p))) != NULL)
+    {
+        remaining++;
+        p++;
+    }
+
+    size_t grown = map->count + remaining;
+    const char **path = map_alloc(map->arena, grown * sizeof(*path));
+    if (!path)
+    {
+        HTTP_PRINT_ERROR(stderr, "calloc failed");
+        return false;
+    }
+    memcpy(path, map->path, map->count * sizeof(*path));
+    if (map->path != map->segments)
+        map_free(map->arena, map->path);
+    map->path = path;
+    *capacity = grown;
+    return true;
+}
+
 // Extrai o mapa da requisição HTTP a partir do cabeçalho (prologue)
 // Retorna um HTTP_Map com ação, segmentos do caminho e verbos (query string)
 HTTP_Map *HTTP_Map_Get(HTTP_Header *header)
+{
+    return HTTP_Map_Get_Arena(header, NULL);
+}
+
+// Mesmo que HTTP_Map_Get, alocando na arena da requisição (NULL = heap); dispensa o destroy
+// Uma única passada pelo alvo: decodifica %XX, descarta segmentos vazios e "." e resolve
+// ".." sem sair da raiz. Retorna NULL para escapes inválidos ou que formem '\0' ou '/'.
+HTTP_Map *HTTP_Map_Get_Arena(HTTP_Header *header, HTTP_Arena *arena)
 {
     if (!header || !header->prologue)
         return NULL;
 
-    size_t prologue_len = strlen(header->prologue);
-    if (prologue_len < 1)
-        return NULL;
+    const char *line = header->prologue;
+    size_t length = strlen(line);
 
-    // Duplica a linha prologue para manipulação segura
-    char *line = malloc(prologue_len + 1);
-    if (!line)
-    {
-        HTTP_PRINT_ERROR(stderr, "malloc failed");
+    // Método e alvo: "GET /caminho?query HTTP/1.1"
+    const char *space1 = memchr(line, ' ', length);
+    if (!space1)
+        return NULL;
+    const char *p = space1 + 1;
+    const char *end = memchr(p, ' ', length - (size_t)(p - line));
+    if (!end)
         return NULL;
-    }
-    strcpy(line, header->prologue);
 
-    HTTP_Map *map = calloc(1, sizeof(HTTP_Map));
+    // O prologue é compartilhado pelos módulos: o resultado vai para o armazenamento do
+    // mapa, que nunca passa do tamanho da linha (cada terminador ocupa o lugar de um separador)
+    HTTP_Map *map = map_alloc(arena, sizeof(HTTP_Map) + length + 1);
     if (!map)
     {
-        free(line);
         HTTP_PRINT_ERROR(stderr, "calloc failed");
         return NULL;
     }
+    map->arena = arena;
+    map->path = map->segments;
 
-    map->internal = line;
+    char *out = map->storage;
+    memcpy(out, line, (size_t)(space1 - line));
+    out[space1 - line] = '\0';
+    map->method = out;
+    out += space1 - line + 1;
 
-    // Extrai ação (método HTTP), que é a primeira palavra
-    char *space1 = strchr(line, ' ');
-    if (!space1)
+    // Forma absoluta (http://host/caminho): ignora esquema e autoridade
+    if (p < end && *p != '/')
     {
-        free(line);
-        free(map);
-        return NULL;
+        const char *slash = memchr(p, '/', (size_t)(end - p));
+        if (slash && slash > p && slash[-1] == ':' && slash + 1 < end && slash[1] == '/')
+            slash = memchr(slash + 2, '/', (size_t)(end - slash - 2));
+        else
+            slash = NULL; // "*" ou alvo sem caminho
+        p = slash ? slash : end;
     }
-    *space1 = '\0';
-    map->method = line;
 
-    // Extrai URI (caminho + query), segunda palavra
-    char *space2 = strchr(space1 + 1, ' ');
-    if (!space2)
+    const char *query = HTTP_Scan_Any(p, end, '?', '#');
+    size_t capacity = HTTP_MAP_INLINE_SEGMENTS;
+    map->directory = true;
+
+    while (p < query)
     {
-        free(line);
-        free(map);
-        return NULL;
+        if (*p == '/')
+        {
+            p++;
+            continue;
+        }
+
+        char *segment = out;
+        while (p < query && *p != '/')
+        {
+            char c = *p++;
+            if (c == '%')
+            {
+                int high, low;
+                if (query - p < 2 || (high = map_hex(p[0])) < 0 || (low = map_hex(p[1])) < 0)
+                    goto invalid;
+                c = (char)(high << 4 | low);
+                p += 2;
+#ifdef _WIN32
+                if (c == '\\')
+                    goto invalid;
+#endif
+                if (c == '\0' || c == '/')
+                    goto invalid;
+            }
+            *out++ = c;
+        }
+        *out++ = '\0';
+
+        // Segmentos de ponto: "." some e ".." descarta o anterior, reaproveitando o espaço
+        size_t segment_length = (size_t)(out - segment - 1);
+        if (segment[0] == '.' && (segment_length == 1 || (segment_length == 2 && segment[1] == '.')))
+        {
+            out = segment;
+            if (segment_length == 2 && map->count)
+                out = (char *)map->path[--map->count];
+            map->directory = true;
+            continue;
+        }
+
+        if (map->count == capacity && !map_grow(map, &capacity, p, query))
+            goto invalid;
+        map->path[map->count++] = segment;
+        map->directory = p < query; // seguido de '/'
+    }
+
+    // Query string crua; os pares são decodificados sob demanda por HTTP_Map_Query
+    if (query < end && *query == '?')
+    {
+        const char *fragment = memchr(query + 1, '#', (size_t)(end - query - 1));
+        size_t query_length = (size_t)((fragment ? fragment : end) - query - 1);
+        memcpy(out, query + 1, query_length);
+        out[query_length] = '\0';
+        map->verb = out;
     }
-    *space2 = '\0';
 
-    // Pega o caminho da URI (parte após o primeiro espaço)
-    char *uri = space1 + 1;
+    return map;
 
-    // Procura os segmentos do caminho separados por '/'
-    char *segment_start = strchr(uri, '/');
-    if (!segment_start)
-        return map; // sem caminho definido, retorna só a ação
+invalid:
+    HTTP_Map_Destroy(&map);
+    return NULL;
+}
+
+// --- Reúne os segmentos em "/a/b" ("/" na raiz); false se não couber em size ---
+bool HTTP_Map_Join(const HTTP_Map *map, char *buffer, size_t size)
+{
+    if (!map || size < 2)
+        return false;
 
-    // Divide os segmentos do caminho e armazena em map->path
-    while (segment_start)
+    size_t used = 0;
+    for (size_t i = 0; i < map->count; i++)
     {
-        char *next_segment = strchr(segment_start + 1, '/');
+        size_t segment_length = strlen(map->path[i]);
+        if (size - used < segment_length + 2)
+            return false;
+        buffer[used++] = '/';
+        memcpy(buffer + used, map->path[i], segment_length);
+        used += segment_length;
+    }
+
+    if (!used)
+        buffer[used++] = '/';
+    buffer[used] = '\0';
+    return true;
+}
 
-        // Aloca ou realoca o array de segmentos
-        if (map->path)
+// Decodifica um componente da query: %XX e '+' como espaço; escapes inválidos ficam literais
+static char *map_decode_query(char *out, const char *p, const char *end)
+{
+    while (p < end)
+    {
+        char c = *p++;
+        int high, low;
+        if (c == '+')
+            c = ' ';
+        else if (c == '%' && end - p >= 2 && (high = map_hex(p[0])) >= 0 && (low = map_hex(p[1])) >= 0)
         {
-            map->count++;
-            char **tmp = realloc(map->path, map->count * sizeof(*map->path));
-            if (!tmp)
-            {
-                HTTP_PRINT_ERROR(stderr, "realloc failed");
-                free(line);
-                free(map->path);
-                free(map);
-                return NULL;
-            }
-            map->path = (const char **)tmp;
+            c = (char)(high << 4 | low);
+            p += 2;
         }
-        else
+        *out++ = c;
+    }
+    *out++ = '\0';
+    return out;
+}
+
+// --- Valor do parâmetro key da query (NULL se ausente); a query é decodificada na primeira chamada ---
+const char *HTTP_Map_Query(HTTP_Map *map, const char *key)
+{
+    if (!map || !key || !map->verb)
+        return NULL;
+
+    if (!map->params_parsed)
+    {
+        map->params_parsed = true;
+
+        size_t length = strlen(map->verb);
+        size_t pairs = 1;
+        for (const char *p = map->verb; (p = strchr(p, '&')) != NULL; p++)
+            pairs++;
+
+        // Pares e texto decodificado em um só bloco; cada par ganha no máximo um terminador extra
+        char *block = map_alloc(map->arena, pairs * sizeof(HTTP_Map_Param) + length + pairs * 2);
+        if (!block)
         {
-            map->count = 1;
-            map->path = malloc(sizeof(*map->path));
-            if (!map->path)
-            {
-                HTTP_PRINT_ERROR(stderr, "malloc failed");
-                free(line);
-                free(map);
-                return NULL;
-            }
+            HTTP_PRINT_ERROR(stderr, "calloc failed");
+            return NULL;
         }
+        map->params = (HTTP_Map_Param *)block;
+        char *out = block + pairs * sizeof(HTTP_Map_Param);
 
-        // Termina a string no '/' atual para isolar segmento e salva o segmento (sem '/')
-        *segment_start = '\0';
-        map->path[map->count - 1] = segment_start + 1;
-
-        // Se não há mais segmentos, verifica verbos (query string)
-        if (!next_segment)
+        const char *p = map->verb;
+        const char *end = p + length;
+        while (p < end)
         {
-            char *query = strchr(map->path[map->count - 1], '?');
-            if (query)
+            const char *amp = memchr(p, '&', (size_t)(end - p));
+            const char *stop = amp ? amp : end;
+            if (stop > p)
             {
-                *query = '\0';
-                map->verb = query + 1;
+                const char *equal = memchr(p, '=', (size_t)(stop - p));
+                HTTP_Map_Param *param = &map->params[map->param_count++];
+                param->key = out;
+                out = map_decode_query(out, p, equal ? equal : stop);
+                param->value = out;
+                out = map_decode_query(out, equal ? equal + 1 : stop, stop);
             }
-            break;
+            p = stop + 1;
         }
-
-        segment_start = next_segment;
     }
 
-    return map;
+    for (size_t i = 0; i < map->param_count; i++)
+    {
+        if (strcmp(map->params[i].key, key) == 0)
+            return map->params[i].value;
+    }
+    return NULL;
 }
 
 // Imprime o conteúdo do HTTP_Map para debug
@@ -143,8 +295,16 @@ void HTTP_Map_Destroy(HTTP_Map **map)
     if (!map || !*map)
         return;
 
-    free((*map)->path);
-    free((*map)->internal);
+    // Mapas na arena são liberados no reinício dela
+    if ((*map)->arena)
+    {
+        *map = NULL;
+        return;
+    }
+
+    if ((*map)->path != (*map)->segments)
+        free((*map)->path);
+    free((*map)->params);
     free(*map);
     *map = NULL;
-}
\ No newline at end of file
+}
@@ -33,25 +33,25 @@ static const char *get_mime_type(const char *filename, const file *config)
     return "application/octet-stream";
 }
 
-static char *list_dir_html(const char *path, const char *virtual_path, size_t *html_size)
+static char *list_dir_html(HTTP_Arena *arena, const char *path, const char *virtual_path, size_t *html_size)
 {
     if (!path || !virtual_path)
         return NULL;
 
-    HTML_document *document = HTML_Create_Document();
-    HTML_tag *head = HTML_Create_Tag("head", NULL, false);
-    HTML_tag *body = HTML_Create_Tag("body", NULL, false);
+    HTML_document *document = HTML_Create_Document_Arena(arena);
+    HTML_tag *head = HTML_Create_Tag_Arena(arena, "head", NULL, false);
+    HTML_tag *body = HTML_Create_Tag_Arena(arena, "body", NULL, false);
     HTML_Add_Child(document->html, head, HTML_ADD_END, 0, NULL);
     HTML_Add_Child(document->html, body, HTML_ADD_END, 0, NULL);
 
-    HTML_tag *meta = HTML_Create_Tag("meta", NULL, true);
-    HTML_Add_Attribute(&meta->attributes, HTML_Create_Attribute("charset", "UTF-8"), HTML_ADD_END, 0, NULL);
+    HTML_tag *meta = HTML_Create_Tag_Arena(arena, "meta", NULL, true);
+    HTML_Add_Attribute(&meta->attributes, HTML_Create_Attribute_Arena(arena, "charset", "UTF-8"), HTML_ADD_END, 0, NULL);
     HTML_Add_Child(head, meta, HTML_ADD_START, 0, NULL);
 
     char title_buf[PATH_MAX + 32];
     snprintf(title_buf, sizeof(title_buf), "Index of %s", virtual_path);
-    HTML_Add_Child(head, HTML_Create_Tag("title", title_buf, false), HTML_ADD_END, 0, NULL);
-    HTML_Add_Child(body, HTML_Create_Tag("h1", title_buf, false), HTML_ADD_END, 0, NULL);
+    HTML_Add_Child(head, HTML_Create_Tag_Arena(arena, "title", title_buf, false), HTML_ADD_END, 0, NULL);
+    HTML_Add_Child(body, HTML_Create_Tag_Arena(arena, "h1", title_buf, false), HTML_ADD_END, 0, NULL);
 
     DIR *dir = opendir(path);
     if (!dir)
@@ -60,15 +60,15 @@ static char *list_dir_html(const char *path, const char *virtual_path, size_t *h
         return html_error_page("The folder cannot can mapper", html_size);
     }
 
-    HTML_tag *ul = HTML_Create_Tag("ul", NULL, false);
+    HTML_tag *ul = HTML_Create_Tag_Arena(arena, "ul", NULL, false);
     HTML_Add_Child(body, ul, HTML_ADD_END, 0, NULL);
 
     if (strlen(virtual_path) > 1)
     {
-        HTML_tag *li = HTML_Create_Tag("li", NULL, false);
-        HTML_tag *span = HTML_Create_Tag("span", "[DIR] ", false);
-        HTML_tag *a = HTML_Create_Tag("a", "..", false);
-        HTML_Add_Attribute(&a->attributes, HTML_Create_Attribute("href", "../"), HTML_ADD_END, 0, NULL);
+        HTML_tag *li = HTML_Create_Tag_Arena(arena, "li", NULL, false);
+        HTML_tag *span = HTML_Create_Tag_Arena(arena, "span", "[DIR] ", false);
+        HTML_tag *a = HTML_Create_Tag_Arena(arena, "a", "..", false);
+        HTML_Add_Attribute(&a->attributes, HTML_Create_Attribute_Arena(arena, "href", "../"), HTML_ADD_END, 0, NULL);
         HTML_Add_Child(li, span, HTML_ADD_END, 0, NULL);
         HTML_Add_Child(li, a, HTML_ADD_END, 0, NULL);
         HTML_Add_Child(ul, li, HTML_ADD_END, 0, NULL);
@@ -90,10 +90,10 @@ static char *list_dir_html(const char *path, const char *virtual_path, size_t *h
         if (stat(full_path, &st) != 0)
             continue;
 
-        HTML_tag *li = HTML_Create_Tag("li", NULL, false);
-        HTML_tag *span = HTML_Create_Tag("span", S_ISDIR(st.st_mode) ? "[DIR] " : "[FILE] ", false);
-        HTML_tag *a = HTML_Create_Tag("a", entry->d_name, false);
-        HTML_Add_Attribute(&a->attributes, HTML_Create_Attribute("href", full_virtual), HTML_ADD_END, 0, NULL);
+        HTML_tag *li = HTML_Create_Tag_Arena(arena, "li", NULL, false);
+        HTML_tag *span = HTML_Create_Tag_Arena(arena, "span", S_ISDIR(st.st_mode) ? "[DIR] " : "[FILE] ", false);
+        HTML_tag *a = HTML_Create_Tag_Arena(arena, "a", entry->d_name, false);
+        HTML_Add_Attribute(&a->attributes, HTML_Create_Attribute_Arena(arena, "href", full_virtual), HTML_ADD_END, 0, NULL);
 
         HTML_Add_Child(li, span, HTML_ADD_END, 0, NULL);
         HTML_Add_Child(li, a, HTML_ADD_END, 0, NULL);
@@ -102,7 +102,7 @@ static char *list_dir_html(const char *path, const char *virtual_path, size_t *h
         {
             char buffer[64];
             snprintf(buffer, sizeof(buffer), " (%lld bytes)", (long long)st.st_size);
-            HTML_Add_Child(li, HTML_Create_Tag("span", buffer, false), HTML_ADD_END, 0, NULL);
+            HTML_Add_Child(li, HTML_Create_Tag_Arena(arena, "span", buffer, false), HTML_ADD_END, 0, NULL);
         }
 
         HTML_Add_Child(ul, li, HTML_ADD_END, 0, NULL);
@@ -118,34 +118,12 @@ static char *list_dir_html(const char *path, const char *virtual_path, size_t *h
     return html;
 }
 
-static bool send_file(const char *path, HTTP_Connection *conn, HTTP_Header *header, file *config)
+// --- Faixa pedida em Range (bytes=início-fim); falso quando a resposta é o arquivo inteiro ---
+static bool parse_range(HTTP_Header *header, uint64_t size, uint64_t *start, uint64_t *end)
 {
-    int fd = open(path, O_RDONLY);
-    if (fd < 0)
-    {
-        HTTP_PRINT_ERROR(stderr, "failed to open file: %s\n", strerror(errno));
-        return false;
-    }
-
-    struct stat st;
-    if (fstat(fd, &st) < 0)
-    {
-        HTTP_PRINT_ERROR(stderr, "failed to get file size: %s\n", strerror(errno));
-        close(fd);
-        return false;
-    }
-
-    const char *mime_type = get_mime_type(path, config);
-    HTTP_Header *response = HTTP_Header_CreateServerHeader();
-    if (!response)
-    {
-        close(fd);
-        return false;
-    }
-
-    const char *range = HTTP_Header_GetValue(header, "range");
+    const char *range = HTTP_Header_Get(header, HTTP_HEADER_RANGE);
     bool parcial = false;
-    off_t start = 0, end = 0;
+    long long first_byte = 0, last_byte = 0;
 
     if (range)
     {
@@ -159,108 +137,247 @@ static bool send_file(const char *path, HTTP_Connection *conn, HTTP_Header *head
                 *second = '\0';
                 second++;
             }
-            start = atoll(first);
-            end = second && *second ? atoll(second) : 0;
+            first_byte = atoll(first);
+            last_byte = second && *second ? atoll(second) : 0;
 
-            if (start > 0)
-            {
-                if (lseek(fd, start, SEEK_SET) < 0)
-                {
-                    free(dup);
-                    HTTP_Header_Destroy(&response);
-                    close(fd);
-                    return false;
-                }
+            if (first_byte > 0)
                 parcial = true;
-            }
         }
         free(dup);
     }
 
-    char buffer[FILE_READ_BUFFER_SIZE];
-    ssize_t bytesRead;
+    if (!parcial)
+        return false;
+
+    if (last_byte == 0 || (uint64_t)last_byte >= size)
+        last_byte = (long long)size - 1;
+    *start = (uint64_t)first_byte;
+    *end = (uint64_t)last_byte;
+    return true;
+}
 
-    if (parcial)
+// --- Variantes pré-comprimidas ao lado do arquivo (arquivo.br, arquivo.gz) ---
+typedef struct
+{
+    HTTP_Encoding encoding;
+    const char *suffix;
+} File_Variant;
+
+static const File_Variant file_variants[] = {
+    {HTTP_ENCODING_BR, ".br"},
+    {HTTP_ENCODING_GZIP, ".gz"}};
+
+#define FILE_VARIANT_COUNT (sizeof(file_variants) / sizeof(file_variants[0]))
+
+// Representação escolhida para o pedido: caminho no disco e codificação
+typedef struct
+{
+    char path[PATH_MAX];
+    HTTP_Encoding encoding;
+    bool vary;     // Existe mais de uma representação do recurso
+    bool compress; // gzip feito pelo servidor: path é o original, sem variante no disco
+} File_Choice;
+
+static void encoding_headers(HTTP_Response *response, HTTP_Encoding encoding, bool vary)
+{
+    if (encoding != HTTP_ENCODING_IDENTITY)
+        HTTP_Response_Header(response, "Content-Encoding", HTTP_Encoding_Name(encoding));
+    if (vary)
+        HTTP_Response_Header(response, "Vary", "Accept-Encoding");
+}
+
+// --- A menor representação aceita pelo cliente; empate fica com o maior peso ---
+// A existência das variantes passa pelo cache de descritores (entradas negativas inclusas),
+// então com o observador ativo a negociação não toca o disco
+static void choose_variant(const char *path, const char *mime_type, const uint16_t quality[HTTP_ENCODING_COUNT],
+                           File_Choice *choice)
+{
+    snprintf(choice->path, sizeof(choice->path), "%s", path);
+    choice->encoding = HTTP_ENCODING_IDENTITY;
+    choice->vary = false;
+    choice->compress = false;
+
+    struct stat st;
+    bool exists = HTTP_Fd_Cache_Stat(path, &st);
+    uint64_t identity_size = exists ? (uint64_t)st.st_size : 0;
+    bool chosen = exists && quality[HTTP_ENCODING_IDENTITY] > 0;
+    uint64_t best_size = identity_size;
+    bool gzip_variant = false;
+
+    for (size_t i = 0; i < FILE_VARIANT_COUNT; i++)
     {
-        if (end == 0 || end >= st.st_size)
-            end = st.st_size - 1;
+        const File_Variant *variant = &file_variants[i];
+        char variant_path[PATH_MAX];
+        if (snprintf(variant_path, sizeof(variant_path), "%s%s", path, variant->suffix) >= (int)sizeof(variant_path) ||
+            !HTTP_Fd_Cache_Stat(variant_path, &st) || !S_ISREG(st.st_mode))
+            continue;
+
+        choice->vary = true;
+        gzip_variant |= variant->encoding == HTTP_ENCODING_GZIP;
+        uint16_t weight = quality[variant->encoding];
+        uint64_t size = (uint64_t)st.st_size;
+        if (!weight || (chosen && (size > best_size ||
+                                   (size == best_size && weight <= quality[choice->encoding]))))
+            continue;
 
-        off_t range_len = end - start + 1;
-        if (range_len <= 0)
+        chosen = true;
+        best_size = size;
+        choice->encoding = variant->encoding;
+        snprintf(choice->path, sizeof(choice->path), "%s", variant_path);
+    }
+
+    // Sem .gz no disco, textos são comprimidos uma vez pelo servidor e ficam no cache de arquivos
+    if (exists && !gzip_variant && HTTP_Compress_Accepts(mime_type, identity_size))
+    {
+        choice->vary = true;
+        uint16_t weight = quality[HTTP_ENCODING_GZIP];
+        if (choice->encoding == HTTP_ENCODING_IDENTITY && weight && weight >= quality[HTTP_ENCODING_IDENTITY])
         {
-            HTTP_Header_Destroy(&response);
-            close(fd);
-            return false;
+            choice->encoding = HTTP_ENCODING_GZIP;
+            choice->compress = true;
         }
+    }
+}
 
-        char temp[128];
-        snprintf(temp, sizeof(temp), "%lld", (long long)range_len);
-        HTTP_Header_Push(response, "Content-Length", temp, true);
+// --- Cabeçalho 206 com Content-Range; falso se a faixa fica vazia ---
+// A faixa vale sobre os bytes da representação enviada (RFC 9110, seção 14.1.2)
+static bool begin_range(HTTP_Response *response, uint64_t start, uint64_t end, uint64_t size,
+                        const char *mime_type, HTTP_Encoding encoding, bool vary)
+{
+    if (end < start || start >= size)
+        return false;
 
-        snprintf(temp, sizeof(temp), "bytes %lld-%lld/%lld",
-                 (long long)start, (long long)end, (long long)st.st_size);
-        HTTP_Header_Push(response, "Content-Range", temp, true);
-        HTTP_Header_Push(response, "Content-Type", mime_type, true);
+    char temp[128];
+    snprintf(temp, sizeof(temp), "bytes %llu-%llu/%llu",
+             (unsigned long long)start, (unsigned long long)end, (unsigned long long)size);
 
-        if (!HTTP_Header_SendToClient(conn, response, 206))
-        {
-            HTTP_Header_Destroy(&response);
-            close(fd);
-            return false;
-        }
+    HTTP_Response_Begin(response, 206);
+    HTTP_Response_Length(response, end - start + 1);
+    HTTP_Response_Header(response, "Content-Range", temp);
+    HTTP_Response_Header(response, "Content-Type", mime_type);
+    encoding_headers(response, encoding, vary);
+    return true;
+}
 
-        off_t sent = 0;
-        while (sent < range_len &&
-               (bytesRead = read(fd, buffer, (size_t)MIN(FILE_READ_BUFFER_SIZE, range_len - sent))) > 0)
-        {
-            int written = HTTP_Write(conn, buffer, bytesRead);
-            if (written < 0)
-            {
-                HTTP_Header_Destroy(&response);
-                close(fd);
-                return false;
-            }
-            sent += bytesRead;
-        }
+// --- Arquivo já em memória: cabeçalho pré-montado e corpo na mesma escrita ---
+static bool send_cached(HTTP_Connection *conn, HTTP_Header *header, const HTTP_File_Hit *hit)
+{
+    // A codificação já foi negociada aqui
+    if (!HTTP_Compress_Bypass(conn))
+        return false;
+
+    HTTP_Response response;
+    uint64_t start = 0, end = hit->size ? hit->size - 1 : 0;
+    if (parse_range(header, hit->size, &start, &end))
+    {
+        if (!begin_range(&response, start, end, hit->size, hit->type, hit->encoding, hit->vary))
+            return false;
     }
     else
     {
-        char size_str[64];
-        snprintf(size_str, sizeof(size_str), "%lld", (long long)st.st_size);
-        HTTP_Header_Push(response, "Content-Length", size_str, true);
-        HTTP_Header_Push(response, "Content-Type", mime_type, true);
+        HTTP_Response_Begin(&response, 200);
+        HTTP_Response_Fields(&response, hit->fields, hit->fields_length);
+    }
+
+    if (!HTTP_Response_Send(conn, &response))
+        return false;
+    return hit->size == 0 || HTTP_Write(conn, hit->data + start, (size_t)(end - start + 1)) >= 0;
+}
+
+static bool send_file(const char *key, const char *path, HTTP_Connection *conn, HTTP_Header *header,
+                      const uint16_t quality[HTTP_ENCODING_COUNT], file *config)
+{
+    // A geração vem antes da abertura: uma mudança no meio do caminho não entra no cache
+    uint64_t generation = HTTP_File_Cache_Generation();
 
-        if (!HTTP_Header_SendToClient(conn, response, 200))
+    // O tipo é o do arquivo original, não o da variante comprimida
+    const char *mime_type = get_mime_type(path, config);
+    File_Choice choice;
+    choose_variant(path, mime_type, quality, &choice);
+
+    HTTP_File_Hit hit;
+    if (HTTP_File_Cache_Get(key, choice.encoding, &hit))
+    {
+        bool sent = send_cached(conn, header, &hit);
+        HTTP_File_Cache_Release(&hit);
+        return sent;
+    }
+
+    HTTP_Fd_Handle handle;
+    struct stat st;
+    int fd = HTTP_Fd_Cache_Open(choice.path, &st, &handle);
+    if (fd < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "failed to open file: %s\n", strerror(errno));
+        return false;
+    }
+
+    // Arquivos pequenos entram no cache; os próximos pedidos não tocam o sistema de arquivos
+    HTTP_File_Source source = {
+        .key = key,
+        .source = choice.path,
+        .type = mime_type,
+        .encoding = choice.encoding,
+        .vary = choice.vary,
+        .compress = choice.compress,
+        .generation = generation};
+    if (HTTP_File_Cache_Put(&source, fd, &hit))
+    {
+        HTTP_Fd_Cache_Release(&handle);
+        bool sent = send_cached(conn, header, &hit);
+        HTTP_File_Cache_Release(&hit);
+        return sent;
+    }
+
+    // Fora do cache o gzip do servidor fica com o filtro da resposta, que comprime o corpo
+    // enquanto ele passa; nos demais casos o filtro sai do caminho e o kernel pode enviar
+    if (choice.compress)
+        choice.encoding = HTTP_ENCODING_IDENTITY;
+    else if (!HTTP_Compress_Bypass(conn))
+    {
+        HTTP_Fd_Cache_Release(&handle);
+        return false;
+    }
+
+    // O corpo segue pela conexão, que escolhe entre sendfile/kTLS (sem cópia) e leitura em blocos
+    HTTP_Response response;
+    uint64_t size = (uint64_t)st.st_size;
+    uint64_t start = 0, end = size ? size - 1 : 0;
+    bool sent;
+    if (parse_range(header, size, &start, &end))
+    {
+        if (!begin_range(&response, start, end, size, mime_type, choice.encoding, choice.vary))
         {
-            HTTP_Header_Destroy(&response);
-            close(fd);
+            HTTP_Fd_Cache_Release(&handle);
             return false;
         }
+        sent = HTTP_Response_Send(conn, &response) &&
+               HTTP_Send_File(conn, fd, start, end - start + 1);
+    }
+    else
+    {
+        HTTP_Response_Begin(&response, 200);
+        HTTP_Response_Length(&response, size);
+        HTTP_Response_Header(&response, "Content-Type", mime_type);
+        encoding_headers(&response, choice.encoding, choice.vary);
 
-        while ((bytesRead = read(fd, buffer, FILE_READ_BUFFER_SIZE)) > 0)
-        {
-            if (HTTP_Write(conn, buffer, bytesRead) < 0)
-            {
-                HTTP_Header_Destroy(&response);
-                close(fd);
-                return false;
-            }
-        }
+        sent = HTTP_Response_Send(conn, &response) &&
+               HTTP_Send_File(conn, fd, 0, size);
     }
 
-    HTTP_Header_Destroy(&response);
-    close(fd);
-    return true;
+    HTTP_Fd_Cache_Release(&handle);
+    return sent;
 }
 
+// Candidatos ausentes ficam no cache como entradas negativas
 static char *find_default_document(const char *directory, const char **default_documents)
 {
-    static char path[PATH_MAX];
+    char path[PATH_MAX];
     for (int i = 0; default_documents[i]; i++)
     {
         snprintf(path, sizeof(path), "%s/%s", directory, default_documents[i]);
         struct stat st;
-        if (stat(path, &st) == 0 && S_ISREG(st.st_mode))
+        if (HTTP_Fd_Cache_Stat(path, &st) && S_ISREG(st.st_mode))
             return strdup(path);
     }
     return NULL;
@@ -271,42 +388,70 @@ static HTTP_Module_Response file_action(void *internal, HTTP_Connection *conn, H
     if (!internal || !conn || !header)
         return HTTP_MODULE_FAIL;
 
-    const char *connection = HTTP_Header_GetValue(header, "Connection");
+    const char *connection = HTTP_Header_Get(header, HTTP_HEADER_CONNECTION);
     HTTP_Module_Response res = (connection && strcasecmp(connection, "keep-alive") == 0)
                                    ? HTTP_MODULE_OK_HOLD
                                    : HTTP_MODULE_OK;
 
     file *config = internal;
     char full[PATH_MAX];
-    char virtual[PATH_MAX] = "/";
-    realpath(config->root, full);
+    char virtual[PATH_MAX];
+    if (config->resolved_root)
+        snprintf(full, sizeof(full), "%s", config->resolved_root);
+    else if (!realpath(config->root, full))
+        return HTTP_MODULE_FAIL;
 
-    HTTP_Map *map = HTTP_Map_Get(header);
-    for (size_t i = 0; i < map->count; i++)
+    // Caminho já decodificado e normalizado: nenhum segmento sobe acima da raiz
+    HTTP_Map *map = conn->map;
+    size_t root_length = strlen(full);
+    if (!map || !HTTP_Map_Join(map, virtual, sizeof(virtual) - 1) ||
+        root_length + strlen(virtual) >= sizeof(full))
     {
-        strncat(full, "/", sizeof(full) - strlen(full) - 1);
-        strncat(full, map->path[i], sizeof(full) - strlen(full) - 1);
+        HTTP_Response response;
+        HTTP_Response_Begin(&response, 400);
+        HTTP_Response_Length(&response, 0);
+        HTTP_Response_Send(conn, &response);
+        return HTTP_MODULE_OK;
+    }
 
-        if (*(map->path[i]))
+    // O virtual de um diretório termina em '/' para os links da listagem
+    if (map->count)
+    {
+        strcpy(full + root_length, virtual);
+        strcat(virtual, "/");
+    }
+
+    // Acerto no cache: nenhuma chamada ao sistema de arquivos. Uma entrada sem variantes
+    // comprimidas serve a qualquer Accept-Encoding enquanto o observador garante que
+    // nenhuma apareceu; nos demais casos a negociação decide
+    uint16_t quality[HTTP_ENCODING_COUNT];
+    HTTP_Accept_Encoding(header, quality);
+    bool negotiate = quality[HTTP_ENCODING_GZIP] || quality[HTTP_ENCODING_BR];
+
+    HTTP_File_Hit hit;
+    if (HTTP_File_Cache_Get(full, HTTP_ENCODING_IDENTITY, &hit))
+    {
+        if (!negotiate || (!hit.vary && HTTP_File_Watch_Active()))
         {
-            strncat(virtual, map->path[i], sizeof(virtual) - strlen(virtual) - 1);
-            strncat(virtual, "/", sizeof(virtual) - strlen(virtual) - 1);
+            send_cached(conn, header, &hit);
+            HTTP_File_Cache_Release(&hit);
+            return res;
         }
+        HTTP_File_Cache_Release(&hit);
     }
 
     struct stat st;
-    if (stat(full, &st) < 0)
+    if (!HTTP_Fd_Cache_Stat(full, &st))
     {
         size_t html_len;
         char *html = html_error_page("The requested file or directory was not found.", &html_len);
         if (html)
         {
-            HTTP_Header *response = HTTP_Header_CreateServerHeader();
-            char len_str[32];
-            snprintf(len_str, sizeof(len_str), "%zu", html_len);
-            HTTP_Header_Push(response, "Content-Type", "text/html", true);
-            HTTP_Header_Push(response, "Content-Length", len_str, true);
-            HTTP_Header_SendToClient(conn, response, 404);
+            HTTP_Response response;
+            HTTP_Response_Begin(&response, 404);
+            HTTP_Response_Header(&response, "Content-Type", "text/html");
+            HTTP_Response_Length(&response, html_len);
+            HTTP_Response_Send(conn, &response);
             HTTP_Write(conn, html, html_len);
             free(html);
         }
@@ -318,20 +463,19 @@ static HTTP_Module_Response file_action(void *internal, HTTP_Connection *conn, H
         char *index = find_default_document(full, config->default_document);
         if (index)
         {
-            send_file(index, conn, header, config);
+            send_file(full, index, conn, header, quality, config);
             free(index);
             return res;
         }
         size_t html_len;
-        char *html = list_dir_html(full, virtual, &html_len);
+        char *html = list_dir_html(&conn->arena, full, virtual, &html_len);
         if (html)
         {
-            HTTP_Header *response = HTTP_Header_CreateServerHeader();
-            char len_str[32];
-            snprintf(len_str, sizeof(len_str), "%zu", html_len);
-            HTTP_Header_Push(response, "Content-Type", "text/html", false);
-            HTTP_Header_Push(response, "Content-Length", len_str, false);
-            HTTP_Header_SendToClient(conn, response, 200);
+            HTTP_Response response;
+            HTTP_Response_Begin(&response, 200);
+            HTTP_Response_Header(&response, "Content-Type", "text/html");
+            HTTP_Response_Length(&response, html_len);
+            HTTP_Response_Send(conn, &response);
             HTTP_Write(conn, html, html_len);
             free(html);
             return res;
@@ -340,18 +484,56 @@ static HTTP_Module_Response file_action(void *internal, HTTP_Connection *conn, H
     }
     else
     {
-        send_file(full, conn, header, config);
+        send_file(full, full, conn, header, quality, config);
         return res;
     }
 
     return HTTP_MODULE_IGNORE;
 }
 
+// Arquivos são servidos para qualquer método, como antes do roteador
+// --- Instância de um worker ou shard: cópia da configuração com a raiz já resolvida ---
+static void *file_load(void)
+{
+    file *config = malloc(sizeof(file));
+    if (!config)
+    {
+        HTTP_PRINT_ERROR(stderr, "malloc");
+        return NULL;
+    }
+    *config = default_file_config;
+
+    config->resolved_root = realpath(config->root, NULL);
+    if (!config->resolved_root)
+    {
+        HTTP_PRINT_ERROR(stderr, "file root %s: %s\n", config->root, strerror(errno));
+        free(config);
+        return NULL;
+    }
+
+    // Sem o observador os caches conferem o disco sozinhos (ou ficam desligados)
+    HTTP_File_Watch(config->resolved_root);
+    return config;
+}
+
+static void file_destroy(void **internal)
+{
+    file *config = *internal;
+    free(config->resolved_root);
+    free(config);
+    *internal = NULL;
+}
+
+static const HTTP_Route file_routes[] = {
+    {HTTP_METHOD_ANY, "/*path"},
+    {0}};
+
 const HTTP_Module module_file = {
     .name = "File",
     .ver = "1.0",
     .internal = &default_file_config,
-    .load = NULL,
+    .routes = file_routes,
+    .load = file_load,
     .action = file_action,
-    .destroy = NULL};
+    .destroy = file_destroy};
 #endif
@@ -44,7 +44,7 @@ static char *find_default_document(const char *directory, const char **default_d
     return NULL;
 }
 
-static char *list_dir_html(const char *path, const char *virtual_path, size_t *html_size)
+static char *list_dir_html(HTTP_Arena *arena, const char *path, const char *virtual_path, size_t *html_size)
 {
     char search_path[MAX_PATH];
     snprintf(search_path, sizeof(search_path), "%s\\*", path);
@@ -54,25 +54,25 @@ static char *list_dir_html(const char *path, const char *virtual_path, size_t *h
     if (hFind == INVALID_HANDLE_VALUE)
         return html_error_page("Unable to list directory", html_size);
 
-    HTML_document *doc = HTML_Create_Document();
-    HTML_tag *head = HTML_Create_Tag("head", NULL, false);
-    HTML_tag *body = HTML_Create_Tag("body", NULL, false);
+    HTML_document *doc = HTML_Create_Document_Arena(arena);
+    HTML_tag *head = HTML_Create_Tag_Arena(arena, "head", NULL, false);
+    HTML_tag *body = HTML_Create_Tag_Arena(arena, "body", NULL, false);
     HTML_Add_Child(doc->html, head, HTML_ADD_END, 0, NULL);
     HTML_Add_Child(doc->html, body, HTML_ADD_END, 0, NULL);
 
-    HTML_Add_Child(head, HTML_Create_Tag("meta", NULL, true), HTML_ADD_END, 0, NULL);
-    HTML_tag *title = HTML_Create_Tag("title", virtual_path, false);
+    HTML_Add_Child(head, HTML_Create_Tag_Arena(arena, "meta", NULL, true), HTML_ADD_END, 0, NULL);
+    HTML_tag *title = HTML_Create_Tag_Arena(arena, "title", virtual_path, false);
     HTML_Add_Child(head, title, HTML_ADD_END, 0, NULL);
-    HTML_Add_Child(body, HTML_Create_Tag("h1", virtual_path, false), HTML_ADD_END, 0, NULL);
+    HTML_Add_Child(body, HTML_Create_Tag_Arena(arena, "h1", virtual_path, false), HTML_ADD_END, 0, NULL);
 
-    HTML_tag *ul = HTML_Create_Tag("ul", NULL, false);
+    HTML_tag *ul = HTML_Create_Tag_Arena(arena, "ul", NULL, false);
     HTML_Add_Child(body, ul, HTML_ADD_END, 0, NULL);
 
     if (strlen(virtual_path) > 1)
     {
-        HTML_tag *li = HTML_Create_Tag("li", NULL, false);
-        HTML_tag *a = HTML_Create_Tag("a", "..", false);
-        HTML_Add_Attribute(&a->attributes, HTML_Create_Attribute("href", "../"), HTML_ADD_END, 0, NULL);
+        HTML_tag *li = HTML_Create_Tag_Arena(arena, "li", NULL, false);
+        HTML_tag *a = HTML_Create_Tag_Arena(arena, "a", "..", false);
+        HTML_Add_Attribute(&a->attributes, HTML_Create_Attribute_Arena(arena, "href", "../"), HTML_ADD_END, 0, NULL);
         HTML_Add_Child(li, a, HTML_ADD_END, 0, NULL);
         HTML_Add_Child(ul, li, HTML_ADD_END, 0, NULL);
     }
@@ -82,14 +82,14 @@ static char *list_dir_html(const char *path, const char *virtual_path, size_t *h
         if (!strcmp(fd.cFileName, ".") || !strcmp(fd.cFileName, ".."))
             continue;
 
-        HTML_tag *li = HTML_Create_Tag("li", NULL, false);
-        HTML_tag *span = HTML_Create_Tag("span", (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? "[DIR] " : "[FILE] ", false);
-        HTML_tag *a = HTML_Create_Tag("a", fd.cFileName, false);
+        HTML_tag *li = HTML_Create_Tag_Arena(arena, "li", NULL, false);
+        HTML_tag *span = HTML_Create_Tag_Arena(arena, "span", (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? "[DIR] " : "[FILE] ", false);
+        HTML_tag *a = HTML_Create_Tag_Arena(arena, "a", fd.cFileName, false);
 
         char href[PATH_MAX];
         snprintf(href, sizeof(href), "%s%s%s", virtual_path, fd.cFileName,
                  (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? "/" : "");
-        HTML_Add_Attribute(&a->attributes, HTML_Create_Attribute("href", href), HTML_ADD_END, 0, NULL);
+        HTML_Add_Attribute(&a->attributes, HTML_Create_Attribute_Arena(arena, "href", href), HTML_ADD_END, 0, NULL);
 
         HTML_Add_Child(li, span, HTML_ADD_END, 0, NULL);
         HTML_Add_Child(li, a, HTML_ADD_END, 0, NULL);
@@ -99,7 +99,7 @@ static char *list_dir_html(const char *path, const char *virtual_path, size_t *h
             ULONGLONG size = ((ULONGLONG)fd.nFileSizeHigh << 32) | fd.nFileSizeLow;
             char info[64];
             snprintf(info, sizeof(info), " (%llu bytes)", size);
-            HTML_Add_Child(li, HTML_Create_Tag("span", info, false), HTML_ADD_END, 0, NULL);
+            HTML_Add_Child(li, HTML_Create_Tag_Arena(arena, "span", info, false), HTML_ADD_END, 0, NULL);
         }
 
         HTML_Add_Child(ul, li, HTML_ADD_END, 0, NULL);
@@ -135,14 +135,7 @@ static bool send_file(const char *path, HTTP_Connection *conn, HTTP_Header *head
     }
 
     const char *mime = get_mime_type(path, config);
-    HTTP_Header *response = HTTP_Header_CreateServerHeader();
-    if (!response)
-    {
-        CloseHandle(hFile);
-        return false;
-    }
-
-    const char *range = HTTP_Header_GetValue(header, "range");
+    const char *range = HTTP_Header_Get(header, HTTP_HEADER_RANGE);
     bool partial = false;
     LARGE_INTEGER start = {0}, end = {0};
 
@@ -161,7 +154,6 @@ static bool send_file(const char *path, HTTP_Connection *conn, HTTP_Header *head
             {
                 free(dup);
                 CloseHandle(hFile);
-                HTTP_Header_Destroy(&response);
                 return false;
             }
             partial = true;
@@ -170,18 +162,19 @@ static bool send_file(const char *path, HTTP_Connection *conn, HTTP_Header *head
     }
 
     char temp[128];
+    HTTP_Response response;
     DWORD bytes;
     char buffer[FILE_READ_BUFFER_SIZE];
 
     if (partial)
     {
         LONGLONG len = end.QuadPart - start.QuadPart + 1;
-        snprintf(temp, sizeof(temp), "%lld", len);
-        HTTP_Header_Push(response, "Content-Length", temp, true);
         snprintf(temp, sizeof(temp), "bytes %lld-%lld/%lld", start.QuadPart, end.QuadPart, size.QuadPart);
-        HTTP_Header_Push(response, "Content-Range", temp, true);
-        HTTP_Header_Push(response, "Content-Type", mime, true);
-        HTTP_Header_SendToClient(conn, response, 206);
+        HTTP_Response_Begin(&response, 206);
+        HTTP_Response_Length(&response, (uint64_t)len);
+        HTTP_Response_Header(&response, "Content-Range", temp);
+        HTTP_Response_Header(&response, "Content-Type", mime);
+        HTTP_Response_Send(conn, &response);
 
         LONGLONG sent = 0;
         while (sent < len && ReadFile(hFile, buffer, (DWORD)min(FILE_READ_BUFFER_SIZE, len - sent), &bytes, NULL) && bytes > 0)
@@ -193,10 +186,10 @@ static bool send_file(const char *path, HTTP_Connection *conn, HTTP_Header *head
     }
     else
     {
-        snprintf(temp, sizeof(temp), "%lld", size.QuadPart);
-        HTTP_Header_Push(response, "Content-Length", temp, true);
-        HTTP_Header_Push(response, "Content-Type", mime, true);
-        HTTP_Header_SendToClient(conn, response, 200);
+        HTTP_Response_Begin(&response, 200);
+        HTTP_Response_Length(&response, (uint64_t)size.QuadPart);
+        HTTP_Response_Header(&response, "Content-Type", mime);
+        HTTP_Response_Send(conn, &response);
 
         while (ReadFile(hFile, buffer, FILE_READ_BUFFER_SIZE, &bytes, NULL) && bytes > 0)
         {
@@ -205,7 +198,6 @@ static bool send_file(const char *path, HTTP_Connection *conn, HTTP_Header *head
         }
     }
 
-    HTTP_Header_Destroy(&response);
     CloseHandle(hFile);
     return true;
 }
@@ -216,20 +208,28 @@ static HTTP_Module_Response file_action(void *internal, HTTP_Connection *conn, H
         return HTTP_MODULE_FAIL;
 
     file *config = internal;
-    char full[MAX_PATH], virtual[MAX_PATH] = "/";
-    DWORD len = GetFullPathNameA(config->root, MAX_PATH, full, NULL);
-    if (len == 0 || len > MAX_PATH)
+    char full[MAX_PATH], virtual[MAX_PATH];
+    DWORD len = config->resolved_root ? (DWORD)strlen(config->resolved_root) : GetFullPathNameA(config->root, MAX_PATH, full, NULL);
+    if (len == 0 || len >= MAX_PATH)
         return HTTP_MODULE_FAIL;
+    if (config->resolved_root)
+        memcpy(full, config->resolved_root, len + 1);
 
-    HTTP_Map *map = HTTP_Map_Get(header);
-    for (size_t i = 0; i < map->count; i++)
+    // Caminho já decodificado e normalizado: nenhum segmento sobe acima da raiz
+    HTTP_Map *map = conn->map;
+    if (!map || !HTTP_Map_Join(map, virtual, sizeof(virtual) - 1) ||
+        len + strlen(virtual) >= sizeof(full))
     {
-        PathAppendA(full, map->path[i]);
-        if (*(map->path[i]))
-        {
-            strcat(virtual, map->path[i]);
-            strcat(virtual, "/");
-        }
+        HTTP_Response resp;
+        HTTP_Response_Begin(&resp, 400);
+        HTTP_Response_Length(&resp, 0);
+        HTTP_Response_Send(conn, &resp);
+        return HTTP_MODULE_OK;
+    }
+    if (map->count)
+    {
+        strcpy(full + len, virtual);
+        strcat(virtual, "/");
     }
 
     DWORD attr = GetFileAttributesA(full);
@@ -239,12 +239,11 @@ static HTTP_Module_Response file_action(void *internal, HTTP_Connection *conn, H
         char *html = html_error_page("File or directory not found", &html_size);
         if (html)
         {
-            HTTP_Header *resp = HTTP_Header_CreateServerHeader();
-            char sz[32];
-            snprintf(sz, sizeof(sz), "%zu", html_size);
-            HTTP_Header_Push(resp, "Content-Type", "text/html", true);
-            HTTP_Header_Push(resp, "Content-Length", sz, true);
-            HTTP_Header_SendToClient(conn, resp, 404);
+            HTTP_Response resp;
+            HTTP_Response_Begin(&resp, 404);
+            HTTP_Response_Header(&resp, "Content-Type", "text/html");
+            HTTP_Response_Length(&resp, html_size);
+            HTTP_Response_Send(conn, &resp);
             HTTP_Write(conn, html, html_size);
             free(html);
         }
@@ -261,15 +260,14 @@ static HTTP_Module_Response file_action(void *internal, HTTP_Connection *conn, H
             return HTTP_MODULE_OK;
         }
         size_t html_len;
-        char *html = list_dir_html(full, virtual, &html_len);
+        char *html = list_dir_html(&conn->arena, full, virtual, &html_len);
         if (html)
         {
-            char sz[32];
-            snprintf(sz, sizeof(sz), "%zu", html_len);
-            HTTP_Header *resp = HTTP_Header_CreateServerHeader();
-            HTTP_Header_Push(resp, "Content-Type", "text/html", true);
-            HTTP_Header_Push(resp, "Content-Length", sz, true);
-            HTTP_Header_SendToClient(conn, resp, 200);
+            HTTP_Response resp;
+            HTTP_Response_Begin(&resp, 200);
+            HTTP_Response_Header(&resp, "Content-Type", "text/html");
+            HTTP_Response_Length(&resp, html_len);
+            HTTP_Response_Send(conn, &resp);
             HTTP_Write(conn, html, html_len);
             free(html);
             return HTTP_MODULE_OK;
@@ -281,12 +279,52 @@ static HTTP_Module_Response file_action(void *internal, HTTP_Connection *conn, H
     return HTTP_MODULE_OK;
 }
 
+// Arquivos são servidos para qualquer método, como antes do roteador
+// --- Instância de um worker ou shard: cópia da configuração com a raiz já resolvida ---
+static void *file_load(void)
+{
+    file *config = malloc(sizeof(file));
+    char *root = malloc(MAX_PATH);
+    if (!config || !root)
+    {
+        HTTP_PRINT_ERROR(stderr, "malloc");
+        free(config);
+        free(root);
+        return NULL;
+    }
+    *config = default_file_config;
+
+    DWORD len = GetFullPathNameA(config->root, MAX_PATH, root, NULL);
+    if (len == 0 || len >= MAX_PATH)
+    {
+        HTTP_PRINT_ERROR(stderr, "file root %s: GetFullPathNameA failed\n", config->root);
+        free(config);
+        free(root);
+        return NULL;
+    }
+    config->resolved_root = root;
+    return config;
+}
+
+static void file_destroy(void **internal)
+{
+    file *config = *internal;
+    free(config->resolved_root);
+    free(config);
+    *internal = NULL;
+}
+
+static const HTTP_Route file_routes[] = {
+    {HTTP_METHOD_ANY, "/*path"},
+    {0}};
+
 const HTTP_Module module_file = {
     .name = "File",
     .ver = "1.1",
     .internal = &default_file_config,
-    .load = NULL,
+    .routes = file_routes,
+    .load = file_load,
     .action = file_action,
-    .destroy = NULL};
+    .destroy = file_destroy};
     
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -6,57 +6,46 @@ static HTTP_Module_Response hello_world_action(void *internal, HTTP_Connection *
     (void)internal;
     (void)header;
 
-    const char *connection = HTTP_Header_GetValue(header, "Connection");
+    const char *connection = HTTP_Header_Get(header, HTTP_HEADER_CONNECTION);
     bool hold = connection ? (strcasecmp(connection, "keep-alive") == 0) : false;
 
-    HTML_document *doc = HTML_Create_Document();
-    HTML_tag *head = HTML_Create_Tag("head", NULL, false);
-    HTML_tag *body = HTML_Create_Tag("body", NULL, false);
+    HTML_document *doc = HTML_Create_Document_Arena(&conn->arena);
+    HTML_tag *head = HTML_Create_Tag_Arena(&conn->arena, "head", NULL, false);
+    HTML_tag *body = HTML_Create_Tag_Arena(&conn->arena, "body", NULL, false);
 
     HTML_Add_Child(doc->html, head, HTML_ADD_END, 0, NULL);
     HTML_Add_Child(doc->html, body, HTML_ADD_END, 0, NULL);
 
-    HTML_tag *meta = HTML_Create_Tag("meta", NULL, true);
+    HTML_tag *meta = HTML_Create_Tag_Arena(&conn->arena, "meta", NULL, true);
     HTML_Add_Child(body, meta, HTML_ADD_END, 0, NULL);
 
-    HTML_Add_Attribute(&meta->attributes, HTML_Create_Attribute("charset", "UTF-8"), HTML_ADD_END, 0, NULL);
+    HTML_Add_Attribute(&meta->attributes, HTML_Create_Attribute_Arena(&conn->arena, "charset", "UTF-8"), HTML_ADD_END, 0, NULL);
 
-    HTML_tag *h1 = HTML_Create_Tag("h1", "Hello World!", false);
+    HTML_tag *h1 = HTML_Create_Tag_Arena(&conn->arena, "h1", "Hello World!", false);
     HTML_Add_Child(body, h1, HTML_ADD_END, 0, NULL);
 
-    HTTP_Header *response = HTTP_Header_CreateServerHeader();
-    if (!response)
-    {
-        HTTP_PRINT_ERROR(stderr, "failed to create response header\n");
-        return HTTP_MODULE_FAIL;
-    }
-
     size_t html_len = HTML_Document_LookupSize(doc);
 
-    char *html = malloc(html_len);
+    char *html = HTTP_Arena_Alloc(&conn->arena, html_len);
+    if (!html)
+        return HTTP_MODULE_FAIL;
 
     html_len = HTML_Document_Fill(doc, html, html_len);
 
-    char length_str[32];
-    snprintf(length_str, sizeof(length_str), "%zu", html_len);
-
-    HTTP_Header_Push(response, "Content-Type", "text/html", true);
-    HTTP_Header_Push(response, "Content-Length", length_str, true);
+    HTTP_Response response;
+    HTTP_Response_Begin(&response, 200);
+    HTTP_Response_Header(&response, "Content-Type", "text/html");
+    HTTP_Response_Length(&response, html_len);
 
     HTML_Destroy_Document(&doc);
-    if (!HTTP_Header_SendToClient(conn, response, 200))
+    if (!HTTP_Response_Send(conn, &response))
     {
         HTTP_PRINT_ERROR(stderr, "failed to send HTTP header\n");
-        HTTP_Header_Destroy(&response);
-        free(html);
         return HTTP_MODULE_FAIL;
     }
 
     int sent = HTTP_Write(conn, html, html_len);
 
-    free(html);
-    HTTP_Header_Destroy(&response);
-
     if (sent < 0)
     {
         HTTP_PRINT_ERROR(stderr, "failed to send response body\n");
@@ -70,6 +59,7 @@ const HTTP_Module module_hello_world = {
     .name = "Hello World",
     .ver = "1.0",
     .internal = NULL,
+    .routes = NULL, // Resposta final para o que os módulos anteriores ignorarem
     .load = NULL,
     .action = hello_world_action,
     .destroy = NULL};
@@ -0,0 +1,74 @@
+#include <nero_module.h>
+#include <stdlib.h>
+
+// Instância vinculada à thread atual (workers); as demais usam a do gerenciador da conexão
+static _Thread_local HTTP_Module_Set *module_current = NULL;
+
+// --- Chama load de cada módulo e guarda os internals desta instância ---
+// Módulos sem load compartilham o internal estático; load que retorna NULL é falha
+HTTP_Module_Set *HTTP_Modules_Load(const HTTP_Module **modules)
+{
+    size_t count = 0;
+    while (modules && modules[count])
+        count++;
+
+    HTTP_Module_Set *set = calloc(1, sizeof(HTTP_Module_Set) + count * sizeof(void *));
+    if (!set)
+    {
+        HTTP_PRINT_ERROR(stderr, "calloc");
+        return NULL;
+    }
+    set->modules = modules;
+
+    for (; set->count < count; set->count++)
+    {
+        const HTTP_Module *module = modules[set->count];
+        set->internal[set->count] = module->load ? module->load() : module->internal;
+        if (module->load && !set->internal[set->count])
+        {
+            HTTP_PRINT_ERROR(stderr, "module load failed: %s\n", module->name);
+            HTTP_Modules_Unload(&set);
+            return NULL;
+        }
+    }
+    return set;
+}
+
+// --- Chama destroy nas instâncias criadas por load, na ordem inversa ---
+void HTTP_Modules_Unload(HTTP_Module_Set **set)
+{
+    if (!set || !*set)
+        return;
+
+    while ((*set)->count > 0)
+    {
+        size_t index = --(*set)->count;
+        const HTTP_Module *module = (*set)->modules[index];
+        if (module->load && module->destroy)
+            module->destroy(&(*set)->internal[index]);
+    }
+
+    if (module_current == *set)
+        module_current = NULL;
+    free(*set);
+    *set = NULL;
+}
+
+// --- Vincula a instância à thread que chama (NULL desfaz) ---
+void HTTP_Modules_Bind(HTTP_Module_Set *set)
+{
+    module_current = set;
+}
+
+// --- internal do módulo de índice index para quem atende conn ---
+void *HTTP_Module_Internal(HTTP_Connection *conn, size_t index)
+{
+    HTTP_Module_Set *set = module_current;
+    if (!set && conn->manager)
+        set = conn->manager->modules_set;
+    if (set && index < set->count)
+        return set->internal[index];
+
+    const HTTP_Module **modules = (const HTTP_Module **)conn->modules;
+    return modules[index]->internal;
+}
@@ -2,7 +2,9 @@
 #include <nero_module.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <signal.h>
+#include <errno.h>
 
 // --- Módulos registrados ---
 extern const HTTP_Module module_hello_world;
@@ -17,16 +19,316 @@ const HTTP_Module *defaults_all_modules[] = {
 // --- Controle de execução ---
 static bool run = true;
 
+static volatile bool print_stats = false;
+
+// "h2" só entra no ALPN quando cada conexão tem thread própria (o laço HTTP/2 é bloqueante)
+static bool http2_enabled = false;
+
 static void handle_close(int sig)
 {
     printf("Received signal %d, shutting down...\n", sig);
     run = false;
 }
 
-int main()
+#ifndef _WIN32
+static void handle_stats(int sig)
+{
+    (void)sig;
+    print_stats = true;
+}
+#endif
+
+// --- Opções de linha de comando ---
+typedef struct
+{
+    HTTP_Server_Mode mode;
+    int loops;        // Número de laços do reactor
+    int workers;      // Workers que executam os módulos (0 = no próprio laço)
+    size_t queue;     // Capacidade da fila de conexões prontas
+    int shards;       // Laços com socket SO_REUSEPORT próprio (0 = socket compartilhado)
+    int backlog;      // Fila de conexões pendentes do listen()
+    int accept_batch; // Máximo de accept4() por evento
+    int timeouts[HTTP_TIMEOUT_COUNT]; // Prazos por etapa da conexão (ms, 0 = sem limite)
+    HTTP_TLS_Options tls;             // Cache de sessões, tickets e 0-RTT
+    size_t file_cache;                // Orçamento do cache de arquivos em memória (0 = desativado)
+    size_t fd_cache;                  // Descritores mantidos abertos pelo cache de metadados (0 = desativado)
+    int compress;                     // Nível do gzip das respostas (0 = desativado)
+    size_t compress_min;              // Menor corpo comprimido
+} HTTP_Options;
+
+// --- Opções de prazo: --<nome>-timeout=ms ---
+static const char *timeout_options[HTTP_TIMEOUT_COUNT] = {
+    [HTTP_TIMEOUT_HANDSHAKE] = "--handshake-timeout=",
+    [HTTP_TIMEOUT_FIRST_BYTE] = "--first-byte-timeout=",
+    [HTTP_TIMEOUT_HEADER] = "--header-timeout=",
+    [HTTP_TIMEOUT_IDLE] = "--idle-timeout=",
+    [HTTP_TIMEOUT_WRITE] = "--write-timeout=",
+};
+
+static bool parse_timeout(const char *arg, HTTP_Options *options)
+{
+    for (int i = 0; i < HTTP_TIMEOUT_COUNT; i++)
+    {
+        size_t length = strlen(timeout_options[i]);
+        if (strncmp(arg, timeout_options[i], length) == 0)
+        {
+            int ms = atoi(arg + length);
+            options->timeouts[i] = ms > 0 ? ms : 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int default_loops(void)
+{
+#ifdef _WIN32
+    return 1;
+#else
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+#endif
+}
+
+// --- Contexto TLS: certificado, ALPN e retomada de sessões ---
+static SSL_CTX *create_ssl_context(const HTTP_TLS_Options *options)
+{
+    SSL_CTX *ctx = SSL_CTX_new(TLS_server_method());
+    if (!ctx)
+    {
+        HTTP_PRINT_SSL_ERROR(stderr, "SSL_CTX_new failed");
+        return NULL;
+    }
+
+    if (!SSL_CTX_use_certificate_file(ctx, "cert.pem", SSL_FILETYPE_PEM) ||
+        !SSL_CTX_use_PrivateKey_file(ctx, "key.pem", SSL_FILETYPE_PEM))
+    {
+        HTTP_PRINT_SSL_ERROR(stderr, "Erro carregando cert.pem/key.pem");
+        SSL_CTX_free(ctx);
+        return NULL;
+    }
+    SSL_CTX_set_alpn_select_cb(ctx, HTTP_H2_Select_ALPN, &http2_enabled);
+
+    // Clientes que voltam retomam a sessão (cache compartilhado ou ticket) sem o handshake completo
+    if (!HTTP_TLS_Setup(ctx, options))
+    {
+        SSL_CTX_free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+static void parse_options(int argc, char **argv, HTTP_Options *options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--mode=thread") == 0)
+            options->mode = HTTP_MODE_THREAD;
+        else if (strcmp(arg, "--mode=reactor") == 0)
+            options->mode = HTTP_MODE_REACTOR;
+        else if (strcmp(arg, "--mode=uring") == 0)
+            options->mode = HTTP_MODE_URING;
+        else if (strncmp(arg, "--loops=", 8) == 0)
+            options->loops = atoi(arg + 8);
+        else if (strncmp(arg, "--workers=", 10) == 0)
+            options->workers = atoi(arg + 10);
+        else if (strncmp(arg, "--queue=", 8) == 0)
+            options->queue = (size_t)strtoul(arg + 8, NULL, 10);
+        else if (strncmp(arg, "--shards=", 9) == 0)
+        {
+            if (options->mode != HTTP_MODE_URING)
+                options->mode = HTTP_MODE_REACTOR;
+            options->shards = atoi(arg + 9);
+            if (options->shards < 1)
+                options->shards = default_loops();
+        }
+        else if (strncmp(arg, "--backlog=", 10) == 0)
+            options->backlog = atoi(arg + 10);
+        else if (strncmp(arg, "--accept-batch=", 15) == 0)
+            options->accept_batch = atoi(arg + 15);
+        else if (strncmp(arg, "--tls-cache=", 12) == 0)
+            options->tls.cache_bytes = (size_t)strtoull(arg + 12, NULL, 10);
+        else if (strncmp(arg, "--ticket-rotate=", 16) == 0)
+            options->tls.ticket_rotate = atoi(arg + 16);
+        else if (strncmp(arg, "--ticket-secret=", 16) == 0)
+            options->tls.ticket_secret = arg + 16;
+        else if (strcmp(arg, "--early-data") == 0)
+            options->tls.early_data = true;
+        else if (strcmp(arg, "--ktls") == 0)
+            options->tls.ktls = true;
+        else if (strncmp(arg, "--file-cache=", 13) == 0)
+            options->file_cache = (size_t)strtoull(arg + 13, NULL, 10);
+        else if (strncmp(arg, "--fd-cache=", 11) == 0)
+            options->fd_cache = (size_t)strtoull(arg + 11, NULL, 10);
+        else if (strncmp(arg, "--compress=", 11) == 0)
+            options->compress = atoi(arg + 11);
+        else if (strncmp(arg, "--compress-min=", 15) == 0)
+            options->compress_min = (size_t)strtoull(arg + 15, NULL, 10);
+        else if (strcmp(arg, "--no-tls") == 0)
+            options->tls.enabled = false;
+        else if (parse_timeout(arg, options))
+            continue;
+        else
+            fprintf(stderr, "Unknown option ignored: %s\n", arg);
+    }
+
+    if (options->shards > 0)
+        options->loops = options->shards;
+    if (options->loops < 1)
+        options->loops = default_loops();
+    if (options->backlog < 1)
+        options->backlog = HTTP_DEFAULT_BACKLOG;
+    if (options->accept_batch < 1)
+        options->accept_batch = HTTP_DEFAULT_ACCEPT_BATCH;
+    if (options->workers < 0)
+        options->workers = 0;
+    if (options->queue < 1)
+        options->queue = 4096;
+}
+
+// --- Conexões aceitas/ativas por laço, para verificar o balanceamento entre shards ---
+static void print_reactor_stats(HTTP_Connection_Manager *reactors, int count)
+{
+    for (int i = 0; i < count; i++)
+        printf("Laço %d: %zu aceitas, %zu ativas\n", i, reactors[i].accepted, reactors[i].count);
+    HTTP_Stats_Print(stdout);
+}
+
+// --- Modo reactor: laços epoll (ou io_uring) compartilhando o socket de escuta ou com um socket por shard ---
+static bool run_reactor(HTTP_Connection_Manager *manager, const HTTP_Options *options)
+{
+    int loops = options->loops;
+    bool uring = options->mode == HTTP_MODE_URING;
+    HTTP_Connection_Manager *reactors = calloc((size_t)loops, sizeof(HTTP_Connection_Manager));
+    if (!reactors)
+    {
+        HTTP_PRINT_ERROR(stderr, "calloc");
+        return false;
+    }
+
+    // No io_uring os módulos executam no laço, que já envia as respostas em lote
+    if (uring && options->workers > 0)
+        printf("Workers ignorados no modo io_uring\n");
+    else if (options->workers > 0)
+    {
+        manager->pool = HTTP_Worker_Pool_Create(options->workers, options->queue, manager->modules);
+        if (!manager->pool)
+            printf("Pool de workers indisponível, módulos executam nos laços\n");
+    }
+
+    int started = 0;
+    for (; started < loops; started++)
+    {
+        HTTP_Connection_Manager *shard = &reactors[started];
+        *shard = *manager;
+        shard->events = -1;
+
+        // Shards: cada laço tem o próprio socket e núcleo; o kernel distribui as conexões
+        if (options->shards > 0)
+        {
+            shard->cpu = started % default_loops();
+            if (started > 0)
+            {
+                shard->server = HTTP_Listen(PORT, options->backlog, true);
+                if (shard->server < 0)
+                    break;
+            }
+        }
+
+        // Instância dos módulos do laço (requisições atendidas sem workers)
+        shard->modules_set = HTTP_Modules_Load((const HTTP_Module **)shard->modules);
+        if (!shard->modules_set)
+        {
+            if (shard->server != manager->server)
+                close_socket(shard->server);
+            break;
+        }
+
+        // io_uring indisponível no primeiro laço: todos os laços recaem no epoll
+        bool ok = uring && HTTP_Uring_Start(shard);
+        if (uring && !ok && started == 0)
+        {
+            printf("io_uring indisponível, usando epoll\n");
+            uring = false;
+        }
+        if (!uring)
+            ok = HTTP_Reactor_Start(shard);
+
+        if (!ok)
+        {
+            HTTP_Modules_Unload(&shard->modules_set);
+            if (shard->server != manager->server)
+                close_socket(shard->server);
+            break;
+        }
+    }
+
+    if (started == 0)
+    {
+        HTTP_Worker_Pool_Destroy(&manager->pool);
+        free(reactors);
+        return false;
+    }
+
+    printf("%s com %d %s e %d worker(s) ativo(s)\n", uring ? "io_uring" : "Reactor", started,
+           options->shards > 0 ? "shard(s) SO_REUSEPORT" : "laço(s)", manager->pool ? options->workers : 0);
+    while (run)
+    {
+        poll_socket(NULL, 0, 100);
+        if (print_stats)
+        {
+            print_stats = false;
+            print_reactor_stats(reactors, started);
+        }
+    }
+
+    // Workers terminam a requisição atual antes dos laços liberarem as conexões
+    HTTP_Worker_Pool_Destroy(&manager->pool);
+    for (int i = 0; i < started; i++)
+    {
+        if (uring)
+            HTTP_Uring_Stop(&reactors[i]);
+        else
+            HTTP_Reactor_Stop(&reactors[i]);
+        HTTP_Modules_Unload(&reactors[i].modules_set);
+        if (reactors[i].server != manager->server)
+            close_socket(reactors[i].server);
+    }
+    print_reactor_stats(reactors, started);
+    free(reactors);
+    return true;
+}
+
+int main(int argc, char **argv)
 {
+    HTTP_Options options = {
+        .mode = HTTP_MODE_THREAD,
+        .timeouts = {
+            [HTTP_TIMEOUT_HANDSHAKE] = HTTP_DEFAULT_HANDSHAKE_TIMEOUT_MS,
+            [HTTP_TIMEOUT_FIRST_BYTE] = HTTP_DEFAULT_FIRST_BYTE_TIMEOUT_MS,
+            [HTTP_TIMEOUT_HEADER] = HTTP_DEFAULT_HEADER_TIMEOUT_MS,
+            [HTTP_TIMEOUT_IDLE] = HTTP_DEFAULT_IDLE_TIMEOUT_MS,
+            [HTTP_TIMEOUT_WRITE] = HTTP_DEFAULT_WRITE_TIMEOUT_MS,
+        },
+        .tls = {
+            .enabled = USE_SSL,
+            .cache_bytes = HTTP_TLS_CACHE_BYTES,
+            .ticket_rotate = HTTP_TLS_TICKET_ROTATE_S,
+        },
+        .file_cache = HTTP_FILE_CACHE_BYTES,
+        .fd_cache = HTTP_FD_CACHE_MAX,
+        .compress = HTTP_COMPRESS_LEVEL,
+        .compress_min = HTTP_COMPRESS_MIN,
+    };
+    parse_options(argc, argv, &options);
+
     // --- Tratador de sinal para encerramento gracioso ---
     signal(SIGINT, handle_close);
+#ifndef _WIN32
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGUSR1, handle_stats);
+#endif
 
     // --- Inicialização de rede (Windows) ---
 #ifdef _WIN32
@@ -38,100 +340,153 @@ int main()
     }
 #endif
 
+    // --- Núcleos de varredura do cabeçalho conforme a CPU ---
+    HTTP_Scan_Init();
+
+    // --- Arquivos pequenos e frequentes servidos da memória; descritores e stat() reaproveitados ---
+    HTTP_File_Cache_Setup(options.file_cache);
+    HTTP_Fd_Cache_Setup(options.fd_cache);
+
+    // --- Respostas de texto comprimidas com gzip para quem aceita ---
+    HTTP_Compress_Setup(options.compress, options.compress_min);
+
     // --- Inicialização OpenSSL ---
     SSL_library_init();
     SSL_load_error_strings();
     OpenSSL_add_all_algorithms();
 
-    SSL_CTX *ctx = SSL_CTX_new(TLS_server_method());
-    if (!ctx)
+    // Sem TLS (--no-tls) as conexões seguem em texto puro e HTTP/2 fica indisponível
+    SSL_CTX *ctx = NULL;
+    if (options.tls.enabled && !(ctx = create_ssl_context(&options.tls)))
     {
-        HTTP_PRINT_SSL_ERROR(stderr, "SSL_CTX_new failed");
+        HTTP_TLS_Cleanup();
         return 1;
     }
 
-    if (!SSL_CTX_use_certificate_file(ctx, "cert.pem", SSL_FILETYPE_PEM) ||
-        !SSL_CTX_use_PrivateKey_file(ctx, "key.pem", SSL_FILETYPE_PEM))
+    // --- Configuração do gerenciador de conexões ---
+    HTTP_Connection_Manager manager = {0};
+    manager.ssl_ctx = ctx;
+    manager.modules = (void **)defaults_all_modules;
+    manager.router = HTTP_Router_Create(defaults_all_modules);
+    if (!manager.router)
     {
-        HTTP_PRINT_SSL_ERROR(stderr, "Erro carregando cert.pem/key.pem");
         SSL_CTX_free(ctx);
+        HTTP_TLS_Cleanup();
         return 1;
     }
+    manager.events = -1;
+    manager.notify = -1;
 
-    // --- Configuração do gerenciador de conexões ---
-    HTTP_Connection_Manager manager = {0};
-    manager.ssl_ctx = ctx;
-    manager.modules = (void **)defaults_all_modules;
+    manager.accept_batch = options.accept_batch;
+    manager.cpu = -1;
+    memcpy(manager.timeouts, options.timeouts, sizeof(manager.timeouts));
 
     // --- Criação do socket ---
-    manager.server = socket(AF_INET, SOCK_STREAM, 0);
+    manager.server = HTTP_Listen(PORT, options.backlog, options.shards > 0);
     if (manager.server < 0)
     {
-        HTTP_PRINT_ERROR(stderr, "socket");
+        HTTP_Router_Destroy(&manager.router);
         SSL_CTX_free(ctx);
+        HTTP_TLS_Cleanup();
         return 1;
     }
 
-    struct sockaddr_in server_addr = {
-        .sin_family = AF_INET,
-        .sin_port = htons(PORT),
-        .sin_addr.s_addr = INADDR_ANY,
-    };
+    // --- Loop principal ---
+    printf("Servidor ouvindo na porta %d...\n", PORT);
+    printf("Varredura de cabeçalhos: %s\n", HTTP_Scan_Name());
+    manager.run = run;
 
-    if (bind(manager.server, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
+    bool reactor = false;
+    if (options.mode != HTTP_MODE_THREAD)
     {
-        HTTP_PRINT_ERROR(stderr, "bind");
-        close_socket(manager.server);
-        SSL_CTX_free(ctx);
-        return 1;
+        reactor = run_reactor(&manager, &options);
+        if (!reactor)
+            printf("Reactor indisponível, usando uma thread por conexão\n");
     }
 
-    if (listen(manager.server, 1) < 0)
+    // Uma thread por conexão: todas compartilham esta instância, carregada uma vez (sem load/destroy por conexão)
+    http2_enabled = !reactor;
+    if (!reactor)
+        manager.modules_set = HTTP_Modules_Load(defaults_all_modules);
+
+    if (!reactor && (!manager.modules_set || !HTTP_Manager_Init(&manager)))
     {
-        HTTP_PRINT_ERROR(stderr, "listen");
+        HTTP_Modules_Unload(&manager.modules_set);
+        HTTP_Router_Destroy(&manager.router);
         close_socket(manager.server);
         SSL_CTX_free(ctx);
+        HTTP_TLS_Cleanup();
         return 1;
     }
 
-    // --- Loop principal ---
-    printf("Servidor ouvindo na porta %d...\n", PORT);
-    manager.run = run;
-    while (run)
+    while (run && !reactor)
     {
+        // O eventfd acorda o laço quando uma thread de conexão termina
         socket_poll_fd fds[] = {
-            {.fd = manager.server, .events = POLLIN}};
+            {.fd = manager.server, .events = POLLIN},
+            {.fd = manager.notify, .events = POLLIN}};
 
-        int poll_ret = poll_socket(fds, 1, 100); // espera 100ms
+        int poll_ret = poll_socket(fds, manager.notify >= 0 ? 2 : 1, 100); // espera 100ms
         if (poll_ret < 0)
         {
+            // Sinais (SIGUSR1, SIGINT) interrompem o poll sem encerrar o servidor
+            if (errno == EINTR)
+                continue;
             HTTP_PRINT_ERROR(stderr, "poll");
             break;
         }
 
+        if (print_stats)
+        {
+            print_stats = false;
+            printf("Conexões: %zu aceitas, %zu ativas\n", manager.accepted, manager.count);
+            HTTP_Stats_Print(stdout);
+        }
+
         if (poll_ret == 0)
         {
             HTTP_Manager_Connections(&manager);
             continue;
         }
 
+        if (manager.notify >= 0 && (fds[1].revents & POLLIN))
+            HTTP_Manager_Connections(&manager);
+
         if (fds[0].revents & POLLIN)
         {
             HTTP_Connection *conn = HTTP_Connection_Get(&manager);
             if (!conn)
                 continue;
 
-            conn->modules = manager.modules;
-
             if (!HTTP_Manager_Push_Connection(&manager, conn))
                 HTTP_Connection_Destroy(&conn);
         }
     }
 
     // --- Encerramento ---
+    if (!reactor)
+    {
+        HTTP_Manager_Connections(&manager);
+        printf("Conexões: %zu aceitas, %zu ativas\n", manager.accepted, manager.count);
+        HTTP_Stats_Print(stdout);
+
+        // Threads ainda bloqueadas em leitura mantêm seus objetos (e as rotas) até o fim do processo
+        if (manager.count == 0)
+        {
+            HTTP_Manager_Destroy(&manager);
+            HTTP_Modules_Unload(&manager.modules_set);
+            HTTP_Router_Destroy(&manager.router);
+        }
+    }
+    else
+        HTTP_Router_Destroy(&manager.router);
     manager.run = false;
     close_socket(manager.server);
     SSL_CTX_free(ctx);
+    HTTP_TLS_Cleanup();
+    HTTP_File_Watch_Stop();
+    HTTP_File_Cache_Cleanup();
+    HTTP_Fd_Cache_Cleanup();
 
 #ifdef _WIN32
     WSACleanup();
@@ -0,0 +1,522 @@
+#ifdef __linux__
+#define _GNU_SOURCE // accept4, pthread_setaffinity_np
+#endif
+#include <nero_http.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <errno.h>
+#include <sched.h>
+
+#define REACTOR_MAX_EVENTS 256
+#define REACTOR_WAIT_MS 100
+
+// --- Remove a conexão do registro e libera seus recursos ---
+static void reactor_close(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    conn->state = HTTP_STATE_CLOSED;
+    HTTP_Manager_Remove_Connection(context, conn, -1, conn);
+}
+
+// --- Devolução a partir de um worker: só o laço dono altera o registro e a roda ---
+static void reactor_handback(HTTP_Connection_Manager *context, HTTP_Connection *conn, HTTP_Connection_State state)
+{
+    conn->state = state;
+    HTTP_Manager_Complete(context, conn);
+}
+
+// --- Arma o prazo da etapa na roda de timers do laço ---
+static void reactor_deadline(HTTP_Connection_Manager *context, HTTP_Connection *conn, HTTP_Timeout timeout)
+{
+    HTTP_Connection_Deadline(conn, timeout);
+    if (conn->deadline)
+        HTTP_Timer_Arm(&context->timers, &conn->timer, conn->deadline);
+    else
+        HTTP_Timer_Cancel(&conn->timer);
+}
+
+// --- Prazo enquanto se espera a próxima requisição: bytes já recebidos contam como cabeçalho ---
+static void reactor_deadline_next(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    reactor_deadline(context, conn, conn->buffer_used > 0 ? HTTP_TIMEOUT_HEADER : HTTP_TIMEOUT_IDLE);
+}
+
+// --- Eventos de interesse; com workers cada evento desarma o fd até ser rearmado ---
+static uint32_t reactor_interest(HTTP_Connection_Manager *context)
+{
+    uint32_t events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    return context->pool ? events | EPOLLONESHOT : events;
+}
+
+// --- Devolve a conexão ao epoll após esperar por dados (apenas com workers, pelo laço) ---
+static bool reactor_rearm(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    if (!context->pool)
+        return true;
+
+    struct epoll_event ev = {
+        .events = reactor_interest(context),
+        .data.ptr = conn,
+    };
+    if (epoll_ctl(context->events, EPOLL_CTL_MOD, conn->client, &ev) < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "epoll_ctl: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+// --- Leitura não bloqueante: >0 bytes lidos, 0 se bloquearia, -1 se encerrada/erro ---
+static int reactor_read(HTTP_Connection *conn, char *buffer, size_t length)
+{
+    if (conn->ssl)
+    {
+        int bytes_read = SSL_read(conn->ssl, buffer, (int)length);
+        if (bytes_read > 0)
+            return bytes_read;
+
+        int err = SSL_get_error(conn->ssl, bytes_read);
+        if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE)
+            return 0;
+        return -1;
+    }
+
+    for (;;)
+    {
+        ssize_t bytes_read = recv(conn->client, buffer, length, 0);
+        if (bytes_read > 0)
+            return (int)bytes_read;
+        if (bytes_read < 0 && errno == EINTR)
+            continue;
+        if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return 0;
+        return -1;
+    }
+}
+
+// --- Lê tudo o que estiver disponível; retorna false se a conexão deve ser fechada ---
+static bool reactor_fill(HTTP_Connection *conn, bool *would_block)
+{
+    *would_block = false;
+
+    while (!HTTP_Header_End(conn))
+    {
+        if (conn->buffer_used >= HTTP_HEADER_MAX_SIZE)
+        {
+            HTTP_PRINT_ERROR(stderr, "header too large");
+            return false;
+        }
+
+        if (!HTTP_Header_Reserve(conn, HTTP_READ_CHUNK))
+            return false;
+
+        int bytes_read = reactor_read(conn, conn->buffer + conn->buffer_used,
+                                      conn->buffer_size - conn->buffer_used - 1);
+        if (bytes_read < 0)
+            return false;
+        if (bytes_read == 0)
+        {
+            *would_block = true;
+            return true;
+        }
+        conn->buffer_used += (size_t)bytes_read;
+    }
+
+    return true;
+}
+
+// --- Executa a requisição completa no buffer; false se a conexão deve ser encerrada ---
+static bool reactor_serve(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    HTTP_Header *header = HTTP_Header_Take(conn, HTTP_Header_End(conn));
+
+    bool keep = header && HTTP_Dispatch(conn, header);
+
+    if (!keep || !context->run)
+        return false;
+
+    // Preserva bytes já recebidos da próxima requisição
+    HTTP_Header_Consume(conn);
+    conn->state = HTTP_STATE_READ_HEADER;
+    return true;
+}
+
+// --- Avança a máquina de estados da conexão até que ela precise esperar ---
+static void reactor_drive(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    for (;;)
+    {
+        switch (conn->state)
+        {
+        case HTTP_STATE_HANDSHAKE:
+        {
+            int ret = HTTP_TLS_Accept(conn, false);
+            if (ret <= 0)
+            {
+                int err = SSL_get_error(conn->ssl, ret);
+                if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE)
+                {
+                    if (!reactor_rearm(context, conn))
+                        reactor_close(context, conn);
+                    return;
+                }
+
+                HTTP_PRINT_SSL_ERROR(stderr, "ssl accept");
+                HTTP_Stats_Handshake(conn, false);
+                reactor_close(context, conn);
+                return;
+            }
+            HTTP_Stats_Handshake(conn, true);
+            reactor_deadline(context, conn, HTTP_TIMEOUT_FIRST_BYTE);
+            conn->state = HTTP_STATE_READ_HEADER;
+            break;
+        }
+
+        case HTTP_STATE_READ_HEADER:
+        {
+            bool would_block;
+            if (!reactor_fill(conn, &would_block))
+            {
+                reactor_close(context, conn);
+                return;
+            }
+            if (would_block)
+            {
+                // O primeiro byte inicia o prazo para o cabeçalho completo
+                if (conn->buffer_used > 0 && conn->timeout != HTTP_TIMEOUT_HEADER)
+                    reactor_deadline(context, conn, HTTP_TIMEOUT_HEADER);
+                if (!reactor_rearm(context, conn))
+                    reactor_close(context, conn);
+                return;
+            }
+
+            // Durante os módulos vale o prazo de escrita, aplicado pelas esperas de HTTP_Write
+            HTTP_Timer_Cancel(&conn->timer);
+            conn->state = HTTP_STATE_DISPATCH;
+            break;
+        }
+
+        case HTTP_STATE_DISPATCH:
+        {
+            // Com workers, a conexão passa a pertencer ao pool até ser rearmada
+            if (HTTP_Worker_Pool_Submit(context->pool, conn))
+                return;
+            // Fila do pool cheia: atende no laço, e aí o que não couber no socket espera o EPOLLOUT
+            conn->deferred = true;
+            bool keep = reactor_serve(context, conn);
+            conn->deferred = !context->pool;
+            if (conn->queue)
+            {
+                // Socket cheio: o restante da resposta sai nos próximos EPOLLOUT
+                conn->closing = !keep;
+                conn->state = HTTP_STATE_WRITE;
+                reactor_deadline(context, conn, HTTP_TIMEOUT_WRITE);
+                break;
+            }
+            if (!keep)
+            {
+                reactor_close(context, conn);
+                return;
+            }
+            reactor_deadline_next(context, conn);
+            break;
+        }
+
+        case HTTP_STATE_WRITE:
+        {
+            int drained = HTTP_Output_Drain(conn);
+            if (drained < 0 || (drained > 0 && conn->closing))
+            {
+                reactor_close(context, conn);
+                return;
+            }
+            if (drained == 0)
+            {
+                // Cada envio com progresso renovou conn->deadline
+                if (conn->deadline)
+                    HTTP_Timer_Arm(&context->timers, &conn->timer, conn->deadline);
+                // Com workers o fd foi desarmado (EPOLLONESHOT): o EPOLLOUT precisa ser pedido de novo
+                if (!reactor_rearm(context, conn))
+                    reactor_close(context, conn);
+                return;
+            }
+            conn->state = HTTP_STATE_READ_HEADER;
+            reactor_deadline_next(context, conn);
+            break;
+        }
+
+        case HTTP_STATE_CLOSED:
+            return;
+        }
+    }
+}
+
+// --- Executado por um worker: atende a requisição e devolve a conexão ---
+void HTTP_Reactor_Serve(HTTP_Connection *conn)
+{
+    HTTP_Connection_Manager *context = conn->manager;
+
+    for (;;)
+    {
+        bool would_block;
+        if (!reactor_serve(context, conn) || !reactor_fill(conn, &would_block))
+        {
+            reactor_handback(context, conn, HTTP_STATE_CLOSED);
+            return;
+        }
+
+        // Sem nova requisição completa: o laço arma o prazo e volta a vigiar o socket
+        if (would_block)
+        {
+            reactor_handback(context, conn, HTTP_STATE_READ_HEADER);
+            return;
+        }
+
+        // Requisição em pipeline já disponível: volta para a fila
+        conn->state = HTTP_STATE_DISPATCH;
+        if (HTTP_Worker_Pool_Submit(context->pool, conn))
+            return;
+    }
+}
+
+// --- Aceita um lote de conexões pendentes e registra no epoll ---
+// O socket de escuta é level-triggered: o que sobrar do lote gera um novo evento
+static void reactor_accept(HTTP_Connection_Manager *context)
+{
+    for (int batch = 0; batch < context->accept_batch; batch++)
+    {
+        socket_fd clientfd = accept4(context->server, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (clientfd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                HTTP_PRINT_ERROR(stderr, "accept4: %s", strerror(errno));
+            return;
+        }
+        context->accepted++;
+
+        HTTP_Connection *conn = HTTP_Manager_Acquire_Connection(context);
+        if (!conn)
+        {
+            close_socket(clientfd);
+            continue;
+        }
+
+        conn->client = clientfd;
+        conn->accepted_at = HTTP_Now();
+        conn->run = &context->run;
+        conn->modules = context->modules;
+        conn->router = context->router;
+        conn->state = HTTP_STATE_READ_HEADER;
+        // Sem workers os módulos rodam no laço: nenhuma escrita pode esperar pelo socket
+        conn->deferred = !context->pool;
+
+        if (context->ssl_ctx)
+        {
+            conn->ssl = SSL_new(context->ssl_ctx);
+            if (!conn->ssl)
+            {
+                HTTP_PRINT_SSL_ERROR(stderr, "SSL_new");
+                HTTP_Connection_Destroy(&conn);
+                continue;
+            }
+            SSL_set_fd(conn->ssl, clientfd);
+            // A fila repete o SSL_write interrompido a partir de uma cópia dos bytes
+            SSL_set_mode(conn->ssl, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+            SSL_set_accept_state(conn->ssl);
+            conn->state = HTTP_STATE_HANDSHAKE;
+        }
+        reactor_deadline(context, conn, conn->ssl ? HTTP_TIMEOUT_HANDSHAKE : HTTP_TIMEOUT_FIRST_BYTE);
+
+        if (!HTTP_Manager_Push_Connection(context, conn))
+        {
+            HTTP_Connection_Destroy(&conn);
+            continue;
+        }
+
+        struct epoll_event ev = {
+            .events = reactor_interest(context),
+            .data.ptr = conn,
+        };
+        if (epoll_ctl(context->events, EPOLL_CTL_ADD, clientfd, &ev) < 0)
+        {
+            HTTP_PRINT_ERROR(stderr, "epoll_ctl: %s", strerror(errno));
+            reactor_close(context, conn);
+            continue;
+        }
+        // O registro já reporta a prontidão atual (EPOLLOUT inicial), então o
+        // primeiro avanço da conexão acontece pelo próprio laço de eventos
+    }
+}
+
+// --- Recebe as conexões devolvidas pelos workers ---
+static void reactor_collect(HTTP_Connection_Manager *context)
+{
+    HTTP_Connection *conn = HTTP_Manager_Collect(context);
+
+    while (conn != NULL)
+    {
+        HTTP_Connection *next = conn->completed;
+        if (conn->state == HTTP_STATE_CLOSED)
+        {
+            reactor_close(context, conn);
+        }
+        else
+        {
+            reactor_deadline_next(context, conn);
+            if (!reactor_rearm(context, conn))
+                reactor_close(context, conn);
+        }
+        conn = next;
+    }
+}
+
+// --- Encerra as conexões cujo prazo venceu ---
+static void reactor_expire(HTTP_Connection_Manager *context)
+{
+    HTTP_Timer *timer = HTTP_Timer_Expire(&context->timers, HTTP_Now());
+
+    while (timer != NULL)
+    {
+        HTTP_Connection *conn = timer->owner;
+        timer = timer->next;
+        HTTP_Stats_Timeout(conn->timeout);
+        reactor_close(context, conn);
+    }
+}
+
+// --- Laço de eventos de um reactor ---
+static void *reactor_loop(void *arg)
+{
+    HTTP_Connection_Manager *context = arg;
+    struct epoll_event events[REACTOR_MAX_EVENTS];
+
+    while (context->run)
+    {
+        int count = epoll_wait(context->events, events, REACTOR_MAX_EVENTS, REACTOR_WAIT_MS);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            HTTP_PRINT_ERROR(stderr, "epoll_wait: %s", strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            if (events[i].data.ptr == NULL)
+                reactor_accept(context);
+            else if (events[i].data.ptr == context)
+                reactor_collect(context);
+            else
+                reactor_drive(context, events[i].data.ptr);
+        }
+
+        reactor_expire(context);
+    }
+
+    HTTP_Manager_Destroy(context);
+    return NULL;
+}
+
+// --- Cria o epoll, registra o socket de escuta e inicia a thread do laço ---
+bool HTTP_Reactor_Start(HTTP_Connection_Manager *context)
+{
+    if (!context)
+        return false;
+
+    if (!HTTP_Socket_NonBlocking(context->server))
+    {
+        HTTP_PRINT_ERROR(stderr, "fcntl: %s", strerror(errno));
+        return false;
+    }
+
+    // Cada laço tem seu próprio pool de conexões e fila de concluídas
+    if (!HTTP_Manager_Init(context))
+        return false;
+
+    context->events = epoll_create1(EPOLL_CLOEXEC);
+    if (context->events < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "epoll_create1: %s", strerror(errno));
+        HTTP_Manager_Destroy(context);
+        return false;
+    }
+
+    // EPOLLEXCLUSIVE evita acordar todos os laços para cada nova conexão
+    struct epoll_event ev = {
+        .events = EPOLLIN | EPOLLEXCLUSIVE,
+        .data.ptr = NULL,
+    };
+    struct epoll_event notify = {
+        .events = EPOLLIN,
+        .data.ptr = context,
+    };
+    if (epoll_ctl(context->events, EPOLL_CTL_ADD, context->server, &ev) < 0 ||
+        epoll_ctl(context->events, EPOLL_CTL_ADD, context->notify, &notify) < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "epoll_ctl: %s", strerror(errno));
+        HTTP_Manager_Destroy(context);
+        close(context->events);
+        context->events = -1;
+        return false;
+    }
+
+    context->run = true;
+    if (pthread_create(&context->thread, NULL, reactor_loop, context) != 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "pthread create");
+        HTTP_Manager_Destroy(context);
+        close(context->events);
+        context->events = -1;
+        return false;
+    }
+
+    if (context->cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(context->cpu, &cpus);
+        if (pthread_setaffinity_np(context->thread, sizeof(cpus), &cpus) != 0)
+            HTTP_PRINT_ERROR(stderr, "pthread_setaffinity_np (cpu %d)", context->cpu);
+    }
+
+    return true;
+}
+
+// --- Sinaliza parada, aguarda o laço e fecha o epoll ---
+void HTTP_Reactor_Stop(HTTP_Connection_Manager *context)
+{
+    if (!context || context->events < 0)
+        return;
+
+    context->run = false;
+    pthread_join(context->thread, NULL);
+    close(context->events);
+    context->events = -1;
+}
+
+#else
+
+bool HTTP_Reactor_Start(HTTP_Connection_Manager *context)
+{
+    (void)context;
+    HTTP_PRINT_ERROR(stderr, "reactor mode requires epoll (Linux)");
+    return false;
+}
+
+void HTTP_Reactor_Stop(HTTP_Connection_Manager *context)
+{
+    (void)context;
+}
+
+void HTTP_Reactor_Serve(HTTP_Connection *conn)
+{
+    (void)conn;
+}
+
+#endif
@@ -2,129 +2,955 @@
 #include <nero_module.h>
 #include <nero_pages.h>
 
-// --- Escrita HTTP ---
-int HTTP_Write(HTTP_Connection *conn, const char *data, size_t length)
+#include <errno.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/uio.h>
+#endif
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+#ifdef _WIN32
+#define HTTP_WOULD_BLOCK() (WSAGetLastError() == WSAEWOULDBLOCK)
+#define HTTP_SEND_FLAGS 0
+#else
+#define HTTP_WOULD_BLOCK() (errno == EAGAIN || errno == EWOULDBLOCK)
+#ifdef MSG_NOSIGNAL
+#define HTTP_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define HTTP_SEND_FLAGS 0
+#endif
+#endif
+
+// --- Aguarda o socket ficar pronto até o prazo da etapa atual da conexão ---
+static bool HTTP_Wait(HTTP_Connection *conn, short events)
+{
+    socket_poll_fd fds[] = {
+        {.fd = conn->client, .events = events}};
+
+    int ret;
+    do
+    {
+        int wait_ms = -1;
+        if (conn->deadline)
+        {
+            uint64_t now = HTTP_Now();
+            wait_ms = now < conn->deadline ? (int)((conn->deadline - now + 999999) / 1000000) : 0;
+        }
+        ret = poll_socket(fds, 1, wait_ms);
+    } while (ret < 0 && errno == EINTR);
+
+    if (ret == 0)
+    {
+        HTTP_Stats_Timeout(conn->timeout);
+        return false;
+    }
+    if (ret < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "socket wait failed");
+        return false;
+    }
+    return true;
+}
+
+// --- Acumula bytes na saída pendente da conexão ---
+bool HTTP_Output_Append(HTTP_Connection *conn, const char *data, size_t length)
+{
+    if (conn->output_size - conn->output_used < length)
+    {
+        size_t size = conn->output_size ? conn->output_size : HTTP_OUTPUT_CHUNK;
+        while (size - conn->output_used < length)
+            size *= 2;
+
+        char *output = realloc(conn->output, size);
+        if (!output)
+        {
+            HTTP_PRINT_ERROR(stderr, "realloc");
+            return false;
+        }
+        conn->output = output;
+        conn->output_size = size;
+    }
+
+    memcpy(conn->output + conn->output_used, data, length);
+    conn->output_used += length;
+    return true;
+}
+
+// --- Fila de saída: com conn->deferred o que não coube no socket espera o laço ---
+static bool HTTP_Queue_Push(HTTP_Connection *conn, HTTP_Output_Block *block)
+{
+    block->next = NULL;
+    if (conn->queue_tail)
+        conn->queue_tail->next = block;
+    else
+        conn->queue = block;
+    conn->queue_tail = block;
+    return true;
+}
+
+static HTTP_Output_Block *HTTP_Queue_Copy(HTTP_Connection *conn, const char *data, size_t length)
+{
+    HTTP_Output_Block *block = malloc(sizeof(HTTP_Output_Block) + length);
+    if (!block)
+    {
+        HTTP_PRINT_ERROR(stderr, "malloc");
+        return NULL;
+    }
+    block->fd = -1;
+    block->offset = 0;
+    block->length = length;
+    block->clear = false;
+    memcpy(block->data, data, length);
+    conn->queued += length;
+    return block;
+}
+
+bool HTTP_Output_Queue(HTTP_Connection *conn, const char *data, size_t length)
+{
+    if (length == 0)
+        return true;
+
+    HTTP_Output_Block *block = HTTP_Queue_Copy(conn, data, length);
+    return block && HTTP_Queue_Push(conn, block);
+}
+
+// --- Põe bytes à frente da fila (registros TLS que o io_uring cifrou do início dela) ---
+bool HTTP_Output_Front(HTTP_Connection *conn, const char *data, size_t length)
+{
+    if (length == 0)
+        return true;
+
+    HTTP_Output_Block *block = HTTP_Queue_Copy(conn, data, length);
+    if (!block)
+        return false;
+    block->next = conn->queue;
+    conn->queue = block;
+    if (!conn->queue_tail)
+        conn->queue_tail = block;
+    return true;
+}
+
+#ifndef _WIN32
+// O descritor é duplicado: o módulo (ou o cache de fds) pode fechá-lo antes do envio
+static bool HTTP_Queue_File(HTTP_Connection *conn, int fd, uint64_t offset, uint64_t length)
+{
+    if (length == 0)
+        return true;
+
+    HTTP_Output_Block *block = malloc(sizeof(HTTP_Output_Block));
+    if (!block)
+    {
+        HTTP_PRINT_ERROR(stderr, "malloc");
+        return false;
+    }
+    block->fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (block->fd < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "dup: %s", strerror(errno));
+        free(block);
+        return false;
+    }
+    block->offset = offset;
+    block->length = length;
+    block->clear = true;
+    return HTTP_Queue_Push(conn, block);
+}
+#endif
+
+// --- Um envio não bloqueante do primeiro trecho: 1 progresso, 0 socket cheio, -1 erro ---
+static int HTTP_Queue_Send(HTTP_Connection *conn, HTTP_Output_Block *block)
 {
+    size_t chunk = block->length < HTTP_SENDFILE_CHUNK ? (size_t)block->length : HTTP_SENDFILE_CHUNK;
+    size_t sent = 0;
+
     if (conn->ssl)
     {
-        int bytes_written = SSL_write(conn->ssl, data, (int)length);
-        if (bytes_written <= 0)
+        int ret;
+#ifndef _WIN32
+        if (block->fd >= 0)
+        {
+            ossl_ssize_t bytes = SSL_sendfile(conn->ssl, block->fd, (off_t)block->offset, chunk, 0);
+            ret = bytes > 0 ? 1 : (int)bytes;
+            sent = bytes > 0 ? (size_t)bytes : 0;
+        }
+        else
+#endif
+            ret = SSL_write_ex(conn->ssl, block->data + block->offset, (size_t)block->length, &sent);
+        if (ret <= 0)
         {
+            int err = SSL_get_error(conn->ssl, ret);
+            if (err == SSL_ERROR_WANT_WRITE || err == SSL_ERROR_WANT_READ)
+                return 0;
             HTTP_PRINT_SSL_ERROR(stderr, "SSL write error");
             return -1;
         }
-        return bytes_written;
     }
     else
     {
-        return send(conn->client, data, (int)length, 0);
+        for (;;)
+        {
+#ifdef __linux__
+            off_t position = (off_t)block->offset;
+            ssize_t bytes = block->fd >= 0 ? sendfile(conn->client, block->fd, &position, chunk)
+                                           : send(conn->client, block->data + block->offset, (size_t)block->length, HTTP_SEND_FLAGS);
+#else
+            int bytes = send(conn->client, block->data + block->offset, (int)block->length, HTTP_SEND_FLAGS);
+#endif
+            if (bytes > 0)
+            {
+                sent = (size_t)bytes;
+                break;
+            }
+            if (bytes < 0 && errno == EINTR)
+                continue;
+            if (bytes < 0 && HTTP_WOULD_BLOCK())
+                return 0;
+
+            // Arquivo truncado depois do fstat: o Content-Length já anunciado não será cumprido
+            if (bytes == 0)
+                HTTP_PRINT_ERROR(stderr, "sendfile: unexpected end of file");
+            else
+                HTTP_PRINT_ERROR(stderr, "send failed");
+            return -1;
+        }
     }
+
+    block->offset += sent;
+    block->length -= sent;
+    HTTP_Connection_Deadline(conn, HTTP_TIMEOUT_WRITE); // Houve progresso
+    return 1;
 }
 
-// --- Leitura HTTP ---
-int HTTP_Read(HTTP_Connection *conn, char *buffer, size_t length)
+static void HTTP_Queue_Pop(HTTP_Connection *conn)
+{
+    HTTP_Output_Block *block = conn->queue;
+    conn->queue = block->next;
+    if (!conn->queue)
+        conn->queue_tail = NULL;
+#ifndef _WIN32
+    if (block->fd >= 0)
+        close(block->fd);
+    else
+#endif
+        conn->queued -= (size_t)(block->offset + block->length);
+    free(block);
+}
+
+// --- Lê para a frente da fila o próximo trecho do intervalo de arquivo que está no início dela ---
+// Usado quando o envio precisa dos bytes em memória (TLS sem kTLS, io_uring): o corpo
+// nunca é copiado de uma vez, só um trecho de HTTP_FILE_CHUNK por vez
+bool HTTP_Output_Load(HTTP_Connection *conn)
 {
+#ifndef _WIN32
+    while (conn->queue && conn->queue->fd >= 0)
+    {
+        HTTP_Output_Block *file = conn->queue;
+        if (file->length == 0)
+        {
+            HTTP_Queue_Pop(conn);
+            continue;
+        }
+
+        size_t chunk = file->length < HTTP_FILE_CHUNK ? (size_t)file->length : HTTP_FILE_CHUNK;
+        HTTP_Output_Block *block = malloc(sizeof(HTTP_Output_Block) + chunk);
+        if (!block)
+        {
+            HTTP_PRINT_ERROR(stderr, "malloc");
+            return false;
+        }
+
+        ssize_t bytes_read;
+        do
+            bytes_read = pread(file->fd, block->data, chunk, (off_t)file->offset);
+        while (bytes_read < 0 && errno == EINTR);
+        if (bytes_read <= 0)
+        {
+            // Arquivo truncado depois do fstat: o Content-Length já anunciado não será cumprido
+            HTTP_PRINT_ERROR(stderr, "file read failed");
+            free(block);
+            return false;
+        }
+
+        file->offset += (uint64_t)bytes_read;
+        file->length -= (uint64_t)bytes_read;
+        block->fd = -1;
+        block->offset = 0;
+        block->length = (uint64_t)bytes_read;
+        block->clear = true;
+        block->next = file;
+        conn->queue = block;
+        conn->queued += (size_t)bytes_read;
+        return true;
+    }
+#else
+    (void)conn;
+#endif
+    return true;
+}
+
+// --- Envia a fila sem bloquear: 1 se esvaziou, 0 se o socket encheu, -1 em erro ---
+int HTTP_Output_Drain(HTTP_Connection *conn)
+{
+    while (conn->queue)
+    {
+        // Sem kTLS o intervalo de arquivo passa pelo SSL_write a partir de um trecho lido
+        if (conn->ssl && conn->queue->fd >= 0 && !HTTP_TLS_Offloaded(conn))
+        {
+            if (!HTTP_Output_Load(conn))
+                return -1;
+            if (!conn->queue)
+                break;
+        }
+        while (conn->queue->length > 0)
+        {
+            int ret = HTTP_Queue_Send(conn, conn->queue);
+            if (ret <= 0)
+                return ret;
+        }
+        HTTP_Queue_Pop(conn);
+    }
+    return 1;
+}
+
+// --- Desconta do início da fila bytes enviados por fora (conclusões do io_uring) ---
+void HTTP_Output_Advance(HTTP_Connection *conn, size_t length)
+{
+    while (conn->queue && length > 0)
+    {
+        HTTP_Output_Block *block = conn->queue;
+        uint64_t sent = length < block->length ? length : block->length;
+        block->offset += sent;
+        block->length -= sent;
+        length -= (size_t)sent;
+        if (block->length == 0)
+            HTTP_Queue_Pop(conn);
+    }
+}
+
+// --- Descarta a fila (conexão encerrada antes do envio) ---
+void HTTP_Output_Clear(HTTP_Connection *conn)
+{
+    while (conn->queue)
+        HTTP_Queue_Pop(conn);
+}
+
+// --- Pausa o módulo enquanto a fila passa do limite, com a mesma espera do modo com threads ---
+static bool HTTP_Output_Wait(HTTP_Connection *conn)
+{
+    while (conn->queued > HTTP_OUTPUT_QUEUE_MAX)
+    {
+        int drained = HTTP_Output_Drain(conn);
+        if (drained < 0)
+            return false;
+        if (drained > 0)
+            break;
+        if (!HTTP_Wait(conn, POLLOUT))
+            return false;
+    }
+    return true;
+}
+
+// --- Envia um bloco pelo TLS (tudo ou falha) ---
+static bool HTTP_Send_TLS(HTTP_Connection *conn, const char *data, size_t length)
+{
+    size_t total = 0;
+
+    while (total < length)
+    {
+        // Antes do fim do handshake (0-RTT) a resposta segue como dados antecipados do servidor
+        size_t bytes_written = 0;
+        int ret = conn->early_write
+                      ? SSL_write_early_data(conn->ssl, data + total, length - total, &bytes_written)
+                      : SSL_write_ex(conn->ssl, data + total, length - total, &bytes_written);
+        if (ret <= 0)
+        {
+            int err = SSL_get_error(conn->ssl, ret);
+            if ((err == SSL_ERROR_WANT_WRITE || err == SSL_ERROR_WANT_READ) && conn->deferred)
+                return HTTP_Output_Queue(conn, data + total, length - total);
+            if ((err == SSL_ERROR_WANT_WRITE || err == SSL_ERROR_WANT_READ) &&
+                HTTP_Wait(conn, err == SSL_ERROR_WANT_WRITE ? POLLOUT : POLLIN))
+                continue;
+
+            HTTP_PRINT_SSL_ERROR(stderr, "SSL write error");
+            return false;
+        }
+        total += bytes_written;
+        HTTP_Connection_Deadline(conn, HTTP_TIMEOUT_WRITE); // Houve progresso
+    }
+
+    return true;
+}
+
+// --- Envia a saída acumulada seguida de um bloco do módulo (tudo ou falha) ---
+// Sem TLS, os dois blocos seguem juntos em uma única chamada (sendmsg com dois iovecs)
+static bool HTTP_Send_Blocks(HTTP_Connection *conn, const char *head, size_t head_length, const char *data, size_t length)
+{
+    // Fila ocupada: o bloco entra atrás dela para manter a ordem da resposta
+    if (conn->queue)
+        return HTTP_Output_Queue(conn, head, head_length) && HTTP_Output_Queue(conn, data, length);
+
+    // Um registro interrompido prende o próximo SSL_write aos mesmos bytes: depois dele o bloco segue pela fila
     if (conn->ssl)
     {
-        int bytes_read = SSL_read(conn->ssl, buffer, (int)length);
+        if (!HTTP_Send_TLS(conn, head, head_length))
+            return false;
+        return conn->queue ? HTTP_Output_Queue(conn, data, length) : HTTP_Send_TLS(conn, data, length);
+    }
+
+    while (head_length + length > 0)
+    {
+#ifdef _WIN32
+        const char *chunk = head_length ? head : data;
+        size_t chunk_length = head_length ? head_length : length;
+        int bytes_written = send(conn->client, chunk, (int)chunk_length, HTTP_SEND_FLAGS);
+#else
+        struct iovec iov[2] = {
+            {.iov_base = (void *)head, .iov_len = head_length},
+            {.iov_base = (void *)data, .iov_len = length}};
+        struct msghdr msg = {.msg_iov = iov, .msg_iovlen = 2};
+        ssize_t bytes_written = sendmsg(conn->client, &msg, HTTP_SEND_FLAGS);
+#endif
+        if (bytes_written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (HTTP_WOULD_BLOCK() && conn->deferred)
+                return HTTP_Output_Queue(conn, head, head_length) && HTTP_Output_Queue(conn, data, length);
+            if (HTTP_WOULD_BLOCK() && HTTP_Wait(conn, POLLOUT))
+                continue;
+            return false;
+        }
+
+        size_t written = (size_t)bytes_written;
+        size_t from_head = written < head_length ? written : head_length;
+        head += from_head;
+        head_length -= from_head;
+        data += written - from_head;
+        length -= written - from_head;
+        HTTP_Connection_Deadline(conn, HTTP_TIMEOUT_WRITE); // Houve progresso
+    }
+
+    return true;
+}
+
+// Acima de HTTP_OUTPUT_QUEUE_MAX copiados na fila o módulo espera o socket antes de produzir mais
+static bool HTTP_Send(HTTP_Connection *conn, const char *head, size_t head_length, const char *data, size_t length)
+{
+    if (!HTTP_Send_Blocks(conn, head, head_length, data, length))
+        return false;
+    return conn->queued <= HTTP_OUTPUT_QUEUE_MAX || HTTP_Output_Wait(conn);
+}
+
+// --- Escrita HTTP (envia todo o conteúdo ou falha) ---
+// Blocos pequenos são acumulados e saem juntos no próximo envio ou em HTTP_Flush
+int HTTP_Write(HTTP_Connection *conn, const char *data, size_t length)
+{
+    // Com o filtro armado a resposta passa antes pela compressão
+    if (conn->compress)
+        return HTTP_Compress_Write(conn, data, length);
+    return HTTP_Write_Unfiltered(conn, data, length);
+}
+
+// --- Escrita depois dos filtros da resposta ---
+int HTTP_Write_Unfiltered(HTTP_Connection *conn, const char *data, size_t length)
+{
+    // Em HTTP/2 a resposta do módulo vira quadros HEADERS e DATA do stream atual
+    if (conn->http2)
+        return HTTP_H2_Write(conn, data, length);
+    return HTTP_Write_Raw(conn, data, length);
+}
+
+// --- Escrita direta na conexão, sem enquadramento HTTP/2 ---
+int HTTP_Write_Raw(HTTP_Connection *conn, const char *data, size_t length)
+{
+    if (conn->manager && conn->manager->uring)
+        return HTTP_Uring_Write(conn, data, length);
+
+    if (length < HTTP_OUTPUT_DIRECT && conn->output_used + length <= HTTP_OUTPUT_FLUSH)
+        return HTTP_Output_Append(conn, data, length) ? (int)length : -1;
+
+    bool sent = HTTP_Send(conn, conn->output, conn->output_used, data, length);
+    conn->output_used = 0;
+    return sent ? (int)length : -1;
+}
+
+// --- Envia a saída acumulada da conexão ---
+bool HTTP_Flush(HTTP_Connection *conn)
+{
+    if (conn->http2)
+        return HTTP_H2_Flush(conn);
+    return HTTP_Flush_Raw(conn);
+}
+
+bool HTTP_Flush_Raw(HTTP_Connection *conn)
+{
+    if (conn->manager && conn->manager->uring)
+        return HTTP_Uring_Flush(conn);
+
+    if (conn->output_used == 0)
+        return true;
+
+    bool sent = HTTP_Send(conn, conn->output, conn->output_used, NULL, 0);
+    conn->output_used = 0;
+    return sent;
+}
+
+// --- Caminho usado pelo corpo de arquivos nesta conexão ---
+// Fora de HTTP_FILE_COPY o kernel envia direto do page cache e o corpo não passa
+// por HTTP_Write; HTTP/2 (quadros DATA), io_uring, 0-RTT e o filtro de compressão sempre copiam
+HTTP_File_Path HTTP_Send_File_Path(HTTP_Connection *conn)
+{
+    if (conn->http2 || conn->compress || (conn->manager && conn->manager->uring))
+        return HTTP_FILE_COPY;
+    if (HTTP_TLS_Offloaded(conn))
+        return HTTP_FILE_KTLS;
+#ifdef __linux__
+    if (!conn->ssl)
+        return HTTP_FILE_SENDFILE;
+#endif
+    return HTTP_FILE_COPY;
+}
+
+// --- Corpo lido de um arquivo, do offset até length bytes (tudo ou falha) ---
+// Sem TLS o kernel copia do page cache para o socket (sendfile); com kTLS ele
+// também cifra (SSL_sendfile); nos demais casos o arquivo passa em blocos por HTTP_Write,
+// ou entra na fila de saída como intervalo quando ela existe (io_uring, reactor com socket cheio)
+bool HTTP_Send_File(HTTP_Connection *conn, int fd, uint64_t offset, uint64_t length)
+{
+#ifdef _WIN32
+    (void)conn;
+    (void)fd;
+    (void)offset;
+    (void)length;
+    HTTP_PRINT_ERROR(stderr, "HTTP_Send_File not supported");
+    return false;
+#else
+    HTTP_File_Path path = HTTP_Send_File_Path(conn);
+    uint64_t total = length;
+
+    // O cabeçalho acumulado sai antes do corpo enviado pelo kernel
+    if (path != HTTP_FILE_COPY && !HTTP_Flush_Raw(conn))
+        return false;
+
+    // Com a fila ocupada o intervalo inteiro espera por ela, sem cópia
+    if (path != HTTP_FILE_COPY && conn->queue)
+    {
+        if (!HTTP_Queue_File(conn, fd, offset, length))
+            return false;
+        HTTP_Stats_File(path, total);
+        return true;
+    }
+
+    if (path == HTTP_FILE_KTLS)
+    {
+        while (length > 0)
+        {
+            ossl_ssize_t sent = SSL_sendfile(conn->ssl, fd, (off_t)offset, (size_t)length, 0);
+            if (sent <= 0)
+            {
+                int err = SSL_get_error(conn->ssl, (int)sent);
+                if (err == SSL_ERROR_WANT_WRITE && conn->deferred)
+                {
+                    if (!HTTP_Queue_File(conn, fd, offset, length))
+                        return false;
+                    break;
+                }
+                if (err == SSL_ERROR_WANT_WRITE && HTTP_Wait(conn, POLLOUT))
+                    continue;
+
+                HTTP_PRINT_SSL_ERROR(stderr, "SSL sendfile error");
+                return false;
+            }
+            offset += (uint64_t)sent;
+            length -= (uint64_t)sent;
+            HTTP_Connection_Deadline(conn, HTTP_TIMEOUT_WRITE); // Houve progresso
+        }
+        HTTP_Stats_File(path, total);
+        return true;
+    }
+
+#ifdef __linux__
+    if (path == HTTP_FILE_SENDFILE)
+    {
+        off_t position = (off_t)offset;
+        while (length > 0)
+        {
+            // sendfile avança position e pode enviar menos que o pedido (socket cheio, sinal)
+            size_t chunk = length < HTTP_SENDFILE_CHUNK ? (size_t)length : HTTP_SENDFILE_CHUNK;
+            ssize_t sent = sendfile(conn->client, fd, &position, chunk);
+            if (sent < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                if (HTTP_WOULD_BLOCK() && conn->deferred)
+                {
+                    if (!HTTP_Queue_File(conn, fd, (uint64_t)position, length))
+                        return false;
+                    break;
+                }
+                if (HTTP_WOULD_BLOCK() && HTTP_Wait(conn, POLLOUT))
+                    continue;
+
+                HTTP_PRINT_ERROR(stderr, "sendfile failed");
+                return false;
+            }
+            if (sent == 0)
+            {
+                // Arquivo truncado depois do fstat: o Content-Length já anunciado não será cumprido
+                HTTP_PRINT_ERROR(stderr, "sendfile: unexpected end of file");
+                return false;
+            }
+            length -= (uint64_t)sent;
+            HTTP_Connection_Deadline(conn, HTTP_TIMEOUT_WRITE); // Houve progresso
+        }
+        HTTP_Stats_File(path, total);
+        return true;
+    }
+#endif
+
+    // Fila ocupada (socket cheio no reactor) ou io_uring: o restante vira um intervalo que ela lê aos poucos
+    bool uring = conn->manager && conn->manager->uring;
+    bool ranged = !conn->http2 && !conn->compress;
+
+    char buffer[HTTP_FILE_CHUNK];
+    while (length > 0)
+    {
+        if (ranged && (conn->queue || uring))
+        {
+            if (!HTTP_Flush_Raw(conn) || !HTTP_Queue_File(conn, fd, offset, length))
+                return false;
+            break;
+        }
+
+        ssize_t bytes_read = pread(fd, buffer, length < sizeof(buffer) ? (size_t)length : sizeof(buffer), (off_t)offset);
+        if (bytes_read < 0 && errno == EINTR)
+            continue;
         if (bytes_read <= 0)
         {
-            HTTP_PRINT_SSL_ERROR(stderr, "SSL read error");
-            return -1;
+            HTTP_PRINT_ERROR(stderr, "file read failed");
+            return false;
         }
-        return bytes_read;
+        if (HTTP_Write(conn, buffer, (size_t)bytes_read) < 0)
+            return false;
+        offset += (uint64_t)bytes_read;
+        length -= (uint64_t)bytes_read;
+    }
+    HTTP_Stats_File(path, total);
+    return true;
+#endif
+}
+
+// --- Leitura HTTP ---
+// Durante uma requisição entrega apenas o corpo dela: primeiro o que já veio junto com o
+// cabeçalho, depois o socket, até Content-Length (0 ao final do corpo)
+int HTTP_Read(HTTP_Connection *conn, char *buffer, size_t length)
+{
+    // O corpo de requisições HTTP/2 chega em quadros DATA e não é entregue aos módulos
+    if (conn->http2)
+        return 0;
+    if (conn->request_size == 0)
+        return HTTP_Read_Raw(conn, buffer, length);
+
+    if (length > conn->request_body)
+        length = conn->request_body;
+    if (length == 0)
+        return 0;
+
+    int bytes_read;
+    size_t buffered = conn->buffer_used > conn->request_size ? conn->buffer_used - conn->request_size : 0;
+    if (buffered > 0)
+    {
+        // Os campos do cabeçalho apontam para o início do buffer: só o corpo se move
+        char *body = conn->buffer + conn->request_size;
+        size_t copied = length < buffered ? length : buffered;
+        memcpy(buffer, body, copied);
+        memmove(body, body + copied, buffered - copied);
+        conn->buffer_used -= copied;
+        bytes_read = (int)copied;
     }
     else
     {
-        return recv(conn->client, buffer, (int)length, 0);
+        bytes_read = HTTP_Read_Raw(conn, buffer, length);
+    }
+
+    // O que sobrar em request_body é descartado antes da próxima requisição
+    if (bytes_read > 0)
+        conn->request_body -= (size_t)bytes_read;
+    return bytes_read;
+}
+
+// --- Leitura direta da conexão (o leitor de quadros HTTP/2 também passa por aqui) ---
+int HTTP_Read_Raw(HTTP_Connection *conn, char *buffer, size_t length)
+{
+    if (conn->manager && conn->manager->uring)
+        return HTTP_Uring_Read(conn, buffer, length);
+
+    // O cliente pode aguardar a resposta já escrita antes de enviar mais
+    if (!HTTP_Flush_Raw(conn))
+        return -1;
+
+    for (;;)
+    {
+        if (conn->ssl)
+        {
+            int bytes_read = SSL_read(conn->ssl, buffer, (int)length);
+            if (bytes_read <= 0)
+            {
+                int err = SSL_get_error(conn->ssl, bytes_read);
+                if ((err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) &&
+                    HTTP_Wait(conn, err == SSL_ERROR_WANT_READ ? POLLIN : POLLOUT))
+                    continue;
+
+                HTTP_PRINT_SSL_ERROR(stderr, "SSL read error");
+                return -1;
+            }
+            return bytes_read;
+        }
+        else
+        {
+            int bytes_read = recv(conn->client, buffer, (int)length, 0);
+            if (bytes_read < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                if (HTTP_WOULD_BLOCK() && HTTP_Wait(conn, POLLIN))
+                    continue;
+            }
+            return bytes_read;
+        }
     }
 }
 
 static void HTTP_HandleServerError(HTTP_Connection *conn)
 {
-    HTTP_Header *response = HTTP_Header_CreateServerHeader();
-    if (response)
+    size_t msg_len;
+    char *msg = html_server_error_page("No modules runend", &msg_len);
+    if (msg)
     {
-        HTTP_Header_Push(response, "Content-Type", "text/html", true);
-        size_t msg_len;
-        const char *msg = html_server_error_page("No modules runend", &msg_len);
-        char length_str[32];
-        snprintf(length_str, sizeof(length_str), "%zu", msg_len);
-        HTTP_Header_Push(response, "Content-Length", length_str, true);
-        HTTP_Header_SendToClient(conn, response, 500);
-        HTTP_Write(conn, msg, strlen(msg));
-        HTTP_Header_Destroy(&response);
+        HTTP_Response response;
+        HTTP_Response_Begin(&response, 500);
+        HTTP_Response_Header(&response, "Content-Type", "text/html");
+        HTTP_Response_Length(&response, msg_len);
+        if (HTTP_Response_Send(conn, &response))
+            HTTP_Write(conn, msg, msg_len);
+        free(msg);
     }
     conn->ended = true;
 }
 
-// --- Manipula uma conexão HTTP ---
-void *HTTP_HandleConnection(HTTP_Connection *conn)
+// --- Executa um módulo; retorna true quando ele encerrou a requisição (keep informa a conexão) ---
+static bool HTTP_RunModule(HTTP_Connection *conn, HTTP_Header *header, const HTTP_Module *module, size_t index, bool *keep)
 {
-    if (!conn || !conn->run)
-        return NULL;
-
-    bool keep_connection = false;
+    HTTP_Module_Response res = module->action(HTTP_Module_Internal(conn, index), conn, header);
 
-    do
+    switch (res)
     {
-        keep_connection = false;
+    case HTTP_MODULE_OK:
+        // Sucesso, termina processamento dos módulos
+        *keep = false;
+        return true;
 
-        HTTP_Header *receive_header = HTTP_Header_GetFromClient(conn);
-        if (!receive_header)
-            break;
+    case HTTP_MODULE_OK_HOLD:
+        // Mantém conexão ativa para próxima requisição
+        *keep = true;
+        return true;
+
+    case HTTP_MODULE_IGNORE:
+        // Continua para próximo módulo
+        return false;
+
+    case HTTP_MODULE_FAIL:
+        HTTP_PRINT_ERROR(stderr, "module failed: %s\n", module->name);
+        HTTP_HandleServerError(conn);
+        *keep = false;
+        return true;
+
+    case HTTP_MODULE_FATAL:
+        HTTP_PRINT_ERROR(stderr, "module forced exit: %s\n", module->name);
+        exit(EXIT_FAILURE);
+    }
+    return false;
+}
+
+// --- Executa a cadeia de módulos para uma requisição ---
+static bool HTTP_RunModules(HTTP_Connection *conn, HTTP_Header *header)
+{
+    bool keep = false;
+
+    // O alvo é analisado uma única vez; os módulos o recebem em conn->map
+    conn->map = HTTP_Map_Get_Arena(header, &conn->arena);
+    conn->param_count = 0;
+
+    // Com roteador: apenas os módulos das rotas casadas, na ordem de registro
+    if (conn->router)
+    {
+        if (!conn->map)
+        {
+            HTTP_Response response;
+            HTTP_Response_Begin(&response, 400);
+            HTTP_Response_Length(&response, 0);
+            HTTP_Response_Send(conn, &response);
+            return false;
+        }
 
-        bool handled = false; // Flag para saber se algum módulo processou com sucesso
+        unsigned method = HTTP_Method_Get(conn->map->method);
+        const HTTP_Route_Handler *handler = HTTP_Router_Match(conn->router, conn, method);
+        if (!handler)
+        {
+            HTTP_Response response;
+            HTTP_Response_Begin(&response, 404);
+            HTTP_Response_Length(&response, 0);
+            HTTP_Response_Send(conn, &response);
+            return false;
+        }
 
+        for (; handler->module; handler++)
+        {
+            // Cada módulo vê os parâmetros da rota que o casou
+            if (handler->param_count > 0)
+                memcpy(conn->params, handler->params, handler->param_count * sizeof(HTTP_Route_Param));
+            conn->param_count = handler->param_count;
+            if (HTTP_RunModule(conn, header, handler->module, handler->index, &keep))
+                return keep;
+        }
+    }
+    else
+    {
         // Processa cada módulo registrado
-        for (HTTP_Module **module = (HTTP_Module **)conn->modules; *module != NULL; module++)
+        for (size_t index = 0; conn->modules[index] != NULL; index++)
         {
-            HTTP_Module_Response res = (*module)->action((*module)->internal, conn, receive_header);
+            if (HTTP_RunModule(conn, header, conn->modules[index], index, &keep))
+                return keep;
+        }
+    }
 
-            switch (res)
-            {
-            case HTTP_MODULE_OK:
-                handled = true;
-                // Sucesso, termina processamento dos módulos
-                goto end_modules;
-
-            case HTTP_MODULE_OK_HOLD:
-                handled = true;
-                // Mantém conexão ativa para próxima requisição
-                keep_connection = true;
-                goto end_modules;
-
-            case HTTP_MODULE_IGNORE:
-                // Continua para próximo módulo
-                break;
+    // Se nenhum módulo processou com sucesso, envia erro 500
+    HTTP_HandleServerError(conn);
+    return false;
+}
+
+// --- Atende uma requisição; retorna true se a conexão deve ser mantida ---
+bool HTTP_Dispatch(HTTP_Connection *conn, HTTP_Header *header)
+{
+    HTTP_Connection_Deadline(conn, HTTP_TIMEOUT_WRITE);
 
-            case HTTP_MODULE_FAIL:
-                HTTP_PRINT_ERROR(stderr, "module failed: %s\n", (*module)->name);
-                HTTP_HandleServerError(conn);
-                HTTP_Header_Destroy(&receive_header);
-                conn->ended = true;
-                return NULL;
+    HTTP_Compress_Begin(conn, header);
+    bool keep = HTTP_RunModules(conn, header);
+    keep = HTTP_Compress_End(conn) && keep;
+
+    // O que os módulos acumularam sai em um único envio
+    return HTTP_Flush(conn) && keep;
+}
+
+// --- 0-RTT: responde as requisições seguras já completas nos dados antecipados ---
+// Chamado antes do Finished do cliente, a cada bloco recebido. A primeira requisição que não
+// pode ser repetida fica em *pending para depois do handshake; false encerra a conexão
+static bool HTTP_Dispatch_Early(HTTP_Connection *conn, HTTP_Header **pending)
+{
+    if (HTTP_H2_Negotiated(conn))
+        return true;
 
-            case HTTP_MODULE_FATAL:
-                HTTP_PRINT_ERROR(stderr, "module forced exit: %s\n", (*module)->name);
-                exit(EXIT_FAILURE);
+    char *end;
+    while (!*pending && (end = HTTP_Header_End(conn)) != NULL)
+    {
+        HTTP_Header *header = HTTP_Header_Take(conn, end);
+        if (!header)
+            return false;
+
+        if (!HTTP_TLS_Early_Safe(conn, header))
+        {
+            *pending = header;
+            break;
+        }
+
+        conn->early_write = true;
+        bool keep = HTTP_Dispatch(conn, header);
+        conn->early_write = false;
+        HTTP_Header_Consume(conn);
+        if (!keep)
+            return false;
+    }
+
+    HTTP_Connection_Deadline(conn, HTTP_TIMEOUT_HANDSHAKE);
+    return true;
+}
+
+// --- Atende a conexão até o fim (handshake, HTTP/2 ou laço de requisições) ---
+static void HTTP_Serve_Connection(HTTP_Connection *conn)
+{
+    HTTP_Header *pending = NULL; // Requisição dos dados 0-RTT que aguardou o handshake
+    if (conn->state == HTTP_STATE_HANDSHAKE)
+    {
+        HTTP_Connection_Deadline(conn, HTTP_TIMEOUT_HANDSHAKE);
+
+        int ret;
+        while ((ret = HTTP_TLS_Accept(conn, true)) != 1)
+        {
+            // Dados 0-RTT: requisições seguras são respondidas enquanto o cliente conclui o handshake
+            if (ret == 2)
+            {
+                if (HTTP_Dispatch_Early(conn, &pending))
+                    continue;
+                return;
             }
+
+            int err = SSL_get_error(conn->ssl, ret);
+            if (!((err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) &&
+                  HTTP_Wait(conn, err == SSL_ERROR_WANT_READ ? POLLIN : POLLOUT)))
+                break;
         }
 
-        // Se nenhum módulo processou com sucesso, envia erro 500
-        if (!handled)
+        bool success = ret > 0;
+        HTTP_Stats_Handshake(conn, success);
+        if (!success)
         {
-            HTTP_HandleServerError(conn);
-            HTTP_Header_Destroy(&receive_header);
-            return NULL;
+            HTTP_PRINT_SSL_ERROR(stderr, "ssl accept");
+            return;
         }
+        conn->state = HTTP_STATE_READ_HEADER;
 
-    end_modules:
+        // "h2" escolhido no ALPN: a conexão inteira segue pelo laço de quadros
+        if (HTTP_H2_Negotiated(conn))
+        {
+            HTTP_H2_Serve(conn);
+            return;
+        }
+    }
 
-        HTTP_Header_Destroy(&receive_header);
+    bool keep_connection = false;
+    HTTP_Timeout wait = HTTP_TIMEOUT_FIRST_BYTE;
+
+    do
+    {
+        // Bytes já recebidos (pipelining) contam como cabeçalho em andamento
+        HTTP_Connection_Deadline(conn, conn->buffer_used > 0 ? HTTP_TIMEOUT_HEADER : wait);
+        wait = HTTP_TIMEOUT_IDLE;
+
+        HTTP_Header *receive_header = pending ? pending : HTTP_Header_GetFromClient(conn);
+        pending = NULL;
+        if (!receive_header)
+            break;
+
+        keep_connection = HTTP_Dispatch(conn, receive_header);
+        HTTP_Header_Consume(conn);
 
     } while (keep_connection && *(conn->run));
+}
+
+// --- Manipula uma conexão HTTP (thread por conexão) ---
+// As threads usam a instância dos módulos do gerenciador, carregada uma vez em main()
+void *HTTP_HandleConnection(HTTP_Connection *conn)
+{
+    if (!conn || !conn->run)
+        return NULL;
+
+    HTTP_Serve_Connection(conn);
 
+    // Última ação da thread: a partir daqui o gerenciador pode reciclar a conexão
     conn->ended = true;
+    HTTP_Manager_Complete(conn->manager, conn);
     return NULL;
 }
@@ -0,0 +1,183 @@
+#include <nero_http.h>
+#include <string.h>
+#include <time.h>
+
+#define RESPONSE_SERVER "Server: NeroServer/0.1\r\n"
+#define RESPONSE_DATE_LENGTH 29 // "Sun, 06 Nov 1994 08:49:37 GMT"
+
+// --- Linhas de status pré-serializadas, já seguidas do Server e do nome do Date ---
+typedef struct
+{
+    int code;
+    const char *reason;
+    const char *prefix;
+    size_t length;
+} HTTP_Response_Status;
+
+#define STATUS(code, reason)                                                     \
+    {                                                                            \
+        code, reason, "HTTP/1.1 " #code " " reason "\r\n" RESPONSE_SERVER "Date: ", \
+            sizeof("HTTP/1.1 " #code " " reason "\r\n" RESPONSE_SERVER "Date: ") - 1 \
+    }
+
+static const HTTP_Response_Status response_status[] = {
+    STATUS(200, "OK"),
+    STATUS(206, "Partial Content"),
+    STATUS(304, "Not Modified"),
+    STATUS(404, "Not Found"),
+    STATUS(500, "Internal Server Error"),
+    STATUS(100, "Continue"),
+    STATUS(101, "Switching Protocols"),
+    STATUS(201, "Created"),
+    STATUS(202, "Accepted"),
+    STATUS(204, "No Content"),
+    STATUS(301, "Moved Permanently"),
+    STATUS(302, "Found"),
+    STATUS(303, "See Other"),
+    STATUS(307, "Temporary Redirect"),
+    STATUS(308, "Permanent Redirect"),
+    STATUS(400, "Bad Request"),
+    STATUS(401, "Unauthorized"),
+    STATUS(403, "Forbidden"),
+    STATUS(405, "Method Not Allowed"),
+    STATUS(408, "Request Timeout"),
+    STATUS(411, "Length Required"),
+    STATUS(412, "Precondition Failed"),
+    STATUS(413, "Content Too Large"),
+    STATUS(414, "URI Too Long"),
+    STATUS(416, "Range Not Satisfiable"),
+    STATUS(431, "Request Header Fields Too Large"),
+    STATUS(501, "Not Implemented"),
+    STATUS(502, "Bad Gateway"),
+    STATUS(503, "Service Unavailable"),
+    STATUS(505, "HTTP Version Not Supported"),
+};
+
+#undef STATUS
+
+#define RESPONSE_STATUS_COUNT (sizeof(response_status) / sizeof(response_status[0]))
+
+// Os mais usados ficam no início da tabela
+static const HTTP_Response_Status *response_find(int code)
+{
+    for (size_t i = 0; i < RESPONSE_STATUS_COUNT; i++)
+    {
+        if (response_status[i].code == code)
+            return &response_status[i];
+    }
+    return NULL;
+}
+
+// --- Frase de motivo do código (RFC 9110), "Unknown" para códigos fora da tabela ---
+const char *HTTP_Status_Reason(int code)
+{
+    const HTTP_Response_Status *status = response_find(code);
+    return status ? status->reason : "Unknown";
+}
+
+// --- Valor do Date no formato IMF-fixdate, refeito no máximo uma vez por segundo ---
+// Cada thread guarda sua cópia: sem travas nem corrida com quem está serializando
+static _Thread_local char date_value[RESPONSE_DATE_LENGTH + 1];
+static _Thread_local time_t date_second = -1;
+
+const char *HTTP_Date_Now(void)
+{
+    time_t now = time(NULL);
+    if (now != date_second)
+    {
+        struct tm tm_info;
+#ifdef _WIN32
+        gmtime_s(&tm_info, &now);
+#else
+        gmtime_r(&now, &tm_info);
+#endif
+        strftime(date_value, sizeof(date_value), "%a, %d %b %Y %H:%M:%S GMT", &tm_info);
+        date_second = now;
+    }
+    return date_value;
+}
+
+static bool response_append(HTTP_Response *response, const char *data, size_t length)
+{
+    if (response->overflow || HTTP_RESPONSE_HEAD_MAX - response->length < length)
+    {
+        response->overflow = true;
+        return false;
+    }
+    memcpy(response->data + response->length, data, length);
+    response->length += length;
+    return true;
+}
+
+// --- Inicia a resposta a partir do prefixo pronto do código ---
+bool HTTP_Response_Begin(HTTP_Response *response, int status_code)
+{
+    response->length = 0;
+    response->overflow = false;
+
+    const HTTP_Response_Status *status = response_find(status_code);
+    if (status)
+    {
+        memcpy(response->data, status->prefix, status->length);
+        response->length = status->length;
+    }
+    else
+    {
+        int length = snprintf(response->data, HTTP_RESPONSE_HEAD_MAX,
+                              "HTTP/1.1 %03d Unknown\r\n" RESPONSE_SERVER "Date: ", status_code);
+        if (length < 0)
+            return false;
+        response->length = (size_t)length;
+    }
+
+    response_append(response, HTTP_Date_Now(), RESPONSE_DATE_LENGTH);
+    return response_append(response, "\r\n", 2);
+}
+
+// --- Acrescenta um campo "name: value" ---
+bool HTTP_Response_Header(HTTP_Response *response, const char *name, const char *value)
+{
+    response_append(response, name, strlen(name));
+    response_append(response, ": ", 2);
+    response_append(response, value, strlen(value));
+    return response_append(response, "\r\n", 2);
+}
+
+// --- Acrescenta o Content-Length sem passar por printf ---
+bool HTTP_Response_Length(HTTP_Response *response, uint64_t length)
+{
+    char digits[20];
+    size_t count = 0;
+    do
+    {
+        digits[sizeof(digits) - ++count] = (char)('0' + length % 10);
+        length /= 10;
+    } while (length);
+
+    response_append(response, "Content-Length: ", sizeof("Content-Length: ") - 1);
+    response_append(response, digits + sizeof(digits) - count, count);
+    return response_append(response, "\r\n", 2);
+}
+
+// --- Acrescenta campos já serializados ("name: value\r\n" cada) ---
+bool HTTP_Response_Fields(HTTP_Response *response, const char *fields, size_t length)
+{
+    return response_append(response, fields, length);
+}
+
+// --- Fecha o bloco e o entrega para a saída da conexão ---
+bool HTTP_Response_Send(HTTP_Connection *conn, HTTP_Response *response)
+{
+    if (!response_append(response, "\r\n", 2))
+    {
+        HTTP_PRINT_ERROR(stderr, "response header too large");
+        return false;
+    }
+
+    if (HTTP_Write(conn, response->data, response->length) < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "failed to send header");
+        return false;
+    }
+    return true;
+}
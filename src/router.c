@@ -0,0 +1,477 @@
+#include <nero_module.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- Nó da árvore: a chave é uma sequência de segmentos literais ---
+// Cadeias de nós sem ramificação são fundidas em um só nó ao final da montagem
+typedef struct HTTP_Route_Node
+{
+    char **key; // Segmentos literais consumidos ao entrar no nó (vazia na raiz e nos parâmetros)
+    size_t key_count;
+    struct HTTP_Route_Node **children; // Filhos literais, ordenados pelo primeiro segmento
+    size_t child_count;
+    struct HTTP_Route_Node *param; // Filho ":nome"
+    char *param_name;
+    HTTP_Route_Handler *exact; // Rotas que terminam aqui
+    size_t exact_count;
+    HTTP_Route_Handler *rest; // Rotas "*nome" que capturam o restante a partir daqui
+    size_t rest_count;
+    char *rest_name;
+} HTTP_Route_Node;
+
+struct HTTP_Router
+{
+    HTTP_Route_Node *root;
+    size_t module_count; // Limite de candidatos por requisição: um por módulo
+};
+
+// Candidatos acumulados pela busca de uma requisição
+typedef struct
+{
+    HTTP_Route_Handler *list;
+    size_t count;
+} HTTP_Route_Candidates;
+
+static char *route_strndup(const char *string, size_t length)
+{
+    char *copy = malloc(length + 1);
+    if (!copy)
+    {
+        HTTP_PRINT_ERROR(stderr, "malloc");
+        return NULL;
+    }
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+static HTTP_Route_Node *route_node(void)
+{
+    HTTP_Route_Node *node = calloc(1, sizeof(HTTP_Route_Node));
+    if (!node)
+        HTTP_PRINT_ERROR(stderr, "calloc");
+    return node;
+}
+
+static void route_node_destroy(HTTP_Route_Node *node)
+{
+    if (!node)
+        return;
+    for (size_t i = 0; i < node->key_count; i++)
+        free(node->key[i]);
+    for (size_t i = 0; i < node->child_count; i++)
+        route_node_destroy(node->children[i]);
+    route_node_destroy(node->param);
+    free(node->key);
+    free(node->children);
+    free(node->param_name);
+    free(node->exact);
+    free(node->rest);
+    free(node->rest_name);
+    free(node);
+}
+
+// Acrescenta o módulo à lista terminada por NULL (uma entrada de folga para o terminador)
+static bool route_add_handler(HTTP_Route_Handler **list, size_t *count, const HTTP_Module *module, size_t index, unsigned methods)
+{
+    HTTP_Route_Handler *grown = realloc(*list, (*count + 2) * sizeof(HTTP_Route_Handler));
+    if (!grown)
+    {
+        HTTP_PRINT_ERROR(stderr, "realloc");
+        return false;
+    }
+    grown[*count].module = module;
+    grown[*count].methods = methods;
+    grown[*count].index = index;
+    grown[*count].params = NULL;
+    grown[*count].param_count = 0;
+    grown[*count + 1] = (HTTP_Route_Handler){0};
+    *list = grown;
+    (*count)++;
+    return true;
+}
+
+static int route_compare(const void *a, const void *b)
+{
+    const HTTP_Route_Node *left = *(const HTTP_Route_Node *const *)a;
+    const HTTP_Route_Node *right = *(const HTTP_Route_Node *const *)b;
+    return strcmp(left->key[0], right->key[0]);
+}
+
+// Filho literal para o segmento, criado se preciso (a ordenação é feita ao final)
+static HTTP_Route_Node *route_child(HTTP_Route_Node *node, const char *segment, size_t length)
+{
+    for (size_t i = 0; i < node->child_count; i++)
+    {
+        if (strlen(node->children[i]->key[0]) == length && strncmp(node->children[i]->key[0], segment, length) == 0)
+            return node->children[i];
+    }
+
+    HTTP_Route_Node **children = realloc(node->children, (node->child_count + 1) * sizeof(*children));
+    if (!children)
+    {
+        HTTP_PRINT_ERROR(stderr, "realloc");
+        return NULL;
+    }
+    node->children = children;
+
+    HTTP_Route_Node *child = route_node();
+    if (!child)
+        return NULL;
+    child->key = malloc(sizeof(char *));
+    if (child->key)
+        child->key[0] = route_strndup(segment, length);
+    if (!child->key || !child->key[0])
+    {
+        HTTP_PRINT_ERROR(stderr, "malloc");
+        free(child->key);
+        free(child);
+        return NULL;
+    }
+    child->key_count = 1;
+    node->children[node->child_count++] = child;
+    return child;
+}
+
+// --- Insere um padrão, um segmento por nó ---
+static bool route_insert(HTTP_Route_Node *node, const HTTP_Module *module, size_t index, const HTTP_Route *route)
+{
+    const char *p = route->pattern;
+    while (*p)
+    {
+        if (*p == '/')
+        {
+            p++;
+            continue;
+        }
+
+        const char *slash = strchr(p, '/');
+        size_t length = slash ? (size_t)(slash - p) : strlen(p);
+
+        if (*p == '*')
+        {
+            if (slash && slash[strspn(slash, "/")])
+            {
+                HTTP_PRINT_ERROR(stderr, "route %s: '*' must be the last segment\n", route->pattern);
+                return false;
+            }
+            if (!node->rest_name && !(node->rest_name = route_strndup(p + 1, length - 1)))
+                return false;
+            return route_add_handler(&node->rest, &node->rest_count, module, index, route->methods);
+        }
+
+        if (*p == ':')
+        {
+            if (!node->param)
+            {
+                node->param = route_node();
+                if (!node->param || !(node->param->param_name = route_strndup(p + 1, length - 1)))
+                    return false;
+            }
+            else if (strlen(node->param->param_name) != length - 1 ||
+                     strncmp(node->param->param_name, p + 1, length - 1) != 0)
+            {
+                HTTP_PRINT_ERROR(stderr, "route %s: parameter conflicts with :%s\n", route->pattern, node->param->param_name);
+                return false;
+            }
+            node = node->param;
+        }
+        else
+        {
+            node = route_child(node, p, length);
+            if (!node)
+                return false;
+        }
+        p += length;
+    }
+
+    return route_add_handler(&node->exact, &node->exact_count, module, index, route->methods);
+}
+
+// --- Funde filhos únicos sem rotas próprias e ordena os filhos para a busca binária ---
+static bool route_compile(HTTP_Route_Node *node)
+{
+    for (size_t i = 0; i < node->child_count; i++)
+    {
+        HTTP_Route_Node *child = node->children[i];
+        while (child->child_count == 1 && !child->param && !child->exact && !child->rest)
+        {
+            HTTP_Route_Node *only = child->children[0];
+            char **key = realloc(child->key, (child->key_count + only->key_count) * sizeof(char *));
+            if (!key)
+            {
+                HTTP_PRINT_ERROR(stderr, "realloc");
+                return false;
+            }
+            memcpy(key + child->key_count, only->key, only->key_count * sizeof(char *));
+            child->key = key;
+            child->key_count += only->key_count;
+
+            free(child->children);
+            child->children = only->children;
+            child->child_count = only->child_count;
+            child->param = only->param;
+            child->exact = only->exact;
+            child->exact_count = only->exact_count;
+            child->rest = only->rest;
+            child->rest_count = only->rest_count;
+            child->rest_name = only->rest_name;
+
+            free(only->key);
+            free(only);
+        }
+        if (!route_compile(child))
+            return false;
+    }
+
+    if (node->param && !route_compile(node->param))
+        return false;
+
+    if (node->child_count > 1)
+        qsort(node->children, node->child_count, sizeof(*node->children), route_compare);
+    return true;
+}
+
+// --- Monta a árvore com as rotas de todos os módulos, na ordem da lista ---
+HTTP_Router *HTTP_Router_Create(const HTTP_Module **modules)
+{
+    static const HTTP_Route everything[] = {{HTTP_METHOD_ANY, "/*"}, {0}};
+
+    HTTP_Router *router = calloc(1, sizeof(HTTP_Router));
+    if (!router || !(router->root = route_node()))
+    {
+        HTTP_PRINT_ERROR(stderr, "calloc");
+        free(router);
+        return NULL;
+    }
+
+    for (const HTTP_Module **module = modules; module && *module; module++)
+    {
+        router->module_count++;
+        const HTTP_Route *routes = (*module)->routes ? (*module)->routes : everything;
+        for (const HTTP_Route *route = routes; route->pattern; route++)
+        {
+            if (!route_insert(router->root, *module, (size_t)(module - modules), route))
+            {
+                HTTP_PRINT_ERROR(stderr, "failed to register route %s of %s\n", route->pattern, (*module)->name);
+                HTTP_Router_Destroy(&router);
+                return NULL;
+            }
+        }
+    }
+
+    if (!route_compile(router->root))
+    {
+        HTTP_Router_Destroy(&router);
+        return NULL;
+    }
+    return router;
+}
+
+void HTTP_Router_Destroy(HTTP_Router **router)
+{
+    if (!router || !*router)
+        return;
+    route_node_destroy((*router)->root);
+    free(*router);
+    *router = NULL;
+}
+
+// --- Converte o método da requisição para a máscara das rotas ---
+unsigned HTTP_Method_Get(const char *method)
+{
+    static const struct
+    {
+        const char *name;
+        unsigned mask;
+    } methods[] = {
+        {"GET", HTTP_METHOD_GET},
+        {"HEAD", HTTP_METHOD_HEAD},
+        {"POST", HTTP_METHOD_POST},
+        {"PUT", HTTP_METHOD_PUT},
+        {"DELETE", HTTP_METHOD_DELETE},
+        {"OPTIONS", HTTP_METHOD_OPTIONS},
+        {"PATCH", HTTP_METHOD_PATCH},
+    };
+
+    for (size_t i = 0; method && i < sizeof(methods) / sizeof(methods[0]); i++)
+    {
+        if (strcmp(method, methods[i].name) == 0)
+            return methods[i].mask;
+    }
+    return HTTP_METHOD_OTHER;
+}
+
+static bool route_accepts(const HTTP_Route_Handler *handlers, unsigned method)
+{
+    for (; handlers && handlers->module; handlers++)
+    {
+        if (handlers->methods & method)
+            return true;
+    }
+    return false;
+}
+
+// Acrescenta os módulos da lista que atendem o método, com os parâmetros capturados até aqui.
+// A busca visita as rotas da mais específica para a menos: cada módulo fica com a primeira
+static bool route_collect(HTTP_Connection *conn, HTTP_Route_Candidates *candidates,
+                          const HTTP_Route_Handler *handlers, unsigned method)
+{
+    for (; handlers && handlers->module; handlers++)
+    {
+        if (!(handlers->methods & method))
+            continue;
+
+        size_t i = 0;
+        while (i < candidates->count && candidates->list[i].index != handlers->index)
+            i++;
+        if (i < candidates->count)
+            continue;
+
+        HTTP_Route_Param *params = NULL;
+        if (conn->param_count > 0)
+        {
+            params = HTTP_Arena_Alloc(&conn->arena, conn->param_count * sizeof(HTTP_Route_Param));
+            if (!params)
+                return false;
+            memcpy(params, conn->params, conn->param_count * sizeof(HTTP_Route_Param));
+        }
+
+        HTTP_Route_Handler *candidate = &candidates->list[candidates->count++];
+        *candidate = *handlers;
+        candidate->params = params;
+        candidate->param_count = conn->param_count;
+    }
+    return true;
+}
+
+// Junta os segmentos restantes ("a/b") na arena da requisição
+static const char *route_rest(HTTP_Connection *conn, const HTTP_Map *map, size_t index)
+{
+    size_t length = 0;
+    for (size_t i = index; i < map->count; i++)
+        length += strlen(map->path[i]) + 1;
+
+    char *rest = HTTP_Arena_Alloc(&conn->arena, length + 1);
+    if (!rest)
+        return NULL;
+
+    char *p = rest;
+    for (size_t i = index; i < map->count; i++)
+    {
+        if (p != rest)
+            *p++ = '/';
+        size_t segment_length = strlen(map->path[i]);
+        memcpy(p, map->path[i], segment_length);
+        p += segment_length;
+    }
+    *p = '\0';
+    return rest;
+}
+
+// --- Busca completa: literal, depois parâmetro, depois captura do restante ---
+// Todas as rotas que casam viram candidatas; conn->params serve de pilha durante a descida
+static bool route_match(const HTTP_Route_Node *node, HTTP_Connection *conn, const HTTP_Map *map,
+                        size_t index, unsigned method, HTTP_Route_Candidates *candidates)
+{
+    size_t param_count = conn->param_count;
+
+    if (index == map->count && !route_collect(conn, candidates, node->exact, method))
+        return false;
+
+    if (index < map->count)
+    {
+        // Filhos ordenados: busca binária pelo primeiro segmento da chave
+        size_t low = 0, high = node->child_count;
+        while (low < high)
+        {
+            size_t middle = (low + high) / 2;
+            const HTTP_Route_Node *child = node->children[middle];
+            int order = strcmp(map->path[index], child->key[0]);
+            if (order == 0)
+            {
+                size_t k = 1;
+                while (k < child->key_count && index + k < map->count && strcmp(map->path[index + k], child->key[k]) == 0)
+                    k++;
+                if (k == child->key_count && !route_match(child, conn, map, index + k, method, candidates))
+                    return false;
+                break;
+            }
+            if (order < 0)
+                high = middle;
+            else
+                low = middle + 1;
+        }
+
+        if (node->param && conn->param_count < HTTP_ROUTE_MAX_PARAMS)
+        {
+            HTTP_Route_Param *param = &conn->params[conn->param_count++];
+            param->name = node->param->param_name;
+            param->value = map->path[index];
+            if (!route_match(node->param, conn, map, index + 1, method, candidates))
+                return false;
+            conn->param_count = param_count;
+        }
+    }
+
+    if (route_accepts(node->rest, method))
+    {
+        if (*node->rest_name && conn->param_count < HTTP_ROUTE_MAX_PARAMS)
+        {
+            const char *rest = route_rest(conn, map, index);
+            if (rest)
+            {
+                conn->params[conn->param_count].name = node->rest_name;
+                conn->params[conn->param_count++].value = rest;
+            }
+        }
+        if (!route_collect(conn, candidates, node->rest, method))
+            return false;
+        conn->param_count = param_count;
+    }
+    return true;
+}
+
+// --- Módulos de todas as rotas que casam com conn->map, na ordem de registro (NULL se nenhum) ---
+// Um módulo que retorna IGNORE passa a requisição ao próximo, como na antiga cadeia linear; cada
+// candidato traz os parâmetros da sua rota, copiados para conn->params antes de chamá-lo
+const HTTP_Route_Handler *HTTP_Router_Match(const HTTP_Router *router, HTTP_Connection *conn, unsigned method)
+{
+    conn->param_count = 0;
+    if (!router || !conn->map)
+        return NULL;
+
+    HTTP_Route_Candidates candidates = {
+        .list = HTTP_Arena_Alloc(&conn->arena, (router->module_count + 1) * sizeof(HTTP_Route_Handler)),
+    };
+    if (!candidates.list)
+        return NULL;
+
+    bool matched = route_match(router->root, conn, conn->map, 0, method, &candidates);
+    conn->param_count = 0;
+    if (!matched || candidates.count == 0)
+        return NULL;
+
+    // Poucos candidatos: inserção pela posição de registro
+    for (size_t i = 1; i < candidates.count; i++)
+    {
+        HTTP_Route_Handler handler = candidates.list[i];
+        size_t j = i;
+        for (; j > 0 && candidates.list[j - 1].index > handler.index; j--)
+            candidates.list[j] = candidates.list[j - 1];
+        candidates.list[j] = handler;
+    }
+    candidates.list[candidates.count] = (HTTP_Route_Handler){0};
+    return candidates.list;
+}
+
+// --- Valor de um parâmetro capturado pela rota da requisição atual ---
+const char *HTTP_Route_Get(HTTP_Connection *conn, const char *name)
+{
+    for (size_t i = 0; conn && i < conn->param_count; i++)
+    {
+        if (strcmp(conn->params[i].name, name) == 0)
+            return conn->params[i].value;
+    }
+    return NULL;
+}
@@ -0,0 +1,277 @@
+#include <nero_http.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// --- Caracteres válidos em nomes de campo (tchar, RFC 9110) ---
+static const bool scan_tchar[256] = {
+    ['!'] = true, ['#'] = true, ['$'] = true, ['%'] = true, ['&'] = true, ['\''] = true,
+    ['*'] = true, ['+'] = true, ['-'] = true, ['.'] = true, ['^'] = true, ['_'] = true,
+    ['`'] = true, ['|'] = true, ['~'] = true,
+    ['0'] = true, ['1'] = true, ['2'] = true, ['3'] = true, ['4'] = true,
+    ['5'] = true, ['6'] = true, ['7'] = true, ['8'] = true, ['9'] = true,
+    ['A'] = true, ['B'] = true, ['C'] = true, ['D'] = true, ['E'] = true, ['F'] = true, ['G'] = true,
+    ['H'] = true, ['I'] = true, ['J'] = true, ['K'] = true, ['L'] = true, ['M'] = true, ['N'] = true,
+    ['O'] = true, ['P'] = true, ['Q'] = true, ['R'] = true, ['S'] = true, ['T'] = true, ['U'] = true,
+    ['V'] = true, ['W'] = true, ['X'] = true, ['Y'] = true, ['Z'] = true,
+    ['a'] = true, ['b'] = true, ['c'] = true, ['d'] = true, ['e'] = true, ['f'] = true, ['g'] = true,
+    ['h'] = true, ['i'] = true, ['j'] = true, ['k'] = true, ['l'] = true, ['m'] = true, ['n'] = true,
+    ['o'] = true, ['p'] = true, ['q'] = true, ['r'] = true, ['s'] = true, ['t'] = true, ['u'] = true,
+    ['v'] = true, ['w'] = true, ['x'] = true, ['y'] = true, ['z'] = true};
+
+// --- Núcleos escalares (referência e cauda dos vetoriais) ---
+static const char *scan_header_end_scalar(const char *p, const char *end)
+{
+    while (end - p >= 4)
+    {
+        p = memchr(p, '\r', (size_t)(end - p - 3));
+        if (!p)
+            return NULL;
+        if (p[1] == '\n' && p[2] == '\r' && p[3] == '\n')
+            return p + 4;
+        p++;
+    }
+    return NULL;
+}
+
+static const char *scan_any_scalar(const char *p, const char *end, char a, char b)
+{
+    for (; p < end; p++)
+    {
+        if (*p == a || *p == b)
+            return p;
+    }
+    return end;
+}
+
+static size_t scan_token_scalar(const char *p, const char *end)
+{
+    const char *start = p;
+    while (p < end && scan_tchar[(unsigned char)*p])
+        p++;
+    return (size_t)(p - start);
+}
+
+#ifdef SCAN_X86
+
+// Tabelas por nibble para validar tchar com pshufb: o byte é válido quando
+// low[b & 0xF] & high[b >> 4] != 0 (o nibble alto escolhe um bit de 0 a 7)
+#define SCAN_TCHAR_LOW 0xe8, 0xfc, 0xf8, 0xfc, 0xfc, 0xfc, 0xfc, 0xfc, \
+                       0xf8, 0xf8, 0xf4, 0x54, 0xd0, 0x54, 0xf4, 0x70
+#define SCAN_TCHAR_HIGH 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, \
+                        0, 0, 0, 0, 0, 0, 0, 0
+
+// --- SSE4.2: pcmpestri procura o terminador e conjuntos de caracteres 16 bytes por vez ---
+__attribute__((target("sse4.2")))
+static const char *scan_header_end_sse42(const char *p, const char *end)
+{
+    const __m128i needle = _mm_setr_epi8('\r', '\n', '\r', '\n', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    while (end - p >= 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)p);
+        int index = _mm_cmpestri(needle, 4, block, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ORDERED);
+        if (index == 16)
+        {
+            p += 16;
+            continue;
+        }
+
+        // Correspondência parcial no fim do bloco: recomeça a partir dela
+        if (index > 12)
+        {
+            p += index;
+            continue;
+        }
+        return p + index + 4;
+    }
+    return scan_header_end_scalar(p, end);
+}
+
+__attribute__((target("sse4.2")))
+static const char *scan_any_sse42(const char *p, const char *end, char a, char b)
+{
+    const __m128i set = _mm_setr_epi8(a, b, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    while (end - p >= 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)p);
+        int index = _mm_cmpestri(set, 2, block, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY);
+        if (index < 16)
+            return p + index;
+        p += 16;
+    }
+    return scan_any_scalar(p, end, a, b);
+}
+
+__attribute__((target("sse4.2")))
+static size_t scan_token_sse42(const char *p, const char *end)
+{
+    const __m128i low = _mm_setr_epi8(SCAN_TCHAR_LOW);
+    const __m128i high = _mm_setr_epi8(SCAN_TCHAR_HIGH);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const char *start = p;
+
+    while (end - p >= 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)p);
+        __m128i lo = _mm_shuffle_epi8(low, _mm_and_si128(block, nibble));
+        __m128i hi = _mm_shuffle_epi8(high, _mm_and_si128(_mm_srli_epi16(block, 4), nibble));
+        __m128i invalid = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+        int mask = _mm_movemask_epi8(invalid);
+        if (mask)
+            return (size_t)(p - start) + (size_t)__builtin_ctz((unsigned)mask);
+        p += 16;
+    }
+    return (size_t)(p - start) + scan_token_scalar(p, end);
+}
+
+// --- AVX2: comparações de 32 bytes por vez ---
+__attribute__((target("avx2")))
+static const char *scan_header_end_avx2(const char *p, const char *end)
+{
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    // Quatro cargas deslocadas: o bit i indica \r\n\r\n começando em p + i
+    while (end - p >= 35)
+    {
+        __m256i m0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), cr);
+        __m256i m1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + 1)), lf);
+        __m256i m2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + 2)), cr);
+        __m256i m3 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + 3)), lf);
+        unsigned mask = (unsigned)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_and_si256(m0, m1), _mm256_and_si256(m2, m3)));
+        if (mask)
+            return p + __builtin_ctz(mask) + 4;
+        p += 32;
+    }
+    return scan_header_end_scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char *scan_any_avx2(const char *p, const char *end, char a, char b)
+{
+    const __m256i va = _mm256_set1_epi8(a);
+    const __m256i vb = _mm256_set1_epi8(b);
+
+    while (end - p >= 32)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i *)p);
+        unsigned mask = (unsigned)_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, va), _mm256_cmpeq_epi8(block, vb)));
+        if (mask)
+            return p + __builtin_ctz(mask);
+        p += 32;
+    }
+    return scan_any_scalar(p, end, a, b);
+}
+
+__attribute__((target("avx2")))
+static size_t scan_token_avx2(const char *p, const char *end)
+{
+    const __m256i low = _mm256_setr_epi8(SCAN_TCHAR_LOW, SCAN_TCHAR_LOW);
+    const __m256i high = _mm256_setr_epi8(SCAN_TCHAR_HIGH, SCAN_TCHAR_HIGH);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const char *start = p;
+
+    while (end - p >= 32)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i *)p);
+        __m256i lo = _mm256_shuffle_epi8(low, _mm256_and_si256(block, nibble));
+        __m256i hi = _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble));
+        __m256i invalid = _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), _mm256_setzero_si256());
+        unsigned mask = (unsigned)_mm256_movemask_epi8(invalid);
+        if (mask)
+            return (size_t)(p - start) + (size_t)__builtin_ctz(mask);
+        p += 32;
+    }
+    return (size_t)(p - start) + scan_token_sse42(p, end);
+}
+
+#endif
+
+// --- Conjunto de núcleos ativo; escalar até HTTP_Scan_Init ---
+typedef struct
+{
+    const char *(*header_end)(const char *p, const char *end);
+    const char *(*any)(const char *p, const char *end, char a, char b);
+    size_t (*token)(const char *p, const char *end);
+} HTTP_Scan_Kernels;
+
+static const HTTP_Scan_Kernels scan_kernels[HTTP_SCAN_COUNT] = {
+    [HTTP_SCAN_SCALAR] = {scan_header_end_scalar, scan_any_scalar, scan_token_scalar},
+#ifdef SCAN_X86
+    [HTTP_SCAN_SSE42] = {scan_header_end_sse42, scan_any_sse42, scan_token_sse42},
+    [HTTP_SCAN_AVX2] = {scan_header_end_avx2, scan_any_avx2, scan_token_avx2},
+#endif
+};
+
+static const char *scan_names[HTTP_SCAN_COUNT] = {"scalar", "sse4.2", "avx2"};
+static HTTP_Scan_Level scan_level = HTTP_SCAN_SCALAR;
+
+// --- Indica se a CPU executa os núcleos do nível ---
+bool HTTP_Scan_Supported(HTTP_Scan_Level level)
+{
+    switch (level)
+    {
+    case HTTP_SCAN_SCALAR:
+        return true;
+#ifdef SCAN_X86
+    case HTTP_SCAN_SSE42:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2");
+    case HTTP_SCAN_AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("sse4.2");
+#endif
+    default:
+        return false;
+    }
+}
+
+// --- Força um nível (benchmark); false se a CPU não o suporta ---
+bool HTTP_Scan_Use(HTTP_Scan_Level level)
+{
+    if (level < 0 || level >= HTTP_SCAN_COUNT || !HTTP_Scan_Supported(level))
+        return false;
+    scan_level = level;
+    return true;
+}
+
+// --- Escolhe o melhor nível suportado; chamar antes de criar threads ---
+void HTTP_Scan_Init(void)
+{
+    for (int level = HTTP_SCAN_COUNT - 1; level > HTTP_SCAN_SCALAR; level--)
+    {
+        if (HTTP_Scan_Use((HTTP_Scan_Level)level))
+            return;
+    }
+    scan_level = HTTP_SCAN_SCALAR;
+}
+
+const char *HTTP_Scan_Name(void)
+{
+    return scan_names[scan_level];
+}
+
+// --- Posição logo após o primeiro \r\n\r\n em [data, end), ou NULL ---
+const char *HTTP_Scan_HeaderEnd(const char *data, const char *end)
+{
+    return scan_kernels[scan_level].header_end(data, end);
+}
+
+// --- Primeira ocorrência de a ou b em [data, end), ou end ---
+const char *HTTP_Scan_Any(const char *data, const char *end, char a, char b)
+{
+    return scan_kernels[scan_level].any(data, end, a, b);
+}
+
+// --- Comprimento do prefixo de data formado só por caracteres de token ---
+size_t HTTP_Scan_Token(const char *data, const char *end)
+{
+    return scan_kernels[scan_level].token(data, end);
+}
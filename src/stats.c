@@ -0,0 +1,89 @@
+#include <nero_http.h>
+#include <stdatomic.h>
+#include <time.h>
+
+// --- Contadores globais, atualizados sem lock por todas as threads ---
+static atomic_uint_fast64_t handshake_count;
+static atomic_uint_fast64_t handshake_failed;
+static atomic_uint_fast64_t handshake_total_ns;
+static atomic_uint_fast64_t handshake_max_ns;
+static atomic_uint_fast64_t handshake_resumed;
+static atomic_uint_fast64_t handshake_early;
+static atomic_uint_fast64_t timeouts[HTTP_TIMEOUT_COUNT];
+static atomic_uint_fast64_t file_bytes[HTTP_FILE_PATH_COUNT];
+
+// --- Relógio monotônico em nanossegundos ---
+uint64_t HTTP_Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// --- Registra um handshake TLS (latência medida desde o accept) ---
+void HTTP_Stats_Handshake(HTTP_Connection *conn, bool success)
+{
+    if (!success)
+    {
+        atomic_fetch_add_explicit(&handshake_failed, 1, memory_order_relaxed);
+        return;
+    }
+
+    uint64_t elapsed = HTTP_Now() - conn->accepted_at;
+    atomic_fetch_add_explicit(&handshake_count, 1, memory_order_relaxed);
+    if (SSL_session_reused(conn->ssl))
+        atomic_fetch_add_explicit(&handshake_resumed, 1, memory_order_relaxed);
+    if (SSL_get_early_data_status(conn->ssl) == SSL_EARLY_DATA_ACCEPTED)
+        atomic_fetch_add_explicit(&handshake_early, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&handshake_total_ns, elapsed, memory_order_relaxed);
+
+    uint_fast64_t max = atomic_load_explicit(&handshake_max_ns, memory_order_relaxed);
+    while (elapsed > max &&
+           !atomic_compare_exchange_weak_explicit(&handshake_max_ns, &max, elapsed,
+                                                  memory_order_relaxed, memory_order_relaxed))
+        ;
+}
+
+// --- Registra uma conexão encerrada por prazo vencido ---
+void HTTP_Stats_Timeout(HTTP_Timeout timeout)
+{
+    atomic_fetch_add_explicit(&timeouts[timeout], 1, memory_order_relaxed);
+}
+
+// --- Registra o corpo de um arquivo enviado por um dos caminhos ---
+void HTTP_Stats_File(HTTP_File_Path path, uint64_t bytes)
+{
+    atomic_fetch_add_explicit(&file_bytes[path], bytes, memory_order_relaxed);
+}
+
+// --- Imprime os contadores acumulados ---
+void HTTP_Stats_Print(FILE *fd)
+{
+    uint64_t count = atomic_load(&handshake_count);
+    uint64_t total = atomic_load(&handshake_total_ns);
+    uint64_t resumed = atomic_load(&handshake_resumed);
+
+    fprintf(fd, "TLS handshakes: %llu ok (%llu completos, %llu retomados, %llu com 0-RTT), %llu falhos, média %.3f ms, máximo %.3f ms\n",
+            (unsigned long long)count,
+            (unsigned long long)(count - resumed),
+            (unsigned long long)resumed,
+            (unsigned long long)atomic_load(&handshake_early),
+            (unsigned long long)atomic_load(&handshake_failed),
+            count ? (double)total / (double)count / 1e6 : 0.0,
+            (double)atomic_load(&handshake_max_ns) / 1e6);
+    fprintf(fd, "Prazos vencidos: handshake %llu, primeiro byte %llu, cabeçalho %llu, ociosa %llu, escrita %llu\n",
+            (unsigned long long)atomic_load(&timeouts[HTTP_TIMEOUT_HANDSHAKE]),
+            (unsigned long long)atomic_load(&timeouts[HTTP_TIMEOUT_FIRST_BYTE]),
+            (unsigned long long)atomic_load(&timeouts[HTTP_TIMEOUT_HEADER]),
+            (unsigned long long)atomic_load(&timeouts[HTTP_TIMEOUT_IDLE]),
+            (unsigned long long)atomic_load(&timeouts[HTTP_TIMEOUT_WRITE]));
+    fprintf(fd, "Corpo de arquivos: cópia %llu bytes, sendfile %llu bytes, kTLS %llu bytes\n",
+            (unsigned long long)atomic_load(&file_bytes[HTTP_FILE_COPY]),
+            (unsigned long long)atomic_load(&file_bytes[HTTP_FILE_SENDFILE]),
+            (unsigned long long)atomic_load(&file_bytes[HTTP_FILE_KTLS]));
+    HTTP_TLS_Stats_Print(fd);
+    HTTP_File_Cache_Stats_Print(fd);
+    HTTP_Fd_Cache_Stats_Print(fd);
+    HTTP_File_Watch_Stats_Print(fd);
+    HTTP_Compress_Stats_Print(fd);
+}
@@ -0,0 +1,105 @@
+#include <nero_http.h>
+#include <string.h>
+
+#define TIMER_TICK_NS ((uint64_t)HTTP_TIMER_TICK_MS * 1000000ull)
+#define TIMER_MASK (HTTP_TIMER_SLOTS - 1)
+#define TIMER_RANGE(level) ((uint64_t)1 << (HTTP_TIMER_BITS * (level)))
+
+// --- Encadeia a entrada na posição correspondente ao seu tick de expiração ---
+static void timer_link(HTTP_Timer_Wheel *wheel, HTTP_Timer *timer)
+{
+    if (timer->expires < wheel->tick)
+        timer->expires = wheel->tick;
+
+    uint64_t delta = timer->expires - wheel->tick;
+    int level = 0;
+    while (level < HTTP_TIMER_LEVELS - 1 && delta >= TIMER_RANGE(level + 1))
+        level++;
+
+    // Além do alcance da roda: fica no último nível e é reavaliado ao descer
+    if (delta >= TIMER_RANGE(HTTP_TIMER_LEVELS))
+        timer->expires = wheel->tick + TIMER_RANGE(HTTP_TIMER_LEVELS) - 1;
+
+    HTTP_Timer **slot = &wheel->slots[level][(timer->expires >> (HTTP_TIMER_BITS * level)) & TIMER_MASK];
+    timer->next = *slot;
+    if (*slot)
+        (*slot)->pprev = &timer->next;
+    timer->pprev = slot;
+    *slot = timer;
+}
+
+// --- Redistribui uma posição de nível superior pelos níveis inferiores ---
+static void timer_cascade(HTTP_Timer_Wheel *wheel, int level)
+{
+    HTTP_Timer **slot = &wheel->slots[level][(wheel->tick >> (HTTP_TIMER_BITS * level)) & TIMER_MASK];
+    HTTP_Timer *timer = *slot;
+    *slot = NULL;
+
+    while (timer)
+    {
+        HTTP_Timer *next = timer->next;
+        timer_link(wheel, timer);
+        timer = next;
+    }
+}
+
+// --- Inicializa a roda vazia a partir do instante atual ---
+void HTTP_Timer_Init(HTTP_Timer_Wheel *wheel, uint64_t now)
+{
+    memset(wheel, 0, sizeof(HTTP_Timer_Wheel));
+    wheel->start = now;
+}
+
+// --- Arma (ou rearma) a entrada para o prazo absoluto em ns ---
+void HTTP_Timer_Arm(HTTP_Timer_Wheel *wheel, HTTP_Timer *timer, uint64_t deadline)
+{
+    HTTP_Timer_Cancel(timer);
+
+    // Arredonda para cima: uma entrada nunca expira antes do prazo
+    uint64_t elapsed = deadline > wheel->start ? deadline - wheel->start : 0;
+    timer->expires = (elapsed + TIMER_TICK_NS - 1) / TIMER_TICK_NS;
+    timer_link(wheel, timer);
+}
+
+// --- Remove a entrada da roda; nada faz se já estiver desarmada ---
+void HTTP_Timer_Cancel(HTTP_Timer *timer)
+{
+    if (!timer->pprev)
+        return;
+
+    *timer->pprev = timer->next;
+    if (timer->next)
+        timer->next->pprev = timer->pprev;
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+// --- Avança a roda até o instante atual e retorna as entradas vencidas ---
+// As entradas retornadas já estão desarmadas e encadeadas por next
+HTTP_Timer *HTTP_Timer_Expire(HTTP_Timer_Wheel *wheel, uint64_t now)
+{
+    HTTP_Timer *expired = NULL;
+    uint64_t target = now > wheel->start ? (now - wheel->start) / TIMER_TICK_NS : 0;
+
+    for (; wheel->tick <= target; wheel->tick++)
+    {
+        // Ao completar uma volta de um nível, desce a posição seguinte do nível acima
+        for (int level = 1; level < HTTP_TIMER_LEVELS; level++)
+        {
+            if ((wheel->tick & (TIMER_RANGE(level) - 1)) != 0)
+                break;
+            timer_cascade(wheel, level);
+        }
+
+        HTTP_Timer **slot = &wheel->slots[0][wheel->tick & TIMER_MASK];
+        while (*slot)
+        {
+            HTTP_Timer *timer = *slot;
+            HTTP_Timer_Cancel(timer);
+            timer->next = expired;
+            expired = timer;
+        }
+    }
+
+    return expired;
+}
@@ -0,0 +1,576 @@
+#include <nero_http.h>
+#include <nero_module.h>
+#include <openssl/rand.h>
+#include <openssl/hmac.h>
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#endif
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TLS_CACHE_BUCKETS 512 // Posições da tabela de cada partição
+#define TLS_TICKET_SECRET_MAX 256
+
+// --- Cache de sessões compartilhado por todos os laços e threads ---
+// Sessões serializadas (DER) em partições com trava própria; cada partição respeita
+// sua fração do orçamento de memória e descarta a menos usada quando ele estoura.
+// Entradas sem dados marcam tickets já usados em 0-RTT (proteção contra repetição)
+typedef struct TLS_Session
+{
+    struct TLS_Session *chain; // Próxima na mesma posição da tabela
+    struct TLS_Session *newer; // Ordem de uso (LRU)
+    struct TLS_Session *older;
+    uint64_t hash;
+    time_t expires;
+    size_t size; // Bytes contados no orçamento
+    unsigned int id_length;
+    unsigned char id[SSL_MAX_SSL_SESSION_ID_LENGTH];
+    size_t length;
+    unsigned char data[];
+} TLS_Session;
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    TLS_Session *table[TLS_CACHE_BUCKETS];
+    TLS_Session *newest;
+    TLS_Session *oldest;
+    size_t bytes;
+    size_t count;
+    time_t replay_floor; // Marcas de 0-RTT descartadas valiam até aqui
+} TLS_Cache_Shard;
+
+static TLS_Cache_Shard tls_cache[HTTP_TLS_CACHE_SHARDS];
+static size_t tls_shard_budget;
+static bool tls_cache_ready;
+static bool tls_early_data;
+
+static atomic_uint_fast64_t tls_hits;
+static atomic_uint_fast64_t tls_misses;
+static atomic_uint_fast64_t tls_evicted;
+
+// --- Chaves de ticket derivadas do segredo e do período atual ---
+// Servidores com o mesmo segredo (--ticket-secret) trocam de chave juntos, sem coordenação
+static unsigned char tls_ticket_secret[TLS_TICKET_SECRET_MAX];
+static size_t tls_ticket_secret_length;
+static int tls_ticket_rotate;
+
+typedef struct
+{
+    unsigned char name[16];
+    unsigned char cipher[32]; // AES-256-CBC
+    unsigned char mac[32];    // HMAC-SHA256
+} TLS_Ticket_Key;
+
+static uint64_t tls_hash(const unsigned char *id, size_t length)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= id[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static TLS_Cache_Shard *tls_shard(uint64_t hash)
+{
+    return &tls_cache[hash % HTTP_TLS_CACHE_SHARDS];
+}
+
+static TLS_Session **tls_slot(TLS_Cache_Shard *shard, uint64_t hash)
+{
+    return &shard->table[(hash / HTTP_TLS_CACHE_SHARDS) % TLS_CACHE_BUCKETS];
+}
+
+static void tls_unlink(TLS_Cache_Shard *shard, TLS_Session *session)
+{
+    TLS_Session **slot = tls_slot(shard, session->hash);
+    while (*slot != session)
+        slot = &(*slot)->chain;
+    *slot = session->chain;
+
+    if (session->newer)
+        session->newer->older = session->older;
+    else
+        shard->newest = session->older;
+    if (session->older)
+        session->older->newer = session->newer;
+    else
+        shard->oldest = session->newer;
+
+    shard->bytes -= session->size;
+    shard->count--;
+    free(session);
+}
+
+static void tls_touch(TLS_Cache_Shard *shard, TLS_Session *session)
+{
+    if (shard->newest == session)
+        return;
+
+    // Sai da posição atual...
+    session->newer->older = session->older;
+    if (session->older)
+        session->older->newer = session->newer;
+    else
+        shard->oldest = session->newer;
+
+    // ...e vira a mais recente
+    session->older = shard->newest;
+    session->newer = NULL;
+    shard->newest->newer = session;
+    shard->newest = session;
+}
+
+static TLS_Session *tls_find(TLS_Cache_Shard *shard, uint64_t hash, const unsigned char *id, unsigned int length)
+{
+    for (TLS_Session *session = *tls_slot(shard, hash); session; session = session->chain)
+    {
+        if (session->hash == hash && session->id_length == length && memcmp(session->id, id, length) == 0)
+            return session;
+    }
+    return NULL;
+}
+
+// --- Insere na partição (travada), descartando as menos usadas até caber no orçamento ---
+static void tls_insert(TLS_Cache_Shard *shard, TLS_Session *session)
+{
+    uint_fast64_t evicted = 0;
+    while (shard->bytes + session->size > tls_shard_budget)
+    {
+        TLS_Session *oldest = shard->oldest;
+        if (oldest->length == 0 && oldest->expires > shard->replay_floor)
+            shard->replay_floor = oldest->expires;
+        tls_unlink(shard, oldest);
+        evicted++;
+    }
+
+    TLS_Session **slot = tls_slot(shard, session->hash);
+    session->chain = *slot;
+    *slot = session;
+    session->newer = NULL;
+    session->older = shard->newest;
+    if (shard->newest)
+        shard->newest->newer = session;
+    else
+        shard->oldest = session;
+    shard->newest = session;
+    shard->bytes += session->size;
+    shard->count++;
+
+    if (evicted)
+        atomic_fetch_add_explicit(&tls_evicted, evicted, memory_order_relaxed);
+}
+
+// --- Sessão nova (handshake completo): serializada no cache; o OpenSSL mantém a sua ---
+// TLS 1.3 retoma apenas por tickets sem estado, que dispensam o cache
+static int tls_cache_new(SSL *ssl, SSL_SESSION *sess)
+{
+    (void)ssl;
+    unsigned int id_length;
+    const unsigned char *id = SSL_SESSION_get_id(sess, &id_length);
+    int length = i2d_SSL_SESSION(sess, NULL);
+    if (SSL_SESSION_get_protocol_version(sess) >= TLS1_3_VERSION || id_length == 0 || length <= 0)
+        return 0;
+
+    size_t size = sizeof(TLS_Session) + (size_t)length;
+    if (size > tls_shard_budget)
+        return 0;
+
+    TLS_Session *session = malloc(size);
+    if (!session)
+    {
+        HTTP_PRINT_ERROR(stderr, "malloc");
+        return 0;
+    }
+    unsigned char *out = session->data;
+    i2d_SSL_SESSION(sess, &out);
+    session->hash = tls_hash(id, id_length);
+    session->expires = (time_t)SSL_SESSION_get_time(sess) + (time_t)SSL_SESSION_get_timeout(sess);
+    session->size = size;
+    session->id_length = id_length;
+    memcpy(session->id, id, id_length);
+    session->length = (size_t)length;
+
+    TLS_Cache_Shard *shard = tls_shard(session->hash);
+    pthread_mutex_lock(&shard->lock);
+    TLS_Session *old = tls_find(shard, session->hash, id, id_length);
+    if (old)
+        tls_unlink(shard, old);
+    tls_insert(shard, session);
+    pthread_mutex_unlock(&shard->lock);
+    return 0;
+}
+
+// --- Retomada pelo id de sessão oferecido pelo cliente (TLS 1.2 sem tickets) ---
+static SSL_SESSION *tls_cache_get(SSL *ssl, const unsigned char *id, int id_length, int *copy)
+{
+    (void)ssl;
+    *copy = 0; // A sessão devolvida já pertence ao OpenSSL
+    if (id_length <= 0 || id_length > SSL_MAX_SSL_SESSION_ID_LENGTH)
+        return NULL;
+
+    uint64_t hash = tls_hash(id, (size_t)id_length);
+    TLS_Cache_Shard *shard = tls_shard(hash);
+    SSL_SESSION *sess = NULL;
+
+    pthread_mutex_lock(&shard->lock);
+    TLS_Session *session = tls_find(shard, hash, id, (unsigned int)id_length);
+    if (session && session->expires <= time(NULL))
+    {
+        tls_unlink(shard, session);
+        session = NULL;
+    }
+    if (session && session->length)
+    {
+        const unsigned char *data = session->data;
+        sess = d2i_SSL_SESSION(NULL, &data, (long)session->length);
+        tls_touch(shard, session);
+    }
+    pthread_mutex_unlock(&shard->lock);
+
+    atomic_fetch_add_explicit(sess ? &tls_hits : &tls_misses, 1, memory_order_relaxed);
+    return sess;
+}
+
+// --- 0-RTT aceito uma única vez por ticket ---
+// A chave de cada ticket é única; sua impressão digital fica no cache até o ticket expirar.
+// Tickets emitidos antes de uma marca descartada por falta de espaço perdem o 0-RTT
+static int tls_early_allow(SSL *ssl, void *arg)
+{
+    (void)arg;
+    SSL_SESSION *sess = SSL_get_session(ssl);
+    unsigned char key[EVP_MAX_MD_SIZE];
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    size_t key_length = sess ? SSL_SESSION_get_master_key(sess, key, sizeof(key)) : 0;
+    if (!key_length || !SHA256(key, key_length, digest))
+        return 0;
+    OPENSSL_cleanse(key, sizeof(key));
+
+    TLS_Session *mark = malloc(sizeof(TLS_Session));
+    if (!mark)
+    {
+        HTTP_PRINT_ERROR(stderr, "malloc");
+        return 0;
+    }
+    mark->hash = tls_hash(digest, sizeof(digest));
+    mark->expires = (time_t)SSL_SESSION_get_time(sess) + (time_t)SSL_SESSION_get_timeout(sess);
+    mark->size = sizeof(TLS_Session);
+    mark->id_length = sizeof(digest);
+    memcpy(mark->id, digest, sizeof(digest));
+    mark->length = 0;
+
+    TLS_Cache_Shard *shard = tls_shard(mark->hash);
+    pthread_mutex_lock(&shard->lock);
+    bool fresh = mark->expires > shard->replay_floor && !tls_find(shard, mark->hash, digest, sizeof(digest));
+    if (fresh)
+        tls_insert(shard, mark);
+    pthread_mutex_unlock(&shard->lock);
+
+    if (!fresh)
+        free(mark);
+    return fresh;
+}
+
+static void tls_cache_remove(SSL_CTX *ctx, SSL_SESSION *sess)
+{
+    (void)ctx;
+    unsigned int id_length;
+    const unsigned char *id = SSL_SESSION_get_id(sess, &id_length);
+    uint64_t hash = tls_hash(id, id_length);
+    TLS_Cache_Shard *shard = tls_shard(hash);
+
+    pthread_mutex_lock(&shard->lock);
+    TLS_Session *session = tls_find(shard, hash, id, id_length);
+    if (session && session->length)
+        tls_unlink(shard, session);
+    pthread_mutex_unlock(&shard->lock);
+}
+
+// --- Chave do período epoch: HMAC-SHA512(segredo, rótulo || período) ---
+static bool tls_ticket_derive(uint64_t epoch, TLS_Ticket_Key *key)
+{
+    unsigned char input[sizeof("NeroHTTP ticket") + 8];
+    unsigned char output[EVP_MAX_MD_SIZE];
+    unsigned int length;
+
+    memcpy(input, "NeroHTTP ticket", sizeof("NeroHTTP ticket"));
+    for (int i = 0; i < 8; i++)
+        input[sizeof("NeroHTTP ticket") + i] = (unsigned char)(epoch >> (56 - 8 * i));
+
+    // Último byte do rótulo (o terminador) separa nome e material da chave
+    if (!HMAC(EVP_sha512(), tls_ticket_secret, (int)tls_ticket_secret_length, input, sizeof(input), output, &length))
+        return false;
+    memcpy(key->cipher, output, sizeof(key->cipher));
+    memcpy(key->mac, output + sizeof(key->cipher), sizeof(key->mac));
+
+    input[sizeof("NeroHTTP ticket") - 1] = 1;
+    if (!HMAC(EVP_sha512(), tls_ticket_secret, (int)tls_ticket_secret_length, input, sizeof(input), output, &length))
+        return false;
+    memcpy(key->name, output, sizeof(key->name));
+    return true;
+}
+
+// --- Escolhe a chave do ticket: cifra com a atual, aceita as HTTP_TLS_TICKET_KEYS mais recentes ---
+// Retorna 1 (ok), 2 (ok, reemitir com a chave atual), 0 (ticket desconhecido) ou -1 (erro)
+static int tls_ticket_select(unsigned char name[16], int encrypt, TLS_Ticket_Key *key)
+{
+    uint64_t epoch = (uint64_t)time(NULL) / (uint64_t)tls_ticket_rotate;
+    if (encrypt)
+    {
+        if (!tls_ticket_derive(epoch, key))
+            return -1;
+        memcpy(name, key->name, sizeof(key->name));
+        return 1;
+    }
+
+    for (uint64_t age = 0; age < HTTP_TLS_TICKET_KEYS && age <= epoch; age++)
+    {
+        if (!tls_ticket_derive(epoch - age, key))
+            return -1;
+        if (CRYPTO_memcmp(name, key->name, sizeof(key->name)) == 0)
+            return age == 0 ? 1 : 2;
+    }
+    return 0;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+static int tls_ticket_key(SSL *ssl, unsigned char name[16], unsigned char *iv, EVP_CIPHER_CTX *cipher,
+                          EVP_MAC_CTX *mac, int encrypt)
+{
+    (void)ssl;
+    TLS_Ticket_Key key;
+    int ret = tls_ticket_select(name, encrypt, &key);
+    if (ret <= 0)
+        return ret;
+
+    if (encrypt && RAND_bytes(iv, EVP_MAX_IV_LENGTH) <= 0)
+        return -1;
+
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key.mac, sizeof(key.mac)),
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, "SHA256", 0),
+        OSSL_PARAM_construct_end()};
+    if (!EVP_MAC_CTX_set_params(mac, params) ||
+        !EVP_CipherInit_ex(cipher, EVP_aes_256_cbc(), NULL, key.cipher, iv, encrypt))
+        ret = -1;
+
+    OPENSSL_cleanse(&key, sizeof(key));
+    return ret;
+}
+#else
+static int tls_ticket_key(SSL *ssl, unsigned char name[16], unsigned char *iv, EVP_CIPHER_CTX *cipher,
+                          HMAC_CTX *mac, int encrypt)
+{
+    (void)ssl;
+    TLS_Ticket_Key key;
+    int ret = tls_ticket_select(name, encrypt, &key);
+    if (ret <= 0)
+        return ret;
+
+    if (encrypt && RAND_bytes(iv, EVP_MAX_IV_LENGTH) <= 0)
+        return -1;
+
+    if (!HMAC_Init_ex(mac, key.mac, sizeof(key.mac), EVP_sha256(), NULL) ||
+        !EVP_CipherInit_ex(cipher, EVP_aes_256_cbc(), NULL, key.cipher, iv, encrypt))
+        ret = -1;
+
+    OPENSSL_cleanse(&key, sizeof(key));
+    return ret;
+}
+#endif
+
+// --- Segredo dos tickets: do arquivo compartilhado pela frota ou aleatório por processo ---
+static bool tls_ticket_load(const char *path)
+{
+    if (!path)
+    {
+        tls_ticket_secret_length = 32;
+        return RAND_bytes(tls_ticket_secret, (int)tls_ticket_secret_length) > 0;
+    }
+
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        HTTP_PRINT_ERROR(stderr, "cannot open ticket secret %s", path);
+        return false;
+    }
+    tls_ticket_secret_length = fread(tls_ticket_secret, 1, sizeof(tls_ticket_secret), file);
+    fclose(file);
+
+    if (tls_ticket_secret_length < 32)
+    {
+        HTTP_PRINT_ERROR(stderr, "ticket secret %s shorter than 32 bytes", path);
+        return false;
+    }
+    return true;
+}
+
+// --- Configura a retomada de sessões do contexto (cache, tickets e 0-RTT) ---
+bool HTTP_TLS_Setup(SSL_CTX *ctx, const HTTP_TLS_Options *options)
+{
+    static const unsigned char context[] = "NeroHTTP";
+    if (!SSL_CTX_set_session_id_context(ctx, context, sizeof(context) - 1))
+    {
+        HTTP_PRINT_SSL_ERROR(stderr, "SSL_CTX_set_session_id_context");
+        return false;
+    }
+
+    // Tickets aceitos por HTTP_TLS_TICKET_KEYS períodos: a sessão vale o mesmo tanto
+    tls_ticket_rotate = options->ticket_rotate > 0 ? options->ticket_rotate : HTTP_TLS_TICKET_ROTATE_S;
+    SSL_CTX_set_timeout(ctx, (long)tls_ticket_rotate * (HTTP_TLS_TICKET_KEYS - 1));
+
+    if (!tls_ticket_load(options->ticket_secret))
+        return false;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, tls_ticket_key);
+#else
+    SSL_CTX_set_tlsext_ticket_key_cb(ctx, tls_ticket_key);
+#endif
+
+    if (options->cache_bytes > 0)
+    {
+        tls_shard_budget = options->cache_bytes / HTTP_TLS_CACHE_SHARDS;
+        for (size_t i = 0; i < HTTP_TLS_CACHE_SHARDS; i++)
+            pthread_mutex_init(&tls_cache[i].lock, NULL);
+        tls_cache_ready = true;
+
+        // Sem o cache interno: toda consulta passa pelas partições compartilhadas
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+        SSL_CTX_sess_set_new_cb(ctx, tls_cache_new);
+        SSL_CTX_sess_set_get_cb(ctx, tls_cache_get);
+        SSL_CTX_sess_set_remove_cb(ctx, tls_cache_remove);
+    }
+    else
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+
+    // kTLS: o OpenSSL entrega as chaves ao kernel após o handshake se kernel e cifra permitirem;
+    // sem suporte a conexão segue cifrando em espaço de usuário (HTTP_TLS_Offloaded decide)
+    if (options->ktls)
+    {
+#ifdef SSL_OP_ENABLE_KTLS
+        SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+#else
+        printf("kTLS indisponível nesta versão do OpenSSL\n");
+#endif
+    }
+
+    // 0-RTT depende do cache, onde ficam as marcas de uso único; sem a proteção própria do
+    // OpenSSL os tickets TLS 1.3 continuam sem estado
+    tls_early_data = options->early_data && tls_cache_ready;
+    if (options->early_data && !tls_cache_ready)
+        printf("0-RTT ignorado sem cache de sessões\n");
+    if (tls_early_data)
+    {
+        if (!SSL_CTX_set_max_early_data(ctx, HTTP_TLS_EARLY_DATA_MAX) ||
+            !SSL_CTX_set_recv_max_early_data(ctx, HTTP_TLS_EARLY_DATA_MAX))
+        {
+            HTTP_PRINT_SSL_ERROR(stderr, "SSL_CTX_set_max_early_data");
+            return false;
+        }
+        SSL_CTX_set_options(ctx, SSL_OP_NO_ANTI_REPLAY);
+        SSL_CTX_set_allow_early_data_cb(ctx, tls_early_allow, NULL);
+    }
+    return true;
+}
+
+// --- Mesmo contrato de SSL_accept; com 0-RTT, os dados antecipados vão para conn->buffer ---
+// Em retorno <= 0, SSL_get_error(conn->ssl, ret) informa o motivo. Com pause, retorna 2
+// assim que chegam dados antecipados, para que sejam atendidos antes do fim do handshake
+int HTTP_TLS_Accept(HTTP_Connection *conn, bool pause)
+{
+    while (tls_early_data && !conn->early_done)
+    {
+        if (!HTTP_Header_Reserve(conn, HTTP_READ_CHUNK))
+            return -1;
+
+        size_t bytes_read = 0;
+        int ret = SSL_read_early_data(conn->ssl, conn->buffer + conn->buffer_used,
+                                      conn->buffer_size - conn->buffer_used - 1, &bytes_read);
+        conn->buffer_used += bytes_read;
+        if (ret == SSL_READ_EARLY_DATA_ERROR)
+            return 0;
+        if (ret == SSL_READ_EARLY_DATA_FINISH)
+            conn->early_done = true;
+        else if (pause && bytes_read > 0)
+            return 2;
+    }
+    return SSL_accept(conn->ssl);
+}
+
+// --- Requisição atual pode ser respondida antes do fim do handshake (0-RTT) ---
+// Apenas GET/HEAD sem corpo: repetidas por um atacante, não alteram o estado do servidor
+bool HTTP_TLS_Early_Safe(HTTP_Connection *conn, HTTP_Header *header)
+{
+    if (!tls_early_data || conn->early_done || !header->prologue || conn->request_body > 0 ||
+        HTTP_Header_Get(header, HTTP_HEADER_TRANSFER_ENCODING))
+        return false;
+
+    const char *space = strchr(header->prologue, ' ');
+    if (!space)
+        return false;
+
+    char method[8];
+    size_t length = (size_t)(space - header->prologue);
+    if (length >= sizeof(method))
+        return false;
+    memcpy(method, header->prologue, length);
+    method[length] = '\0';
+    return (HTTP_Method_Get(method) & (HTTP_METHOD_GET | HTTP_METHOD_HEAD)) != 0;
+}
+
+// --- A cifragem de saída desta conexão foi entregue ao kernel (kTLS) ---
+bool HTTP_TLS_Offloaded(HTTP_Connection *conn)
+{
+#ifdef SSL_OP_ENABLE_KTLS
+    return conn->ssl && !conn->early_write && BIO_get_ktls_send(SSL_get_wbio(conn->ssl));
+#else
+    (void)conn;
+    return false;
+#endif
+}
+
+// --- Imprime a ocupação e a eficácia do cache ---
+void HTTP_TLS_Stats_Print(FILE *fd)
+{
+    if (!tls_cache_ready)
+        return;
+
+    size_t count = 0, bytes = 0;
+    for (size_t i = 0; i < HTTP_TLS_CACHE_SHARDS; i++)
+    {
+        pthread_mutex_lock(&tls_cache[i].lock);
+        count += tls_cache[i].count;
+        bytes += tls_cache[i].bytes;
+        pthread_mutex_unlock(&tls_cache[i].lock);
+    }
+
+    fprintf(fd, "Cache de sessões TLS: %zu sessões, %zu de %zu bytes, %llu acertos, %llu faltas, %llu descartadas\n",
+            count, bytes, tls_shard_budget * HTTP_TLS_CACHE_SHARDS,
+            (unsigned long long)atomic_load(&tls_hits),
+            (unsigned long long)atomic_load(&tls_misses),
+            (unsigned long long)atomic_load(&tls_evicted));
+}
+
+// --- Libera as sessões guardadas (após SSL_CTX_free) ---
+// As travas continuam válidas: threads ainda bloqueadas podem consultar o cache vazio
+void HTTP_TLS_Cleanup(void)
+{
+    OPENSSL_cleanse(tls_ticket_secret, sizeof(tls_ticket_secret));
+    if (!tls_cache_ready)
+        return;
+
+    for (size_t i = 0; i < HTTP_TLS_CACHE_SHARDS; i++)
+    {
+        pthread_mutex_lock(&tls_cache[i].lock);
+        while (tls_cache[i].oldest)
+            tls_unlink(&tls_cache[i], tls_cache[i].oldest);
+        pthread_mutex_unlock(&tls_cache[i].lock);
+    }
+}
@@ -0,0 +1,1049 @@
+#ifdef __linux__
+#define _GNU_SOURCE // pthread_setaffinity_np
+#endif
+#include <nero_http.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__) && defined(NERO_HTTP_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <sched.h>
+
+#define URING_EVENT_ENTRIES 256 // SQEs do anel (accept, recv e send)
+#define URING_BUFFERS 256       // Buffers fornecidos ao kernel para recv (potência de 2)
+#define URING_BUFFER_SIZE 4096
+#define URING_BUFFER_GROUP 0
+#define URING_WAIT_MS 100
+#define URING_SEND_MAX (1u << 20)  // Maior trecho da fila por SQE de send
+#define URING_SEND_CHAIN 4         // SQEs de send encadeadas de uma vez (cabeçalho e corpo)
+#define URING_BODY_MAX (1u << 20)  // Maior corpo reunido no buffer antes dos módulos (413 acima)
+
+// --- Identificadores de user_data que não são conexões (ponteiros alinhados) ---
+#define URING_ACCEPT 1
+#define URING_IGNORE 2
+#define URING_SEND 1 // Bit somado ao ponteiro da conexão na conclusão de um send
+
+// --- Anel mapeado: filas de submissão e de conclusão compartilhadas com o kernel ---
+typedef struct
+{
+    int fd;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned sqe_tail; // Próxima SQE livre (publicada no tail ao submeter)
+    struct io_uring_sqe *sqes;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe *cqes;
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    size_t sqes_size;
+} HTTP_Ring;
+
+struct HTTP_Uring
+{
+    HTTP_Ring events; // Accept, recv multishot e os sends das filas de saída
+    struct io_uring_buf_ring *buffers;
+    size_t buffers_size;
+    char *buffer_memory;
+    uint16_t buffer_tail;
+    struct io_uring_cqe *stash; // Conclusões retiradas enquanto um módulo esperava pela fila
+    size_t stash_head;
+    size_t stash_count;
+    size_t stash_size;
+};
+
+static int ring_setup(unsigned entries, struct io_uring_params *params)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int ring_enter(HTTP_Ring *ring, unsigned wait, uint64_t timeout_ns)
+{
+    // Publica as SQEs preparadas; o kernel consome a partir do head
+    atomic_store_explicit((_Atomic unsigned *)ring->sq_tail, ring->sqe_tail, memory_order_release);
+    unsigned submit = ring->sqe_tail - atomic_load_explicit((_Atomic unsigned *)ring->sq_head, memory_order_acquire);
+
+    unsigned flags = wait ? IORING_ENTER_GETEVENTS : 0;
+    struct __kernel_timespec ts = {
+        .tv_sec = (long long)(timeout_ns / 1000000000ull),
+        .tv_nsec = (long long)(timeout_ns % 1000000000ull),
+    };
+    struct io_uring_getevents_arg arg = {.ts = (uint64_t)(uintptr_t)&ts};
+
+    if (wait && timeout_ns)
+    {
+        flags |= IORING_ENTER_EXT_ARG;
+        return (int)syscall(__NR_io_uring_enter, ring->fd, submit, wait, flags, &arg, sizeof(arg));
+    }
+    return (int)syscall(__NR_io_uring_enter, ring->fd, submit, wait, flags, NULL, 0);
+}
+
+static void ring_close(HTTP_Ring *ring)
+{
+    if (ring->sqes)
+        munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring && ring->cq_ring != ring->sq_ring)
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    if (ring->sq_ring)
+        munmap(ring->sq_ring, ring->sq_ring_size);
+    if (ring->fd >= 0)
+        close(ring->fd);
+    memset(ring, 0, sizeof(HTTP_Ring));
+    ring->fd = -1;
+}
+
+// --- Cria o anel e mapeia SQ, CQ e o vetor de SQEs ---
+static bool ring_init(HTTP_Ring *ring, unsigned entries)
+{
+    memset(ring, 0, sizeof(HTTP_Ring));
+
+    struct io_uring_params params = {0};
+    ring->fd = ring_setup(entries, &params);
+    if (ring->fd < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "io_uring_setup: %s", strerror(errno));
+        ring->fd = -1;
+        return false;
+    }
+
+    // Esperas com prazo (EXT_ARG) são necessárias para a roda de timers
+    if (!(params.features & IORING_FEAT_EXT_ARG))
+    {
+        HTTP_PRINT_ERROR(stderr, "io_uring without IORING_FEAT_EXT_ARG");
+        ring_close(ring);
+        return false;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single)
+    {
+        if (ring->cq_ring_size > ring->sq_ring_size)
+            ring->sq_ring_size = ring->cq_ring_size;
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED)
+    {
+        ring->sq_ring = NULL;
+        HTTP_PRINT_ERROR(stderr, "mmap sq ring: %s", strerror(errno));
+        ring_close(ring);
+        return false;
+    }
+
+    ring->cq_ring = single ? ring->sq_ring
+                           : mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  ring->fd, IORING_OFF_CQ_RING);
+    if (ring->cq_ring == MAP_FAILED)
+    {
+        ring->cq_ring = NULL;
+        HTTP_PRINT_ERROR(stderr, "mmap cq ring: %s", strerror(errno));
+        ring_close(ring);
+        return false;
+    }
+
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED)
+    {
+        ring->sqes = NULL;
+        HTTP_PRINT_ERROR(stderr, "mmap sqes: %s", strerror(errno));
+        ring_close(ring);
+        return false;
+    }
+
+    char *sq = ring->sq_ring;
+    char *cq = ring->cq_ring;
+    ring->sq_head = (unsigned *)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    ring->sq_mask = *(unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+    ring->sqe_tail = *ring->sq_tail;
+    ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    ring->cq_mask = *(unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    // Cada posição da SQ aponta para a SQE de mesmo índice
+    unsigned *array = (unsigned *)(sq + params.sq_off.array);
+    for (unsigned i = 0; i < params.sq_entries; i++)
+        array[i] = i;
+
+    return true;
+}
+
+// --- Obtém uma SQE zerada; se a fila estiver cheia, submete o que já foi preparado ---
+static struct io_uring_sqe *ring_sqe(HTTP_Ring *ring)
+{
+    unsigned head = atomic_load_explicit((_Atomic unsigned *)ring->sq_head, memory_order_acquire);
+    if (ring->sqe_tail - head >= ring->sq_entries)
+    {
+        ring_enter(ring, 0, 0);
+        head = atomic_load_explicit((_Atomic unsigned *)ring->sq_head, memory_order_acquire);
+        if (ring->sqe_tail - head >= ring->sq_entries)
+            return NULL;
+    }
+
+    struct io_uring_sqe *sqe = &ring->sqes[ring->sqe_tail & ring->sq_mask];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    ring->sqe_tail++;
+    return sqe;
+}
+
+// --- SQEs livres sem precisar submeter as já preparadas ---
+static unsigned ring_space(HTTP_Ring *ring)
+{
+    unsigned head = atomic_load_explicit((_Atomic unsigned *)ring->sq_head, memory_order_acquire);
+    return ring->sq_entries - (ring->sqe_tail - head);
+}
+
+// --- Retira a próxima conclusão, se houver ---
+static bool ring_cqe(HTTP_Ring *ring, struct io_uring_cqe *out)
+{
+    unsigned head = *ring->cq_head;
+    if (head == atomic_load_explicit((_Atomic unsigned *)ring->cq_tail, memory_order_acquire))
+        return false;
+
+    *out = ring->cqes[head & ring->cq_mask];
+    atomic_store_explicit((_Atomic unsigned *)ring->cq_head, head + 1, memory_order_release);
+    return true;
+}
+
+// --- Devolve um buffer ao anel de buffers fornecidos ---
+static void uring_recycle(HTTP_Uring *uring, uint16_t bid)
+{
+    struct io_uring_buf *buf = &uring->buffers->bufs[uring->buffer_tail & (URING_BUFFERS - 1)];
+    buf->addr = (uint64_t)(uintptr_t)(uring->buffer_memory + (size_t)bid * URING_BUFFER_SIZE);
+    buf->len = URING_BUFFER_SIZE;
+    buf->bid = bid;
+    uring->buffer_tail++;
+    atomic_store_explicit((_Atomic uint16_t *)&uring->buffers->tail, uring->buffer_tail, memory_order_release);
+}
+
+// --- Registra o anel de buffers de onde o kernel escolhe o destino de cada recv ---
+static bool uring_buffers(HTTP_Uring *uring)
+{
+    uring->buffers_size = URING_BUFFERS * sizeof(struct io_uring_buf);
+    uring->buffers = mmap(NULL, uring->buffers_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (uring->buffers == MAP_FAILED)
+    {
+        uring->buffers = NULL;
+        HTTP_PRINT_ERROR(stderr, "mmap buffer ring: %s", strerror(errno));
+        return false;
+    }
+
+    uring->buffer_memory = malloc((size_t)URING_BUFFERS * URING_BUFFER_SIZE);
+    if (!uring->buffer_memory)
+    {
+        HTTP_PRINT_ERROR(stderr, "malloc");
+        return false;
+    }
+
+    struct io_uring_buf_reg reg = {
+        .ring_addr = (uint64_t)(uintptr_t)uring->buffers,
+        .ring_entries = URING_BUFFERS,
+        .bgid = URING_BUFFER_GROUP,
+    };
+    if (syscall(__NR_io_uring_register, uring->events.fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "IORING_REGISTER_PBUF_RING: %s", strerror(errno));
+        return false;
+    }
+
+    for (uint16_t bid = 0; bid < URING_BUFFERS; bid++)
+        uring_recycle(uring, bid);
+    return true;
+}
+
+static void uring_free(HTTP_Uring *uring)
+{
+    // Fechar o anel cancela accept e recv pendentes antes de liberar os buffers
+    ring_close(&uring->events);
+    if (uring->buffers)
+        munmap(uring->buffers, uring->buffers_size);
+    free(uring->buffer_memory);
+    free(uring->stash);
+    free(uring);
+}
+
+// --- Arma accept multishot no socket de escuta ---
+static void uring_accept(HTTP_Connection_Manager *context)
+{
+    struct io_uring_sqe *sqe = ring_sqe(&context->uring->events);
+    if (!sqe)
+        return;
+
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = context->server;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->user_data = URING_ACCEPT;
+}
+
+// --- Arma recv multishot com seleção de buffer do anel fornecido ---
+static bool uring_receive(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    struct io_uring_sqe *sqe = ring_sqe(&context->uring->events);
+    if (!sqe)
+        return false;
+
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn->client;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = (uint64_t)(uintptr_t)conn;
+    conn->receiving = true;
+    return true;
+}
+
+// --- Encerra a conexão; com recv ou send armados, a remoção espera as conclusões finais ---
+static void uring_close(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    conn->state = HTTP_STATE_CLOSED;
+    HTTP_Timer_Cancel(&conn->timer);
+
+    if (!conn->receiving && !conn->sending)
+    {
+        HTTP_Manager_Remove_Connection(context, conn, -1, conn);
+        return;
+    }
+
+    struct io_uring_sqe *sqe = ring_sqe(&context->uring->events);
+    if (sqe)
+    {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = conn->client;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+        sqe->user_data = URING_IGNORE;
+    }
+    else
+    {
+        shutdown(conn->client, SHUT_RDWR); // Encerra o recv pelo fim da conexão
+    }
+}
+
+// --- Arma o prazo da etapa na roda de timers do laço ---
+static void uring_deadline(HTTP_Connection_Manager *context, HTTP_Connection *conn, HTTP_Timeout timeout)
+{
+    HTTP_Connection_Deadline(conn, timeout);
+    if (conn->deadline)
+        HTTP_Timer_Arm(&context->timers, &conn->timer, conn->deadline);
+    else
+        HTTP_Timer_Cancel(&conn->timer);
+}
+
+// --- TLS: cifra o texto claro do início da fila (trecho de arquivo ou escrita feita depois dele) ---
+// Os registros saem na ordem em que são cifrados, então só o início da fila é cifrado, um trecho por vez
+static bool uring_seal(HTTP_Connection *conn)
+{
+    if (!HTTP_Output_Load(conn))
+        return false;
+
+    HTTP_Output_Block *block = conn->queue;
+    if (!block || !block->clear)
+        return true;
+
+    size_t length = (size_t)block->length;
+    if (SSL_write(conn->ssl, block->data + block->offset, (int)length) <= 0)
+    {
+        HTTP_PRINT_SSL_ERROR(stderr, "SSL write error");
+        return false;
+    }
+    HTTP_Output_Advance(conn, length);
+
+    char *pending;
+    long pending_length = BIO_get_mem_data(SSL_get_wbio(conn->ssl), &pending);
+    bool queued = pending_length <= 0 || HTTP_Output_Front(conn, pending, (size_t)pending_length);
+    BIO_reset(SSL_get_wbio(conn->ssl));
+    return queued;
+}
+
+// --- Arma os sends do início da fila; as conclusões chegam pelo laço como qualquer evento ---
+// Blocos prontos seguem em SQEs encadeadas (cabeçalho e corpo); MSG_WAITALL faz o kernel
+// completar cada uma antes da seguinte, e um bloco maior que URING_SEND_MAX encerra a cadeia
+static bool uring_send(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    if (conn->sending)
+        return true;
+
+    // Intervalos de arquivo (e, com TLS, o texto claro) viram bytes prontos no início da fila
+    if (!(conn->ssl ? uring_seal(conn) : HTTP_Output_Load(conn)))
+        return false;
+    HTTP_Output_Block *block = conn->queue;
+    if (!block)
+        return true;
+
+    HTTP_Ring *ring = &context->uring->events;
+    unsigned chain = ring_space(ring);
+    if (chain == 0)
+    {
+        ring_enter(ring, 0, 0);
+        chain = ring_space(ring);
+    }
+    if (chain == 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "io_uring submission queue full");
+        return false;
+    }
+    if (chain > URING_SEND_CHAIN)
+        chain = URING_SEND_CHAIN;
+
+    struct io_uring_sqe *previous = NULL;
+    for (; block && conn->sending < chain && block->fd < 0 && !(conn->ssl && block->clear); block = block->next)
+    {
+        struct io_uring_sqe *sqe = ring_sqe(ring);
+        if (previous)
+            previous->flags |= IOSQE_IO_LINK;
+
+        bool whole = block->length <= URING_SEND_MAX;
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = conn->client;
+        sqe->addr = (uint64_t)(uintptr_t)(block->data + block->offset);
+        sqe->len = whole ? (uint32_t)block->length : URING_SEND_MAX;
+        sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+        sqe->user_data = (uint64_t)(uintptr_t)conn | URING_SEND;
+        conn->sending++;
+        previous = sqe;
+        if (!whole)
+            break;
+    }
+    return true;
+}
+
+// --- Passa a saída acumulada (ou os registros TLS do BIO) para a fila e arma o envio ---
+static bool uring_output(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    if (conn->ssl)
+    {
+        char *pending;
+        long pending_length = BIO_get_mem_data(SSL_get_wbio(conn->ssl), &pending);
+        if (pending_length > 0 && !HTTP_Output_Queue(conn, pending, (size_t)pending_length))
+            return false;
+        BIO_reset(SSL_get_wbio(conn->ssl));
+    }
+    else if (conn->output_used > 0)
+    {
+        if (!HTTP_Output_Queue(conn, conn->output, conn->output_used))
+            return false;
+        conn->output_used = 0;
+    }
+    return uring_send(context, conn);
+}
+
+// --- Guarda uma conclusão retirada fora de uring_reap, para ele tratar na ordem de chegada ---
+static bool uring_stash(HTTP_Uring *uring, const struct io_uring_cqe *cqe)
+{
+    if (uring->stash_count == uring->stash_size)
+    {
+        size_t size = uring->stash_size ? uring->stash_size * 2 : URING_EVENT_ENTRIES;
+        struct io_uring_cqe *stash = realloc(uring->stash, size * sizeof(struct io_uring_cqe));
+        if (!stash)
+        {
+            HTTP_PRINT_ERROR(stderr, "realloc");
+            return false;
+        }
+        uring->stash = stash;
+        uring->stash_size = size;
+    }
+    uring->stash[uring->stash_count++] = *cqe;
+    return true;
+}
+
+// --- Pausa o módulo enquanto a fila passa de HTTP_OUTPUT_QUEUE_MAX ---
+// Como no reactor sem workers, o laço espera por esta conexão até o prazo de escrita;
+// só os sends dela são tratados aqui, as demais conclusões ficam para uring_reap
+static bool uring_wait(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    HTTP_Uring *uring = context->uring;
+    uint64_t send_data = (uint64_t)(uintptr_t)conn | URING_SEND;
+    HTTP_Connection_Deadline(conn, HTTP_TIMEOUT_WRITE);
+
+    while (conn->queued > HTTP_OUTPUT_QUEUE_MAX)
+    {
+        if (!uring_send(context, conn))
+            return false;
+
+        uint64_t now = HTTP_Now();
+        if (conn->deadline && now >= conn->deadline)
+        {
+            HTTP_Stats_Timeout(conn->timeout);
+            return false;
+        }
+        uint64_t wait_ns = conn->deadline ? conn->deadline - now : (uint64_t)URING_WAIT_MS * 1000000ull;
+        if (ring_enter(&uring->events, 1, wait_ns) < 0 && errno != EINTR && errno != ETIME && errno != EBUSY)
+        {
+            HTTP_PRINT_ERROR(stderr, "io_uring_enter: %s", strerror(errno));
+            return false;
+        }
+
+        struct io_uring_cqe cqe;
+        while (ring_cqe(&uring->events, &cqe))
+        {
+            if (cqe.user_data != send_data)
+            {
+                if (!uring_stash(uring, &cqe))
+                    return false;
+                continue;
+            }
+
+            // Uma falha cancela o resto da cadeia; essas conclusões chegam depois por uring_reap
+            conn->sending--;
+            if (cqe.res <= 0)
+                return false;
+            HTTP_Output_Advance(conn, (size_t)cqe.res);
+            HTTP_Connection_Deadline(conn, HTTP_TIMEOUT_WRITE); // Houve progresso
+        }
+    }
+    return true;
+}
+
+// --- Escrita de um módulo: a fila sai pelo laço e só acima do limite o módulo espera ---
+int HTTP_Uring_Write(HTTP_Connection *conn, const char *data, size_t length)
+{
+    HTTP_Connection_Manager *context = conn->manager;
+
+    // Texto claro já na fila (intervalo de arquivo): o restante entra atrás dele e é cifrado na sua vez
+    if (conn->ssl && conn->queue_tail && conn->queue_tail->clear)
+    {
+        if (length > 0)
+        {
+            if (!HTTP_Output_Queue(conn, data, length))
+                return -1;
+            conn->queue_tail->clear = true;
+        }
+        if (conn->queued > HTTP_OUTPUT_QUEUE_MAX && !uring_wait(context, conn))
+            return -1;
+        return (int)length;
+    }
+
+    if (conn->ssl)
+    {
+        // O BIO de memória aceita o registro TLS inteiro; a cópia para a fila acontece no flush
+        if (length > 0 && SSL_write(conn->ssl, data, (int)length) <= 0)
+        {
+            HTTP_PRINT_SSL_ERROR(stderr, "SSL write error");
+            return -1;
+        }
+        if (BIO_ctrl_pending(SSL_get_wbio(conn->ssl)) >= HTTP_OUTPUT_FLUSH && !uring_output(context, conn))
+            return -1;
+    }
+    else if (length >= HTTP_OUTPUT_DIRECT)
+    {
+        if (!uring_output(context, conn) || !HTTP_Output_Queue(conn, data, length) || !uring_send(context, conn))
+            return -1;
+    }
+    else
+    {
+        if (!HTTP_Output_Append(conn, data, length))
+            return -1;
+        if (conn->output_used >= HTTP_OUTPUT_FLUSH && !uring_output(context, conn))
+            return -1;
+    }
+
+    if (conn->queued > HTTP_OUTPUT_QUEUE_MAX && !uring_wait(context, conn))
+        return -1;
+    return (int)length;
+}
+
+// --- Envia o que estiver acumulado (saída ou registros TLS) ---
+bool HTTP_Uring_Flush(HTTP_Connection *conn)
+{
+    return uring_output(conn->manager, conn);
+}
+
+// --- O corpo inteiro é reunido no buffer antes dos módulos e HTTP_Read o entrega de lá ---
+int HTTP_Uring_Read(HTTP_Connection *conn, char *buffer, size_t length)
+{
+    (void)conn;
+    (void)buffer;
+    (void)length;
+    return 0;
+}
+
+// --- Decifra o que o TLS já tem disponível para o buffer da conexão ---
+static bool uring_decrypt(HTTP_Connection *conn)
+{
+    for (;;)
+    {
+        if (!HTTP_Header_Reserve(conn, URING_BUFFER_SIZE))
+            return false;
+
+        int bytes_read = SSL_read(conn->ssl, conn->buffer + conn->buffer_used,
+                                  (int)(conn->buffer_size - conn->buffer_used - 1));
+        if (bytes_read > 0)
+        {
+            conn->buffer_used += (size_t)bytes_read;
+            continue;
+        }
+
+        int err = SSL_get_error(conn->ssl, bytes_read);
+        return err == SSL_ERROR_WANT_READ;
+    }
+}
+
+// --- Executa a requisição completa no buffer; false se a conexão deve ser encerrada ---
+static bool uring_serve(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    bool keep = HTTP_Dispatch(conn, &conn->request) && context->run;
+    HTTP_Header_Consume(conn);
+    if (!uring_output(context, conn))
+        return false;
+
+    // A próxima requisição espera no buffer até a resposta sair por inteiro
+    if (conn->queue)
+    {
+        conn->closing = !keep;
+        conn->state = HTTP_STATE_WRITE;
+        uring_deadline(context, conn, HTTP_TIMEOUT_WRITE);
+        return true;
+    }
+    if (!keep)
+        return false;
+
+    conn->state = HTTP_STATE_READ_HEADER;
+    uring_deadline(context, conn, conn->buffer_used > 0 ? HTTP_TIMEOUT_HEADER : HTTP_TIMEOUT_IDLE);
+    return true;
+}
+
+// --- Recusa um corpo maior do que o buffer reúne e encerra após a resposta ---
+static bool uring_refuse(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    HTTP_Response response;
+    HTTP_Response_Begin(&response, 413);
+    HTTP_Response_Header(&response, "Connection", "close");
+    HTTP_Response_Length(&response, 0);
+    if (!HTTP_Response_Send(conn, &response) || !uring_output(context, conn))
+        return false;
+
+    conn->closing = true;
+    conn->state = HTTP_STATE_WRITE;
+    uring_deadline(context, conn, HTTP_TIMEOUT_WRITE);
+    return true;
+}
+
+// --- Avança a conexão com os bytes já recebidos; false se ela foi encerrada ---
+static bool uring_advance(HTTP_Connection_Manager *context, HTTP_Connection *conn)
+{
+    if (conn->state == HTTP_STATE_HANDSHAKE)
+    {
+        int ret = HTTP_TLS_Accept(conn, false);
+        bool queued = uring_output(context, conn); // Registros do handshake gerados pelo servidor
+        if (ret <= 0)
+        {
+            if (queued && SSL_get_error(conn->ssl, ret) == SSL_ERROR_WANT_READ)
+                return true;
+
+            HTTP_PRINT_SSL_ERROR(stderr, "ssl accept");
+            HTTP_Stats_Handshake(conn, false);
+            return false;
+        }
+        HTTP_Stats_Handshake(conn, true);
+        uring_deadline(context, conn, HTTP_TIMEOUT_FIRST_BYTE);
+        conn->state = HTTP_STATE_READ_HEADER;
+    }
+
+    // Durante uma resposta os registros recebidos esperam no BIO: algo cifrado agora (resposta
+    // a um KeyUpdate) sairia à frente do texto claro da fila, fora da ordem dos registros
+    if (conn->ssl && conn->state != HTTP_STATE_WRITE && (!uring_decrypt(conn) || !uring_output(context, conn)))
+        return false;
+
+    while (conn->state == HTTP_STATE_READ_HEADER)
+    {
+        if (conn->request_size == 0)
+        {
+            char *end = HTTP_Header_End(conn);
+            if (!end)
+            {
+                if (conn->buffer_used >= HTTP_HEADER_MAX_SIZE)
+                {
+                    HTTP_PRINT_ERROR(stderr, "header too large");
+                    return false;
+                }
+
+                // O primeiro byte inicia o prazo para o cabeçalho completo
+                if (conn->buffer_used > 0 && conn->timeout != HTTP_TIMEOUT_HEADER)
+                    uring_deadline(context, conn, HTTP_TIMEOUT_HEADER);
+                return true;
+            }
+
+            if (!HTTP_Header_Take(conn, end))
+                return false;
+            if (conn->request_body > URING_BODY_MAX)
+                return uring_refuse(context, conn);
+        }
+
+        // O corpo chega pelo mesmo recv multishot; os módulos o leem do buffer com HTTP_Read
+        if (conn->buffer_used - conn->request_size < conn->request_body)
+            return true;
+
+        HTTP_Timer_Cancel(&conn->timer);
+        conn->state = HTTP_STATE_DISPATCH;
+        if (!uring_serve(context, conn))
+            return false;
+    }
+    return true;
+}
+
+// --- Nova conexão entregue pelo accept multishot ---
+static void uring_accepted(HTTP_Connection_Manager *context, socket_fd clientfd)
+{
+    context->accepted++;
+
+    HTTP_Connection *conn = HTTP_Manager_Acquire_Connection(context);
+    if (!conn)
+    {
+        close_socket(clientfd);
+        return;
+    }
+
+    conn->client = clientfd;
+    conn->accepted_at = HTTP_Now();
+    conn->run = &context->run;
+    conn->modules = context->modules;
+    conn->router = context->router;
+    conn->state = HTTP_STATE_READ_HEADER;
+
+    if (context->ssl_ctx)
+    {
+        // O TLS opera sobre BIOs de memória: os bytes cifrados passam pelos anéis
+        conn->ssl = SSL_new(context->ssl_ctx);
+        BIO *rbio = BIO_new(BIO_s_mem());
+        BIO *wbio = BIO_new(BIO_s_mem());
+        if (!conn->ssl || !rbio || !wbio)
+        {
+            HTTP_PRINT_SSL_ERROR(stderr, "SSL_new");
+            BIO_free(rbio);
+            BIO_free(wbio);
+            HTTP_Connection_Destroy(&conn);
+            return;
+        }
+        SSL_set_bio(conn->ssl, rbio, wbio);
+        SSL_set_accept_state(conn->ssl);
+        conn->state = HTTP_STATE_HANDSHAKE;
+    }
+
+    if (!HTTP_Manager_Push_Connection(context, conn))
+    {
+        HTTP_Connection_Destroy(&conn);
+        return;
+    }
+
+    uring_deadline(context, conn, conn->ssl ? HTTP_TIMEOUT_HANDSHAKE : HTTP_TIMEOUT_FIRST_BYTE);
+    if (!uring_receive(context, conn))
+        uring_close(context, conn);
+}
+
+// --- Conclusão de um recv multishot ---
+static void uring_received(HTTP_Connection_Manager *context, HTTP_Connection *conn, struct io_uring_cqe *cqe)
+{
+    HTTP_Uring *uring = context->uring;
+    if (!(cqe->flags & IORING_CQE_F_MORE))
+        conn->receiving = false;
+
+    const char *data = NULL;
+    uint16_t bid = 0;
+    bool has_buffer = cqe->flags & IORING_CQE_F_BUFFER;
+    if (has_buffer)
+    {
+        bid = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        data = uring->buffer_memory + (size_t)bid * URING_BUFFER_SIZE;
+    }
+
+    // Conexão já encerrada: descarta dados que chegaram antes do cancelamento
+    if (conn->state == HTTP_STATE_CLOSED)
+    {
+        if (has_buffer)
+            uring_recycle(uring, bid);
+        if (!conn->receiving && !conn->sending)
+            HTTP_Manager_Remove_Connection(context, conn, -1, conn);
+        return;
+    }
+
+    if (cqe->res == -ENOBUFS)
+    {
+        // Todos os buffers estavam em uso; eles já foram devolvidos, então rearma
+        if (!conn->receiving && !uring_receive(context, conn))
+            uring_close(context, conn);
+        return;
+    }
+
+    if (cqe->res <= 0 || !has_buffer)
+    {
+        if (has_buffer)
+            uring_recycle(uring, bid);
+        uring_close(context, conn);
+        return;
+    }
+
+    bool stored;
+    if (conn->ssl)
+    {
+        stored = BIO_write(SSL_get_rbio(conn->ssl), data, cqe->res) == cqe->res;
+    }
+    else
+    {
+        stored = HTTP_Header_Reserve(conn, (size_t)cqe->res);
+        if (stored)
+        {
+            memcpy(conn->buffer + conn->buffer_used, data, (size_t)cqe->res);
+            conn->buffer_used += (size_t)cqe->res;
+        }
+    }
+    uring_recycle(uring, bid);
+
+    // Rearma antes de avançar: assim um encerramento durante o avanço passa pelo cancelamento
+    if (!stored || (!conn->receiving && !uring_receive(context, conn)) || !uring_advance(context, conn))
+        uring_close(context, conn);
+}
+
+// --- Conclusão do send do início da fila ---
+static void uring_sent(HTTP_Connection_Manager *context, HTTP_Connection *conn, struct io_uring_cqe *cqe)
+{
+    conn->sending--;
+    if (conn->state == HTTP_STATE_CLOSED)
+    {
+        if (!conn->receiving && !conn->sending)
+            HTTP_Manager_Remove_Connection(context, conn, -1, conn);
+        return;
+    }
+
+    if (cqe->res <= 0)
+    {
+        uring_close(context, conn);
+        return;
+    }
+
+    HTTP_Output_Advance(conn, (size_t)cqe->res);
+
+    // O restante da cadeia ainda está no anel: o próximo envio espera a última conclusão
+    if (conn->sending)
+    {
+        if (conn->state == HTTP_STATE_WRITE)
+            uring_deadline(context, conn, HTTP_TIMEOUT_WRITE); // Houve progresso
+        return;
+    }
+
+    // O que restou pode ser só um intervalo já lido por inteiro, descartado por uring_send
+    if (!uring_send(context, conn))
+    {
+        uring_close(context, conn);
+        return;
+    }
+    if (conn->queue)
+    {
+        if (conn->state == HTTP_STATE_WRITE)
+            uring_deadline(context, conn, HTTP_TIMEOUT_WRITE); // Houve progresso
+        return;
+    }
+
+    // Fila vazia ao fim de uma resposta: segue para a próxima requisição já recebida
+    if (conn->state != HTTP_STATE_WRITE)
+        return;
+    if (conn->closing)
+    {
+        uring_close(context, conn);
+        return;
+    }
+    conn->state = HTTP_STATE_READ_HEADER;
+    uring_deadline(context, conn, conn->buffer_used > 0 ? HTTP_TIMEOUT_HEADER : HTTP_TIMEOUT_IDLE);
+    if (!uring_advance(context, conn))
+        uring_close(context, conn);
+}
+
+// --- Processa as conclusões do anel de eventos ---
+// As guardadas por uring_wait vêm antes: chegaram antes das que ainda estão no anel
+static void uring_reap(HTTP_Connection_Manager *context)
+{
+    HTTP_Uring *uring = context->uring;
+    struct io_uring_cqe cqe;
+    for (;;)
+    {
+        if (uring->stash_head < uring->stash_count)
+        {
+            cqe = uring->stash[uring->stash_head++];
+        }
+        else
+        {
+            uring->stash_head = uring->stash_count = 0;
+            if (!ring_cqe(&uring->events, &cqe))
+                break;
+        }
+
+        if (cqe.user_data == URING_IGNORE)
+            continue;
+
+        if (cqe.user_data == URING_ACCEPT)
+        {
+            if (cqe.res >= 0)
+                uring_accepted(context, cqe.res);
+            else if (cqe.res != -EINTR && cqe.res != -ECONNABORTED && cqe.res != -EAGAIN)
+                HTTP_PRINT_ERROR(stderr, "accept: %s", strerror(-cqe.res));
+
+            if (!(cqe.flags & IORING_CQE_F_MORE) && context->run)
+                uring_accept(context);
+            continue;
+        }
+
+        if (cqe.user_data & URING_SEND)
+            uring_sent(context, (HTTP_Connection *)(uintptr_t)(cqe.user_data & ~(uint64_t)URING_SEND), &cqe);
+        else
+            uring_received(context, (HTTP_Connection *)(uintptr_t)cqe.user_data, &cqe);
+    }
+}
+
+// --- Encerra as conexões cujo prazo venceu ---
+static void uring_expire(HTTP_Connection_Manager *context)
+{
+    HTTP_Timer *timer = HTTP_Timer_Expire(&context->timers, HTTP_Now());
+
+    while (timer != NULL)
+    {
+        HTTP_Connection *conn = timer->owner;
+        timer = timer->next;
+        HTTP_Stats_Timeout(conn->timeout);
+        uring_close(context, conn);
+    }
+}
+
+// --- Laço de eventos: submete e aguarda em uma única chamada por iteração ---
+static void *uring_loop(void *arg)
+{
+    HTTP_Connection_Manager *context = arg;
+
+    uring_accept(context);
+    while (context->run)
+    {
+        int ret = ring_enter(&context->uring->events, 1, (uint64_t)URING_WAIT_MS * 1000000ull);
+        if (ret < 0 && errno != EINTR && errno != ETIME && errno != EBUSY)
+        {
+            HTTP_PRINT_ERROR(stderr, "io_uring_enter: %s", strerror(errno));
+            break;
+        }
+
+        uring_reap(context);
+        uring_expire(context);
+    }
+
+    return NULL;
+}
+
+// --- Cria os anéis, registra os buffers de recv e inicia a thread do laço ---
+bool HTTP_Uring_Start(HTTP_Connection_Manager *context)
+{
+    if (!context)
+        return false;
+
+    HTTP_Uring *uring = calloc(1, sizeof(HTTP_Uring));
+    if (!uring)
+    {
+        HTTP_PRINT_ERROR(stderr, "calloc");
+        return false;
+    }
+    uring->events.fd = -1;
+
+    if (!ring_init(&uring->events, URING_EVENT_ENTRIES))
+    {
+        uring_free(uring);
+        return false;
+    }
+    context->uring = uring;
+
+    if (!uring_buffers(uring) || !HTTP_Manager_Init(context))
+    {
+        context->uring = NULL;
+        uring_free(uring);
+        return false;
+    }
+
+    context->run = true;
+    if (pthread_create(&context->thread, NULL, uring_loop, context) != 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "pthread create");
+        HTTP_Manager_Destroy(context);
+        context->uring = NULL;
+        uring_free(uring);
+        return false;
+    }
+
+    if (context->cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(context->cpu, &cpus);
+        if (pthread_setaffinity_np(context->thread, sizeof(cpus), &cpus) != 0)
+            HTTP_PRINT_ERROR(stderr, "pthread_setaffinity_np (cpu %d)", context->cpu);
+    }
+
+    return true;
+}
+
+// --- Sinaliza parada, aguarda o laço e libera os anéis e as conexões ---
+void HTTP_Uring_Stop(HTTP_Connection_Manager *context)
+{
+    if (!context || !context->uring)
+        return;
+
+    context->run = false;
+    pthread_join(context->thread, NULL);
+
+    // Os anéis são fechados antes das conexões: nenhuma conclusão chega a objetos liberados
+    HTTP_Uring *uring = context->uring;
+    ring_close(&uring->events);
+    HTTP_Manager_Destroy(context);
+    context->uring = NULL;
+    uring_free(uring);
+}
+
+#else
+
+bool HTTP_Uring_Start(HTTP_Connection_Manager *context)
+{
+    (void)context;
+    HTTP_PRINT_ERROR(stderr, "io_uring backend not compiled (NERO_HTTP_IO_URING)");
+    return false;
+}
+
+void HTTP_Uring_Stop(HTTP_Connection_Manager *context)
+{
+    (void)context;
+}
+
+int HTTP_Uring_Write(HTTP_Connection *conn, const char *data, size_t length)
+{
+    (void)conn;
+    (void)data;
+    (void)length;
+    return -1;
+}
+
+bool HTTP_Uring_Flush(HTTP_Connection *conn)
+{
+    (void)conn;
+    return false;
+}
+
+int HTTP_Uring_Read(HTTP_Connection *conn, char *buffer, size_t length)
+{
+    (void)conn;
+    (void)buffer;
+    (void)length;
+    return -1;
+}
+
+#endif
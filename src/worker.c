@@ -0,0 +1,270 @@
+#include <nero_http.h>
+#include <nero_module.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __linux__
+#include <stdatomic.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <errno.h>
+
+#define WORKER_CACHE_LINE 64
+
+// --- Célula da fila: a sequência indica se está livre para escrita ou leitura ---
+typedef struct
+{
+    atomic_size_t sequence;
+    HTTP_Connection *conn;
+} HTTP_Queue_Cell;
+
+// --- Fila MPMC limitada (algoritmo de Vyukov), capacidade potência de 2 ---
+typedef struct
+{
+    HTTP_Queue_Cell *cells;
+    size_t mask;
+    _Alignas(WORKER_CACHE_LINE) atomic_size_t enqueue_pos;
+    _Alignas(WORKER_CACHE_LINE) atomic_size_t dequeue_pos;
+} HTTP_Queue;
+
+// --- Um worker: a thread e a instância própria dos módulos ---
+typedef struct
+{
+    struct HTTP_Worker_Pool *pool;
+    HTTP_Module_Set *modules;
+    pthread_t thread;
+} HTTP_Worker;
+
+struct HTTP_Worker_Pool
+{
+    HTTP_Queue queue;
+    sem_t ready; // Conta conexões enfileiradas; workers dormem aqui
+    HTTP_Worker *workers;
+    int count;
+    atomic_bool run;
+};
+
+static bool queue_init(HTTP_Queue *queue, size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity)
+        size <<= 1;
+
+    queue->cells = malloc(size * sizeof(HTTP_Queue_Cell));
+    if (!queue->cells)
+    {
+        HTTP_PRINT_ERROR(stderr, "malloc");
+        return false;
+    }
+
+    for (size_t i = 0; i < size; i++)
+        atomic_init(&queue->cells[i].sequence, i);
+
+    queue->mask = size - 1;
+    atomic_init(&queue->enqueue_pos, 0);
+    atomic_init(&queue->dequeue_pos, 0);
+    return true;
+}
+
+static bool queue_push(HTTP_Queue *queue, HTTP_Connection *conn)
+{
+    size_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    for (;;)
+    {
+        HTTP_Queue_Cell *cell = &queue->cells[pos & queue->mask];
+        size_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                cell->conn = conn;
+                atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false; // Fila cheia
+        }
+        else
+        {
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+static HTTP_Connection *queue_pop(HTTP_Queue *queue)
+{
+    size_t pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+    for (;;)
+    {
+        HTTP_Queue_Cell *cell = &queue->cells[pos & queue->mask];
+        size_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+        if (diff == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&queue->dequeue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                HTTP_Connection *conn = cell->conn;
+                atomic_store_explicit(&cell->sequence, pos + queue->mask + 1, memory_order_release);
+                return conn;
+            }
+        }
+        else if (diff < 0)
+        {
+            return NULL; // Fila vazia
+        }
+        else
+        {
+            pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+// --- Laço de um worker: retira conexões prontas e executa os módulos ---
+static void *worker_loop(void *arg)
+{
+    HTTP_Worker *worker = arg;
+    HTTP_Worker_Pool *pool = worker->pool;
+    HTTP_Modules_Bind(worker->modules);
+
+    for (;;)
+    {
+        if (sem_wait(&pool->ready) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            HTTP_PRINT_ERROR(stderr, "sem_wait");
+            break;
+        }
+
+        if (!atomic_load(&pool->run))
+            break;
+
+        // Cada sem_post corresponde a um item; se o início da fila ainda está
+        // sendo publicado por outro produtor, aguarda em vez de perder o sinal
+        HTTP_Connection *conn;
+        while (!(conn = queue_pop(&pool->queue)))
+            sched_yield();
+
+        HTTP_Reactor_Serve(conn);
+    }
+
+    return NULL;
+}
+
+// --- Cria o pool com threads pré-iniciadas ---
+// Cada worker recebe sua instância dos módulos (load), liberada no destroy do pool
+HTTP_Worker_Pool *HTTP_Worker_Pool_Create(int workers, size_t capacity, void **modules)
+{
+    if (workers < 1)
+        return NULL;
+
+    HTTP_Worker_Pool *pool = calloc(1, sizeof(HTTP_Worker_Pool));
+    if (!pool)
+    {
+        HTTP_PRINT_ERROR(stderr, "calloc");
+        return NULL;
+    }
+
+    pool->workers = calloc((size_t)workers, sizeof(HTTP_Worker));
+    if (!pool->workers || !queue_init(&pool->queue, capacity) || sem_init(&pool->ready, 0, 0) < 0)
+    {
+        HTTP_PRINT_ERROR(stderr, "worker pool init");
+        free(pool->queue.cells);
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+
+    atomic_init(&pool->run, true);
+    for (; pool->count < workers; pool->count++)
+    {
+        HTTP_Worker *worker = &pool->workers[pool->count];
+        worker->pool = pool;
+        worker->modules = HTTP_Modules_Load((const HTTP_Module **)modules);
+        if (!worker->modules)
+            break;
+
+        if (pthread_create(&worker->thread, NULL, worker_loop, worker) != 0)
+        {
+            HTTP_PRINT_ERROR(stderr, "pthread create");
+            HTTP_Modules_Unload(&worker->modules);
+            break;
+        }
+    }
+
+    if (pool->count == 0)
+    {
+        HTTP_Worker_Pool_Destroy(&pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+// --- Enfileira uma conexão com requisição completa; false se a fila estiver cheia ---
+bool HTTP_Worker_Pool_Submit(HTTP_Worker_Pool *pool, HTTP_Connection *conn)
+{
+    if (!pool || !atomic_load_explicit(&pool->run, memory_order_relaxed))
+        return false;
+
+    if (!queue_push(&pool->queue, conn))
+        return false;
+
+    sem_post(&pool->ready);
+    return true;
+}
+
+// --- Para os workers (após concluírem a requisição atual) e libera o pool ---
+void HTTP_Worker_Pool_Destroy(HTTP_Worker_Pool **pool)
+{
+    if (!pool || !(*pool))
+        return;
+
+    HTTP_Worker_Pool *p = *pool;
+    atomic_store(&p->run, false);
+    for (int i = 0; i < p->count; i++)
+        sem_post(&p->ready);
+    for (int i = 0; i < p->count; i++)
+    {
+        pthread_join(p->workers[i].thread, NULL);
+        HTTP_Modules_Unload(&p->workers[i].modules);
+    }
+
+    sem_destroy(&p->ready);
+    free(p->queue.cells);
+    free(p->workers);
+    free(p);
+    *pool = NULL;
+}
+
+#else
+
+HTTP_Worker_Pool *HTTP_Worker_Pool_Create(int workers, size_t capacity, void **modules)
+{
+    (void)workers;
+    (void)capacity;
+    (void)modules;
+    HTTP_PRINT_ERROR(stderr, "worker pool requires the reactor (Linux)");
+    return NULL;
+}
+
+bool HTTP_Worker_Pool_Submit(HTTP_Worker_Pool *pool, HTTP_Connection *conn)
+{
+    (void)pool;
+    (void)conn;
+    return false;
+}
+
+void HTTP_Worker_Pool_Destroy(HTTP_Worker_Pool **pool)
+{
+    (void)pool;
+}
+
+#endif
@@ -0,0 +1,286 @@
+// Teste do HPACK com os exemplos do Apêndice C da RFC 7541: requisições sem e com
+// Huffman (C.3, C.4), respostas com despejo da tabela dinâmica de 256 octetos (C.5, C.6)
+// e a codificação das respostas do servidor, conferida byte a byte e decodificada de volta.
+//
+// Compilado com -DNERO_HTTP_TESTS=ON (padrão) e executado pelo ctest: ./test_hpack
+#include <nero_http.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HPACK_BYTES(literal) literal, sizeof(literal) - 1
+
+// --- Campos decodificados, um "nome: valor\n" por linha ---
+typedef struct
+{
+    char text[1024];
+    size_t length;
+} Fields;
+
+static void fields_emit(void *context, const char *name, size_t name_length, const char *value, size_t value_length)
+{
+    Fields *fields = context;
+    int written = snprintf(fields->text + fields->length, sizeof(fields->text) - fields->length, "%.*s: %.*s\n",
+                           (int)name_length, name, (int)value_length, value);
+    if (written > 0)
+        fields->length += (size_t)written;
+}
+
+typedef struct
+{
+    const char *block;
+    size_t length;
+    const char *fields;
+    size_t table_size; // Tamanho da tabela dinâmica depois do bloco
+    size_t entries;
+} Hpack_Block;
+
+typedef struct
+{
+    const char *name;
+    size_t max_size; // Tamanho enviado numa atualização antes do primeiro bloco (0 = padrão)
+    Hpack_Block blocks[3];
+} Hpack_Sequence;
+
+static const char request_1[] =
+    ":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com\n";
+static const char request_2[] =
+    ":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com\ncache-control: no-cache\n";
+static const char request_3[] =
+    ":method: GET\n:scheme: https\n:path: /index.html\n:authority: www.example.com\ncustom-key: custom-value\n";
+
+static const char response_1[] =
+    ":status: 302\ncache-control: private\ndate: Mon, 21 Oct 2013 20:13:21 GMT\nlocation: https://www.example.com\n";
+static const char response_2[] =
+    ":status: 307\ncache-control: private\ndate: Mon, 21 Oct 2013 20:13:21 GMT\nlocation: https://www.example.com\n";
+static const char response_3[] =
+    ":status: 200\ncache-control: private\ndate: Mon, 21 Oct 2013 20:13:22 GMT\nlocation: https://www.example.com\n"
+    "content-encoding: gzip\nset-cookie: foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1\n";
+
+static const Hpack_Sequence sequences[] = {
+    {"C.3 requisições sem Huffman", 0,
+     {{HPACK_BYTES("\x82\x86\x84\x41\x0f\x77\x77\x77\x2e\x65\x78\x61\x6d\x70\x6c\x65"
+                   "\x2e\x63\x6f\x6d"),
+       request_1, 57, 1},
+      {HPACK_BYTES("\x82\x86\x84\xbe\x58\x08\x6e\x6f\x2d\x63\x61\x63\x68\x65"),
+       request_2, 110, 2},
+      {HPACK_BYTES("\x82\x87\x85\xbf\x40\x0a\x63\x75\x73\x74\x6f\x6d\x2d\x6b\x65\x79"
+                   "\x0c\x63\x75\x73\x74\x6f\x6d\x2d\x76\x61\x6c\x75\x65"),
+       request_3, 164, 3}}},
+
+    {"C.4 requisições com Huffman", 0,
+     {{HPACK_BYTES("\x82\x86\x84\x41\x8c\xf1\xe3\xc2\xe5\xf2\x3a\x6b\xa0\xab\x90\xf4"
+                   "\xff"),
+       request_1, 57, 1},
+      {HPACK_BYTES("\x82\x86\x84\xbe\x58\x86\xa8\xeb\x10\x64\x9c\xbf"),
+       request_2, 110, 2},
+      {HPACK_BYTES("\x82\x87\x85\xbf\x40\x88\x25\xa8\x49\xe9\x5b\xa9\x7d\x7f\x89\x25"
+                   "\xa8\x49\xe9\x5b\xb8\xe8\xb4\xbf"),
+       request_3, 164, 3}}},
+
+    {"C.5 respostas sem Huffman", 256,
+     {{HPACK_BYTES("\x48\x03\x33\x30\x32\x58\x07\x70\x72\x69\x76\x61\x74\x65\x61\x1d"
+                   "\x4d\x6f\x6e\x2c\x20\x32\x31\x20\x4f\x63\x74\x20\x32\x30\x31\x33"
+                   "\x20\x32\x30\x3a\x31\x33\x3a\x32\x31\x20\x47\x4d\x54\x6e\x17\x68"
+                   "\x74\x74\x70\x73\x3a\x2f\x2f\x77\x77\x77\x2e\x65\x78\x61\x6d\x70"
+                   "\x6c\x65\x2e\x63\x6f\x6d"),
+       response_1, 222, 4},
+      {HPACK_BYTES("\x48\x03\x33\x30\x37\xc1\xc0\xbf"),
+       response_2, 222, 4},
+      {HPACK_BYTES("\x88\xc1\x61\x1d\x4d\x6f\x6e\x2c\x20\x32\x31\x20\x4f\x63\x74\x20"
+                   "\x32\x30\x31\x33\x20\x32\x30\x3a\x31\x33\x3a\x32\x32\x20\x47\x4d"
+                   "\x54\xc0\x5a\x04\x67\x7a\x69\x70\x77\x38\x66\x6f\x6f\x3d\x41\x53"
+                   "\x44\x4a\x4b\x48\x51\x4b\x42\x5a\x58\x4f\x51\x57\x45\x4f\x50\x49"
+                   "\x55\x41\x58\x51\x57\x45\x4f\x49\x55\x3b\x20\x6d\x61\x78\x2d\x61"
+                   "\x67\x65\x3d\x33\x36\x30\x30\x3b\x20\x76\x65\x72\x73\x69\x6f\x6e"
+                   "\x3d\x31"),
+       response_3, 215, 3}}},
+
+    {"C.6 respostas com Huffman", 256,
+     {{HPACK_BYTES("\x48\x82\x64\x02\x58\x85\xae\xc3\x77\x1a\x4b\x61\x96\xd0\x7a\xbe"
+                   "\x94\x10\x54\xd4\x44\xa8\x20\x05\x95\x04\x0b\x81\x66\xe0\x82\xa6"
+                   "\x2d\x1b\xff\x6e\x91\x9d\x29\xad\x17\x18\x63\xc7\x8f\x0b\x97\xc8"
+                   "\xe9\xae\x82\xae\x43\xd3"),
+       response_1, 222, 4},
+      {HPACK_BYTES("\x48\x83\x64\x0e\xff\xc1\xc0\xbf"),
+       response_2, 222, 4},
+      {HPACK_BYTES("\x88\xc1\x61\x96\xd0\x7a\xbe\x94\x10\x54\xd4\x44\xa8\x20\x05\x95"
+                   "\x04\x0b\x81\x66\xe0\x84\xa6\x2d\x1b\xff\xc0\x5a\x83\x9b\xd9\xab"
+                   "\x77\xad\x94\xe7\x82\x1d\xd7\xf2\xe6\xc7\xb3\x35\xdf\xdf\xcd\x5b"
+                   "\x39\x60\xd5\xaf\x27\x08\x7f\x36\x72\xc1\xab\x27\x0f\xb5\x29\x1f"
+                   "\x95\x87\x31\x60\x65\xc0\x03\xed\x4e\xe5\xb1\x06\x3d\x50\x07"),
+       response_3, 215, 3}}},
+};
+
+#define SEQUENCE_COUNT (sizeof(sequences) / sizeof(sequences[0]))
+
+// --- Blocos que o decodificador precisa recusar ---
+typedef struct
+{
+    const char *name;
+    const char *block;
+    size_t length;
+} Hpack_Invalid;
+
+static const Hpack_Invalid invalid[] = {
+    {"índice 0", HPACK_BYTES("\x80")},
+    {"índice fora da tabela", HPACK_BYTES("\xbe")},
+    {"inteiro truncado", HPACK_BYTES("\xff")},
+    {"literal truncado", HPACK_BYTES("\x40\x0a\x63\x75\x73\x74")},
+    {"atualização depois de um campo", HPACK_BYTES("\x82\x3f\xe1\x01")},
+    {"atualização acima do limite", HPACK_BYTES("\x3f\xe2\x1f")},
+    {"preenchimento Huffman maior que 7 bits", HPACK_BYTES("\x40\x82\xff\xff\x00")},
+};
+
+#define INVALID_COUNT (sizeof(invalid) / sizeof(invalid[0]))
+
+// --- Campos da resposta: índice estático, nome indexado e literal (minúsculas, Huffman ou cru) ---
+typedef struct
+{
+    const char *name;
+    const char *value;
+    const char *encoded;
+    size_t encoded_length;
+    const char *decoded;
+} Hpack_Encoded;
+
+static const Hpack_Encoded encoded[] = {
+    {":status", "200", HPACK_BYTES("\x88"), ":status: 200\n"},
+    {":status", "302", HPACK_BYTES("\x08\x82\x64\x02"), ":status: 302\n"},
+    {"Cache-Control", "private", HPACK_BYTES("\x0f\x09\x85\xae\xc3\x77\x1a\x4b"), "cache-control: private\n"},
+    {"date", "Mon, 21 Oct 2013 20:13:21 GMT",
+     HPACK_BYTES("\x0f\x12\x96\xd0\x7a\xbe\x94\x10\x54\xd4\x44\xa8\x20\x05\x95\x04"
+                 "\x0b\x81\x66\xe0\x82\xa6\x2d\x1b\xff"),
+     "date: Mon, 21 Oct 2013 20:13:21 GMT\n"},
+    {"location", "https://www.example.com",
+     HPACK_BYTES("\x0f\x1f\x91\x9d\x29\xad\x17\x18\x63\xc7\x8f\x0b\x97\xc8\xe9\xae"
+                 "\x82\xae\x43\xd3"),
+     "location: https://www.example.com\n"},
+    {"Custom-Key", "custom-value",
+     HPACK_BYTES("\x00\x88\x25\xa8\x49\xe9\x5b\xa9\x7d\x7f\x89\x25\xa8\x49\xe9\x5b"
+                 "\xb8\xe8\xb4\xbf"),
+     "custom-key: custom-value\n"},
+    {"x-id", "{}", HPACK_BYTES("\x00\x83\xf2\xb1\xa4\x02\x7b\x7d"), "x-id: {}\n"},
+};
+
+#define ENCODED_COUNT (sizeof(encoded) / sizeof(encoded[0]))
+
+static void print_bytes(const char *label, const uint8_t *data, size_t length)
+{
+    printf("    %s:", label);
+    for (size_t i = 0; i < length; i++)
+        printf(" %02x", data[i]);
+    printf("\n");
+}
+
+static bool test_sequence(const Hpack_Sequence *sequence)
+{
+    HTTP_Hpack_Decoder decoder;
+    HTTP_Hpack_Init(&decoder);
+    bool ok = true;
+
+    // Atualização do tamanho da tabela num bloco próprio, como o codificador do exemplo faria
+    if (sequence->max_size)
+    {
+        uint8_t update[8];
+        size_t length = 0;
+        update[length++] = 0x3f;
+        for (size_t rest = sequence->max_size - 31; ; rest >>= 7)
+        {
+            update[length++] = (uint8_t)(rest >= 0x80 ? (rest & 0x7f) | 0x80 : rest);
+            if (rest < 0x80)
+                break;
+        }
+        Fields none = {0};
+        ok = HTTP_Hpack_Decode(&decoder, update, length, fields_emit, &none) && none.length == 0 &&
+             decoder.max_size == sequence->max_size;
+        if (!ok)
+            printf("%s: atualização do tamanho da tabela recusada\n", sequence->name);
+    }
+
+    for (size_t i = 0; ok && i < 3; i++)
+    {
+        const Hpack_Block *block = &sequence->blocks[i];
+        Fields fields = {0};
+        if (!HTTP_Hpack_Decode(&decoder, (const uint8_t *)block->block, block->length, fields_emit, &fields))
+        {
+            printf("%s.%zu: bloco recusado\n", sequence->name, i + 1);
+            ok = false;
+        }
+        else if (strcmp(fields.text, block->fields) != 0)
+        {
+            printf("%s.%zu: campos divergentes\n--- esperado\n%s--- obtido\n%s", sequence->name, i + 1,
+                   block->fields, fields.text);
+            ok = false;
+        }
+        else if (decoder.size != block->table_size || decoder.count != block->entries)
+        {
+            printf("%s.%zu: tabela com %zu octetos em %zu entradas, esperado %zu em %zu\n", sequence->name, i + 1,
+                   decoder.size, decoder.count, block->table_size, block->entries);
+            ok = false;
+        }
+    }
+
+    HTTP_Hpack_Destroy(&decoder);
+    printf("%s: %s\n", sequence->name, ok ? "ok" : "FALHOU");
+    return ok;
+}
+
+static bool test_invalid(const Hpack_Invalid *test)
+{
+    HTTP_Hpack_Decoder decoder;
+    HTTP_Hpack_Init(&decoder);
+    Fields fields = {0};
+    bool ok = !HTTP_Hpack_Decode(&decoder, (const uint8_t *)test->block, test->length, fields_emit, &fields);
+    HTTP_Hpack_Destroy(&decoder);
+    printf("recusa %s: %s\n", test->name, ok ? "ok" : "FALHOU");
+    return ok;
+}
+
+static bool test_encode(const Hpack_Encoded *test)
+{
+    size_t name_length = strlen(test->name);
+    size_t value_length = strlen(test->value);
+    uint8_t *out = malloc(HTTP_HPACK_ENCODED_MAX(name_length, value_length));
+    if (!out)
+        return false;
+
+    size_t length = HTTP_Hpack_Encode(out, test->name, name_length, test->value, value_length);
+    bool ok = length <= HTTP_HPACK_ENCODED_MAX(name_length, value_length) && length == test->encoded_length &&
+              memcmp(out, test->encoded, length) == 0;
+    if (!ok)
+    {
+        print_bytes("esperado", (const uint8_t *)test->encoded, test->encoded_length);
+        print_bytes("obtido", out, length);
+    }
+
+    // O que o servidor envia precisa voltar igual por um decodificador sem estado
+    HTTP_Hpack_Decoder decoder;
+    HTTP_Hpack_Init(&decoder);
+    Fields fields = {0};
+    if (!HTTP_Hpack_Decode(&decoder, out, length, fields_emit, &fields) || strcmp(fields.text, test->decoded) != 0 ||
+        decoder.count != 0)
+    {
+        printf("    decodificado: %s", fields.text);
+        ok = false;
+    }
+    HTTP_Hpack_Destroy(&decoder);
+    free(out);
+
+    printf("codifica %s: %s\n", test->name, ok ? "ok" : "FALHOU");
+    return ok;
+}
+
+int main(void)
+{
+    size_t failed = 0;
+    for (size_t i = 0; i < SEQUENCE_COUNT; i++)
+        failed += !test_sequence(&sequences[i]);
+    for (size_t i = 0; i < INVALID_COUNT; i++)
+        failed += !test_invalid(&invalid[i]);
+    for (size_t i = 0; i < ENCODED_COUNT; i++)
+        failed += !test_encode(&encoded[i]);
+
+    if (failed)
+        printf("%zu casos falharam\n", failed);
+    return failed != 0;
+}